@@ -0,0 +1,575 @@
+#include "adaptive_replacement.h"
+
+// ==========================================
+//      PAGE DIRECTORY (RESIDENT + GHOSTS)
+// ==========================================
+
+/**
+ * One node per page the policy remembers, resident or not, in a fixed
+ * pool. The lists of each policy are threaded through prev/next; `tag`
+ * says which list (or, for CLOCK-Pro, which kind of page) a node is on.
+ */
+typedef struct
+{
+    int head, tail, size;
+} NodeList;
+
+typedef struct
+{
+    int frames, usedFrames;
+    long long *framePage; // page in each frame, -1 while empty
+    int *spareFrames;
+    int spareFrameCount;
+
+    int nodes;
+    long long *page;
+    int *prev, *next;
+    int *frame; // -1 for a ghost
+    unsigned char *tag;
+    unsigned char *ref; // reference bit, for the clock
+    int *spareNodes;
+    int spareNodeCount;
+    PageMap index; // page -> node
+} PageDirectory;
+
+static void initDirectory(PageDirectory *d, int frames, int ghosts)
+{
+    d->frames = frames;
+    d->usedFrames = 0;
+    d->framePage = safeMalloc((size_t)frames * sizeof(long long));
+    d->spareFrames = safeMalloc((size_t)frames * sizeof(int));
+    d->spareFrameCount = 0;
+
+    d->nodes = frames + ghosts;
+    d->page = safeMalloc((size_t)d->nodes * sizeof(long long));
+    d->prev = safeMalloc((size_t)d->nodes * sizeof(int));
+    d->next = safeMalloc((size_t)d->nodes * sizeof(int));
+    d->frame = safeMalloc((size_t)d->nodes * sizeof(int));
+    d->tag = safeMalloc((size_t)d->nodes);
+    d->ref = safeMalloc((size_t)d->nodes);
+    d->spareNodes = safeMalloc((size_t)d->nodes * sizeof(int));
+    d->spareNodeCount = d->nodes;
+    for (int i = 0; i < d->nodes; i++)
+        d->spareNodes[i] = d->nodes - 1 - i;
+    initPageMap(&d->index, d->nodes);
+}
+
+static void freeDirectory(PageDirectory *d)
+{
+    free(d->framePage);
+    free(d->spareFrames);
+    free(d->page);
+    free(d->prev);
+    free(d->next);
+    free(d->frame);
+    free(d->tag);
+    free(d->ref);
+    free(d->spareNodes);
+    freePageMap(&d->index);
+}
+
+static size_t directoryBytes(const PageDirectory *d)
+{
+    size_t perNode = sizeof(long long) + 4 * sizeof(int) + 2; // page, prev, next, frame, spare slot, tag, ref
+    return (size_t)(d->index.mask + 1) * (sizeof(long long) + sizeof(int)) + (size_t)d->nodes * perNode +
+           (size_t)d->frames * (sizeof(long long) + sizeof(int));
+}
+
+static bool directoryFull(const PageDirectory *d)
+{
+    return d->usedFrames == d->frames && d->spareFrameCount == 0;
+}
+
+static int addNode(PageDirectory *d, long long page)
+{
+    int x = d->spareNodes[--d->spareNodeCount];
+    d->page[x] = page;
+    d->frame[x] = -1;
+    d->ref[x] = 0;
+    pageMapPut(&d->index, page, x);
+    return x;
+}
+
+static void dropNode(PageDirectory *d, int x)
+{
+    pageMapErase(&d->index, d->page[x]);
+    d->spareNodes[d->spareNodeCount++] = x;
+}
+
+// Gives a node a free frame; the caller has made sure there is one
+static void attachFrame(PageDirectory *d, int x)
+{
+    int f = (d->spareFrameCount > 0) ? d->spareFrames[--d->spareFrameCount] : d->usedFrames++;
+    d->framePage[f] = d->page[x];
+    d->frame[x] = f;
+}
+
+// Evicts a resident node: it keeps its place in the directory as a ghost until dropped
+static void detachFrame(PageDirectory *d, int x, long long *evicted)
+{
+    int f = d->frame[x];
+    *evicted = d->page[x];
+    d->framePage[f] = -1;
+    d->spareFrames[d->spareFrameCount++] = f;
+    d->frame[x] = -1;
+}
+
+static void listUnlink(PageDirectory *d, NodeList *l, int x)
+{
+    if (d->prev[x] != -1)
+        d->next[d->prev[x]] = d->next[x];
+    else
+        l->head = d->next[x];
+    if (d->next[x] != -1)
+        d->prev[d->next[x]] = d->prev[x];
+    else
+        l->tail = d->prev[x];
+    l->size--;
+}
+
+static void listPushFront(PageDirectory *d, NodeList *l, int x, unsigned char tag)
+{
+    d->prev[x] = -1;
+    d->next[x] = l->head;
+    if (l->head != -1)
+        d->prev[l->head] = x;
+    l->head = x;
+    if (l->tail == -1)
+        l->tail = x;
+    l->size++;
+    d->tag[x] = tag;
+}
+
+static void initList(NodeList *l)
+{
+    l->head = l->tail = -1;
+    l->size = 0;
+}
+
+static long long directoryFramePage(const PageDirectory *d, int frame)
+{
+    return (frame < d->usedFrames) ? d->framePage[frame] : -1;
+}
+
+// ==========================================
+//      ARC
+// ==========================================
+
+enum
+{
+    ARC_T1, // resident, seen once recently
+    ARC_T2, // resident, seen at least twice
+    ARC_B1, // ghosts evicted from T1
+    ARC_B2  // ghosts evicted from T2
+};
+
+typedef struct
+{
+    PageDirectory d;
+    NodeList list[4]; // indexed by the tags above
+    int target;       // adaptive goal for |T1|
+} ArcState;
+
+// Frees a frame, from T1 or T2 depending on the target; the victim becomes a ghost
+static void arcReplace(ArcState *s, bool ghostOfT2, long long *evicted)
+{
+    NodeList *t1 = &s->list[ARC_T1], *t2 = &s->list[ARC_T2];
+    bool fromT1 = t1->size > 0 && ((ghostOfT2 && t1->size == s->target) || t1->size > s->target || t2->size == 0);
+    NodeList *from = fromT1 ? t1 : t2;
+    int y = from->tail;
+    listUnlink(&s->d, from, y);
+    detachFrame(&s->d, y, evicted);
+    listPushFront(&s->d, &s->list[fromT1 ? ARC_B1 : ARC_B2], y, fromT1 ? ARC_B1 : ARC_B2);
+}
+
+static void arcDropOldest(ArcState *s, int which)
+{
+    int y = s->list[which].tail;
+    listUnlink(&s->d, &s->list[which], y);
+    dropNode(&s->d, y);
+}
+
+static bool arcAccess(void *self, long long page, long long *evicted)
+{
+    ArcState *s = self;
+    PageDirectory *d = &s->d;
+    NodeList *l = s->list;
+    int c = d->frames;
+    *evicted = -1;
+
+    int x = pageMapGet(&d->index, page);
+    if (x != -1 && (d->tag[x] == ARC_T1 || d->tag[x] == ARC_T2))
+    {
+        listUnlink(d, &l[d->tag[x]], x);
+        listPushFront(d, &l[ARC_T2], x, ARC_T2);
+        return true;
+    }
+    if (x != -1)
+    {
+        // Ghost hit: grow the side that would have kept it
+        bool inB1 = (d->tag[x] == ARC_B1);
+        int mine = l[inB1 ? ARC_B1 : ARC_B2].size, other = l[inB1 ? ARC_B2 : ARC_B1].size;
+        int delta = (other > mine) ? other / mine : 1;
+        s->target = inB1 ? (s->target + delta < c ? s->target + delta : c) : (s->target > delta ? s->target - delta : 0);
+        listUnlink(d, &l[d->tag[x]], x);
+        arcReplace(s, !inB1, evicted);
+        listPushFront(d, &l[ARC_T2], x, ARC_T2);
+        attachFrame(d, x);
+        return false;
+    }
+
+    int total = l[ARC_T1].size + l[ARC_T2].size + l[ARC_B1].size + l[ARC_B2].size;
+    if (l[ARC_T1].size + l[ARC_B1].size == c)
+    {
+        if (l[ARC_T1].size < c)
+        {
+            arcDropOldest(s, ARC_B1);
+            arcReplace(s, false, evicted);
+        }
+        else
+        {
+            // T1 fills the cache: its oldest page leaves without a ghost
+            int y = l[ARC_T1].tail;
+            listUnlink(d, &l[ARC_T1], y);
+            detachFrame(d, y, evicted);
+            dropNode(d, y);
+        }
+    }
+    else if (total >= c)
+    {
+        if (total == 2 * c)
+            arcDropOldest(s, ARC_B2);
+        arcReplace(s, false, evicted);
+    }
+    x = addNode(d, page);
+    listPushFront(d, &l[ARC_T1], x, ARC_T1);
+    attachFrame(d, x);
+    return false;
+}
+
+static long long arcFramePage(const void *self, int frame)
+{
+    return directoryFramePage(&((const ArcState *)self)->d, frame);
+}
+
+static size_t arcMetadata(const void *self)
+{
+    return directoryBytes(&((const ArcState *)self)->d) + sizeof(ArcState);
+}
+
+static void arcDestroy(void *self)
+{
+    freeDirectory(&((ArcState *)self)->d);
+    free(self);
+}
+
+const PageReplacerOps arcOps = {"ARC", arcAccess, arcFramePage, arcMetadata, arcDestroy};
+
+void *newArcState(int frames)
+{
+    ArcState *s = safeMalloc(sizeof(ArcState));
+    initDirectory(&s->d, frames, frames);
+    for (int i = 0; i < 4; i++)
+        initList(&s->list[i]);
+    s->target = 0;
+    return s;
+}
+
+// ==========================================
+//      2Q
+// ==========================================
+
+enum
+{
+    TWOQ_IN,  // resident, FIFO of pages seen once
+    TWOQ_OUT, // ghosts pushed out of A1in
+    TWOQ_MAIN // resident, LRU of pages seen again
+};
+
+typedef struct
+{
+    PageDirectory d;
+    NodeList list[3];
+    int kin, kout; // A1in target and A1out limit
+} TwoQueueState;
+
+static void twoQueueReclaim(TwoQueueState *s, long long *evicted)
+{
+    PageDirectory *d = &s->d;
+    NodeList *in = &s->list[TWOQ_IN], *out = &s->list[TWOQ_OUT], *main = &s->list[TWOQ_MAIN];
+    if (!directoryFull(d))
+        return;
+    if (in->size > s->kin || main->size == 0)
+    {
+        int y = in->tail;
+        listUnlink(d, in, y);
+        detachFrame(d, y, evicted);
+        listPushFront(d, out, y, TWOQ_OUT);
+        if (out->size > s->kout)
+        {
+            int z = out->tail;
+            listUnlink(d, out, z);
+            dropNode(d, z);
+        }
+    }
+    else
+    {
+        int y = main->tail;
+        listUnlink(d, main, y);
+        detachFrame(d, y, evicted);
+        dropNode(d, y);
+    }
+}
+
+static bool twoQueueAccess(void *self, long long page, long long *evicted)
+{
+    TwoQueueState *s = self;
+    PageDirectory *d = &s->d;
+    *evicted = -1;
+
+    int x = pageMapGet(&d->index, page);
+    if (x != -1 && d->tag[x] == TWOQ_MAIN)
+    {
+        listUnlink(d, &s->list[TWOQ_MAIN], x);
+        listPushFront(d, &s->list[TWOQ_MAIN], x, TWOQ_MAIN);
+        return true;
+    }
+    if (x != -1 && d->tag[x] == TWOQ_IN)
+        return true; // correlated references inside A1in do not count as reuse
+    if (x != -1)
+    {
+        listUnlink(d, &s->list[TWOQ_OUT], x);
+        twoQueueReclaim(s, evicted);
+        listPushFront(d, &s->list[TWOQ_MAIN], x, TWOQ_MAIN);
+        attachFrame(d, x);
+        return false;
+    }
+    twoQueueReclaim(s, evicted);
+    x = addNode(d, page);
+    listPushFront(d, &s->list[TWOQ_IN], x, TWOQ_IN);
+    attachFrame(d, x);
+    return false;
+}
+
+static long long twoQueueFramePage(const void *self, int frame)
+{
+    return directoryFramePage(&((const TwoQueueState *)self)->d, frame);
+}
+
+static size_t twoQueueMetadata(const void *self)
+{
+    return directoryBytes(&((const TwoQueueState *)self)->d) + sizeof(TwoQueueState);
+}
+
+static void twoQueueDestroy(void *self)
+{
+    freeDirectory(&((TwoQueueState *)self)->d);
+    free(self);
+}
+
+const PageReplacerOps twoQueueOps = {"2Q", twoQueueAccess, twoQueueFramePage, twoQueueMetadata, twoQueueDestroy};
+
+void *newTwoQueueState(int frames)
+{
+    TwoQueueState *s = safeMalloc(sizeof(TwoQueueState));
+    // The tuning the 2Q paper recommends: A1in a quarter of memory, A1out half
+    s->kin = (frames / 4 > 0) ? frames / 4 : 1;
+    s->kout = (frames / 2 > 0) ? frames / 2 : 1;
+    initDirectory(&s->d, frames, s->kout + 1);
+    for (int i = 0; i < 3; i++)
+        initList(&s->list[i]);
+    return s;
+}
+
+// ==========================================
+//      CLOCK-PRO
+// ==========================================
+
+enum
+{
+    CP_HOT,
+    CP_COLD, // resident cold pages are always in their test period
+    CP_TEST  // non-resident cold page still in its test period
+};
+
+typedef struct
+{
+    PageDirectory d;
+    int handHot, handCold, handTest; // -1 while the clock is empty
+    int hot, cold, test;
+    int coldTarget; // adaptive share of the frames for cold pages
+} ClockProState;
+
+// New pages go just behind the hot hand, the last place any hand reaches
+static void ringInsert(ClockProState *s, int x)
+{
+    PageDirectory *d = &s->d;
+    if (s->handHot == -1)
+    {
+        d->prev[x] = d->next[x] = x;
+        s->handHot = s->handCold = s->handTest = x;
+        return;
+    }
+    int h = s->handHot, p = d->prev[h];
+    d->next[p] = x;
+    d->prev[x] = p;
+    d->next[x] = h;
+    d->prev[h] = x;
+}
+
+static void ringRemove(ClockProState *s, int x)
+{
+    PageDirectory *d = &s->d;
+    int after = (d->next[x] == x) ? -1 : d->next[x];
+    if (s->handHot == x)
+        s->handHot = after;
+    if (s->handCold == x)
+        s->handCold = after;
+    if (s->handTest == x)
+        s->handTest = after;
+    d->next[d->prev[x]] = d->next[x];
+    d->prev[d->next[x]] = d->prev[x];
+}
+
+// Ends the test period of a non-resident page: it leaves the clock, and
+// the cold share shrinks because the page was not wanted back in time
+static void endTest(ClockProState *s, int x)
+{
+    ringRemove(s, x);
+    dropNode(&s->d, x);
+    s->test--;
+    if (s->coldTarget > 1)
+        s->coldTarget--;
+}
+
+static void runHandTest(ClockProState *s)
+{
+    int x = s->handTest;
+    s->handTest = s->d.next[x];
+    if (s->d.tag[x] == CP_TEST)
+        endTest(s, x);
+}
+
+static void runHandHot(ClockProState *s)
+{
+    PageDirectory *d = &s->d;
+    int x = s->handHot;
+    s->handHot = d->next[x];
+    if (d->tag[x] == CP_HOT)
+    {
+        if (d->ref[x])
+            d->ref[x] = 0;
+        else
+        {
+            d->tag[x] = CP_COLD;
+            s->hot--;
+            s->cold++;
+        }
+    }
+    else if (d->tag[x] == CP_TEST)
+        endTest(s, x); // the hot hand does the test hand's work as it passes
+}
+
+static void balanceHot(ClockProState *s)
+{
+    while (s->hot > s->d.frames - s->coldTarget)
+        runHandHot(s);
+}
+
+// Runs the cold hand until a resident cold page without its reference bit is evicted
+static void evictCold(ClockProState *s, long long *evicted)
+{
+    PageDirectory *d = &s->d;
+    while (1)
+    {
+        int x = s->handCold;
+        s->handCold = d->next[x];
+        if (d->tag[x] != CP_COLD)
+            continue;
+        if (d->ref[x])
+        {
+            // Referenced during its test period: promote
+            d->ref[x] = 0;
+            d->tag[x] = CP_HOT;
+            s->cold--;
+            s->hot++;
+            balanceHot(s);
+            continue;
+        }
+        detachFrame(d, x, evicted);
+        d->tag[x] = CP_TEST;
+        s->cold--;
+        s->test++;
+        while (s->test > d->frames)
+            runHandTest(s);
+        return;
+    }
+}
+
+static bool clockProAccess(void *self, long long page, long long *evicted)
+{
+    ClockProState *s = self;
+    PageDirectory *d = &s->d;
+    *evicted = -1;
+
+    int x = pageMapGet(&d->index, page);
+    if (x != -1 && d->tag[x] != CP_TEST)
+    {
+        d->ref[x] = 1;
+        return true;
+    }
+    if (x != -1)
+    {
+        // Re-referenced within its test period: cold pages deserve more room
+        if (s->coldTarget < d->frames)
+            s->coldTarget++;
+        ringRemove(s, x);
+        s->test--;
+        d->tag[x] = CP_HOT;
+        if (directoryFull(d))
+            evictCold(s, evicted);
+        ringInsert(s, x);
+        d->ref[x] = 0;
+        s->hot++;
+        attachFrame(d, x);
+        balanceHot(s);
+        return false;
+    }
+    if (directoryFull(d))
+        evictCold(s, evicted);
+    x = addNode(d, page);
+    ringInsert(s, x);
+    d->tag[x] = CP_COLD;
+    s->cold++;
+    attachFrame(d, x);
+    return false;
+}
+
+static long long clockProFramePage(const void *self, int frame)
+{
+    return directoryFramePage(&((const ClockProState *)self)->d, frame);
+}
+
+static size_t clockProMetadata(const void *self)
+{
+    return directoryBytes(&((const ClockProState *)self)->d) + sizeof(ClockProState);
+}
+
+static void clockProDestroy(void *self)
+{
+    freeDirectory(&((ClockProState *)self)->d);
+    free(self);
+}
+
+const PageReplacerOps clockProOps = {"CLOCK-Pro", clockProAccess, clockProFramePage, clockProMetadata,
+                                     clockProDestroy};
+
+void *newClockProState(int frames)
+{
+    ClockProState *s = safeMalloc(sizeof(ClockProState));
+    initDirectory(&s->d, frames, frames);
+    s->handHot = s->handCold = s->handTest = -1;
+    s->hot = s->cold = s->test = 0;
+    s->coldTarget = frames;
+    return s;
+}
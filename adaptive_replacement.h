@@ -0,0 +1,29 @@
+#ifndef ADAPTIVE_REPLACEMENT_H
+#define ADAPTIVE_REPLACEMENT_H
+
+#include "page_replacement.h"
+
+// --- Policies ---
+/**
+ * Scan-resistant policies that also remember recently evicted pages
+ * ("ghosts": page numbers only, no frame). A ghost hit shows the policy
+ * evicted the wrong kind of page, and it adapts:
+ *   ARC       - recency (T1) vs frequency (T2) lists; ghost hits move the
+ *               target size of T1 (Megiddo & Modha);
+ *   2Q        - new pages wait in a FIFO (A1in); only pages referenced
+ *               again after leaving it (seen in the A1out ghosts) reach
+ *               the LRU main queue (Johnson & Shasha);
+ *   CLOCK-Pro - one clock of hot, cold and non-resident test pages with
+ *               three hands; test hits grow the cold target (Jiang et al.).
+ * Each keeps at most as many ghosts as frames. Reached through
+ * createPageReplacer like the other policies.
+ */
+extern const PageReplacerOps arcOps;
+extern const PageReplacerOps twoQueueOps;
+extern const PageReplacerOps clockProOps;
+
+void *newArcState(int frames);
+void *newTwoQueueState(int frames);
+void *newClockProState(int frames);
+
+#endif
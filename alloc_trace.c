@@ -0,0 +1,634 @@
+#include "alloc_trace.h"
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+// ==========================================
+//      ON-DISK FORMAT
+// ==========================================
+
+#define TRACE_MAGIC "OSAT"
+#define TRACE_VERSION 1u
+
+// Binary layout: header followed by packed records (count 0 = not recorded)
+typedef struct
+{
+    char magic[4];
+    uint32_t version;
+    uint64_t count;
+} TraceHeader;
+
+typedef struct
+{
+    uint64_t id;
+    uint32_t size;
+    uint8_t op; // HeapOp
+    uint8_t reserved[3];
+} TraceRecord;
+
+// ==========================================
+//      ID MAP
+// ==========================================
+
+static uint64_t hashId(uint64_t key)
+{
+    key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    key = (key ^ (key >> 27)) * 0x94D049BB133111EBULL;
+    return key ^ (key >> 31);
+}
+
+static void allocBuckets(IdMap *m, long long buckets)
+{
+    m->keys = safeMalloc((size_t)buckets * sizeof(uint64_t));
+    m->slots = safeMalloc((size_t)buckets * sizeof(int));
+    for (long long i = 0; i < buckets; i++)
+        m->slots[i] = -1;
+    m->mask = buckets - 1;
+}
+
+void initIdMap(IdMap *m)
+{
+    allocBuckets(m, 1024);
+    m->used = 0;
+    m->spare = NULL;
+    m->spareCount = m->spareCapacity = 0;
+    m->nextSlot = 0;
+}
+
+void freeIdMap(IdMap *m)
+{
+    free(m->keys);
+    free(m->slots);
+    free(m->spare);
+    m->keys = NULL;
+    m->slots = m->spare = NULL;
+}
+
+static long long findBucket(const IdMap *m, uint64_t key)
+{
+    long long b = (long long)(hashId(key) & (uint64_t)m->mask);
+    while (m->slots[b] != -1 && m->keys[b] != key)
+        b = (b + 1) & m->mask;
+    return b;
+}
+
+static void growIdMap(IdMap *m)
+{
+    uint64_t *keys = m->keys;
+    int *slots = m->slots;
+    long long buckets = m->mask + 1;
+    allocBuckets(m, 2 * buckets);
+    for (long long i = 0; i < buckets; i++)
+        if (slots[i] != -1)
+        {
+            long long b = findBucket(m, keys[i]);
+            m->keys[b] = keys[i];
+            m->slots[b] = slots[i];
+        }
+    free(keys);
+    free(slots);
+}
+
+int idMapAcquire(IdMap *m, uint64_t key)
+{
+    long long b = findBucket(m, key);
+    if (m->slots[b] != -1)
+        return m->slots[b];
+    if (2 * (m->used + 1) > m->mask + 1)
+    {
+        growIdMap(m);
+        b = findBucket(m, key);
+    }
+    int slot = (m->spareCount > 0) ? m->spare[--m->spareCount] : m->nextSlot++;
+    m->keys[b] = key;
+    m->slots[b] = slot;
+    m->used++;
+    return slot;
+}
+
+int idMapRelease(IdMap *m, uint64_t key)
+{
+    long long b = findBucket(m, key);
+    int slot = m->slots[b];
+    if (slot == -1)
+        return -1;
+    if (m->spareCount == m->spareCapacity)
+    {
+        m->spareCapacity = m->spareCapacity ? 2 * m->spareCapacity : 1024;
+        int *grown = realloc(m->spare, (size_t)m->spareCapacity * sizeof(int));
+        if (grown == NULL)
+        {
+            printf(RED "\nFatal: out of memory in trace id map\n" RESET);
+            exit(EXIT_FAILURE);
+        }
+        m->spare = grown;
+    }
+    m->spare[m->spareCount++] = slot;
+    m->used--;
+
+    // Backward-shift deletion: pull later entries of the probe run into the gap
+    long long gap = b, j = b;
+    m->slots[gap] = -1;
+    while (1)
+    {
+        j = (j + 1) & m->mask;
+        if (m->slots[j] == -1)
+            return slot;
+        long long home = (long long)(hashId(m->keys[j]) & (uint64_t)m->mask);
+        bool movable = (gap <= j) ? (home <= gap || home > j) : (home <= gap && home > j);
+        if (movable)
+        {
+            m->keys[gap] = m->keys[j];
+            m->slots[gap] = m->slots[j];
+            m->slots[j] = -1;
+            gap = j;
+        }
+    }
+}
+
+// ==========================================
+//      STREAMING READER
+// ==========================================
+
+// Keeps what is left in the buffer and appends the next piece of input
+static void refill(AllocTrace *t)
+{
+    memmove(t->buf, t->buf + t->pos, t->len - t->pos);
+    t->len -= t->pos;
+    t->pos = 0;
+    size_t got = fread(t->buf + t->len, 1, TRACE_BUFFER - t->len, t->fp);
+    if (got == 0)
+        t->eof = true;
+    t->len += got;
+}
+
+static void traceError(AllocTrace *t, const char *what)
+{
+    if (t->format == TRACE_TEXT)
+        snprintf(t->error, sizeof(t->error), "line %lld: %s", t->line, what);
+    else
+        snprintf(t->error, sizeof(t->error), "record %lld: %s", t->events + 1, what);
+}
+
+bool openAllocTrace(AllocTrace *t, const char *path)
+{
+    t->fp = (path == NULL || strcmp(path, "-") == 0) ? stdin : fopen(path, "rb");
+    if (t->fp == NULL)
+        return false;
+    t->buf = safeMalloc(TRACE_BUFFER + 1); // + 1 for the terminator of a final unterminated line
+    t->len = t->pos = 0;
+    t->eof = false;
+    t->line = t->events = t->expected = 0;
+    t->error[0] = '\0';
+    initIdMap(&t->ids);
+
+    while (!t->eof && t->len < sizeof(TraceHeader))
+        refill(t);
+    t->format = (t->len >= 4 && memcmp(t->buf, TRACE_MAGIC, 4) == 0) ? TRACE_BINARY : TRACE_TEXT;
+    if (t->format == TRACE_BINARY)
+    {
+        TraceHeader header;
+        if (t->len < sizeof(header))
+        {
+            traceError(t, "truncated header");
+            return true;
+        }
+        memcpy(&header, t->buf, sizeof(header));
+        t->pos = sizeof(header);
+        t->expected = (long long)header.count;
+        if (header.version != TRACE_VERSION)
+            traceError(t, "unsupported binary trace version");
+    }
+    return true;
+}
+
+void closeAllocTrace(AllocTrace *t)
+{
+    if (t->fp != NULL && t->fp != stdin)
+        fclose(t->fp);
+    free(t->buf);
+    freeIdMap(&t->ids);
+    t->fp = NULL;
+    t->buf = NULL;
+}
+
+// Next line, NUL-terminated in place; NULL at the end of input
+static char *nextLine(AllocTrace *t)
+{
+    while (1)
+    {
+        char *start = t->buf + t->pos;
+        char *newline = memchr(start, '\n', t->len - t->pos);
+        if (newline != NULL)
+        {
+            *newline = '\0';
+            t->pos = (size_t)(newline - t->buf) + 1;
+            t->line++;
+            return start;
+        }
+        if (t->eof)
+        {
+            if (t->pos == t->len)
+                return NULL;
+            t->buf[t->len] = '\0';
+            t->pos = t->len;
+            t->line++;
+            return start;
+        }
+        if (t->pos == 0 && t->len == TRACE_BUFFER)
+        {
+            t->line++;
+            traceError(t, "line too long");
+            return NULL;
+        }
+        refill(t);
+    }
+}
+
+// 1 = event, 0 = blank or comment line, -1 = malformed
+static int parseLine(char *line, TraceRecord *rec)
+{
+    char *p = line;
+    while (*p == ' ' || *p == '\t' || *p == '\r')
+        p++;
+    if (*p == '\0' || *p == '#')
+        return 0;
+
+    char op = *p;
+    const char *word = p;
+    while (*p != '\0' && *p != ' ' && *p != '\t')
+        p++;
+    if (op >= '0' && op <= '9' && p - word != 1)
+        return -1;
+    if (op == '1' || op == 'a' || op == 'm')
+        rec->op = HEAP_ALLOC;
+    else if (op == '2' || op == 'f')
+        rec->op = HEAP_FREE;
+    else
+        return -1;
+
+    while (*p == ' ' || *p == '\t')
+        p++;
+    bool hex = (p[0] == '0' && (p[1] == 'x' || p[1] == 'X'));
+    char *end;
+    rec->id = strtoull(p, &end, hex ? 16 : 10);
+    if (end == p || *p == '-')
+        return -1;
+    p = end;
+
+    rec->size = 0;
+    if (rec->op == HEAP_ALLOC)
+    {
+        long long size = strtoll(p, &end, 10);
+        if (end == p || size < 0 || size > UINT32_MAX)
+            return -1;
+        rec->size = (uint32_t)size;
+        p = end;
+    }
+    while (*p == ' ' || *p == '\t' || *p == '\r')
+        p++;
+    return (*p == '\0' || *p == '#') ? 1 : -1;
+}
+
+// Next event with its id as written in the trace; false at the end or on error
+static bool readRecord(AllocTrace *t, TraceRecord *rec)
+{
+    if (t->error[0] != '\0')
+        return false;
+    if (t->format == TRACE_TEXT)
+    {
+        char *line;
+        while ((line = nextLine(t)) != NULL)
+        {
+            int status = parseLine(line, rec);
+            if (status == 1)
+                return true;
+            if (status == -1)
+            {
+                traceError(t, "expected 'a ID SIZE' or 'f ID'");
+                return false;
+            }
+        }
+        return false;
+    }
+
+    while (!t->eof && t->len - t->pos < sizeof(TraceRecord))
+        refill(t);
+    if (t->len - t->pos < sizeof(TraceRecord))
+    {
+        if (t->len != t->pos)
+            traceError(t, "truncated record");
+        else if (t->expected != 0 && t->events != t->expected)
+            traceError(t, "fewer records than the header promises");
+        return false;
+    }
+    memcpy(rec, t->buf + t->pos, sizeof(TraceRecord));
+    t->pos += sizeof(TraceRecord);
+    if (rec->op != HEAP_ALLOC && rec->op != HEAP_FREE)
+    {
+        traceError(t, "unknown operation");
+        return false;
+    }
+    return true;
+}
+
+int readAllocTrace(AllocTrace *t, HeapEvent out[], int max)
+{
+    int n = 0;
+    TraceRecord rec;
+    while (n < max && readRecord(t, &rec))
+    {
+        out[n].op = rec.op;
+        out[n].size = rec.size;
+        // A free of an id that is not live maps to -1, which replay ignores
+        out[n].id = (rec.op == HEAP_ALLOC) ? idMapAcquire(&t->ids, rec.id) : idMapRelease(&t->ids, rec.id);
+        t->events++;
+        n++;
+    }
+    return n;
+}
+
+bool convertAllocTrace(const char *inPath, const char *outPath, long long *events, char *error, size_t errorSize)
+{
+    AllocTrace t;
+    if (!openAllocTrace(&t, inPath))
+    {
+        snprintf(error, errorSize, "cannot open %s", inPath ? inPath : "stdin");
+        return false;
+    }
+    FILE *fp = fopen(outPath, "wb");
+    if (fp == NULL)
+    {
+        closeAllocTrace(&t);
+        snprintf(error, errorSize, "cannot create %s", outPath);
+        return false;
+    }
+
+    TraceHeader header;
+    memcpy(header.magic, TRACE_MAGIC, 4);
+    header.version = TRACE_VERSION;
+    header.count = 0;
+    bool ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+
+    TraceRecord *chunk = safeMalloc(TRACE_CHUNK * sizeof(TraceRecord));
+    int n;
+    do
+    {
+        n = 0;
+        while (n < TRACE_CHUNK && readRecord(&t, &chunk[n]))
+        {
+            memset(chunk[n].reserved, 0, sizeof(chunk[n].reserved));
+            t.events++;
+            n++;
+        }
+        ok = ok && fwrite(chunk, sizeof(TraceRecord), (size_t)n, fp) == (size_t)n;
+    } while (ok && n == TRACE_CHUNK);
+    free(chunk);
+
+    // Now that the count is known, patch it into the header
+    header.count = (uint64_t)t.events;
+    ok = ok && fseek(fp, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, fp) == 1;
+    if (fclose(fp) != 0)
+        ok = false;
+
+    *events = t.events;
+    if (t.error[0] != '\0')
+        snprintf(error, errorSize, "%s", t.error);
+    else if (!ok)
+        snprintf(error, errorSize, "cannot write %s", outPath);
+    bool success = ok && t.error[0] == '\0';
+    closeAllocTrace(&t);
+    return success;
+}
+
+// ==========================================
+//      SYSTEM MALLOC BASELINE
+// ==========================================
+
+typedef struct
+{
+    void **ptr; // by slot; NULL when not live
+    long long *requested;
+    long long *held; // usable size reported by the C library, when it can
+    int capacity;
+    long long requestedBytes, heldBytes, peakHeld;
+    long long allocs, frees, failures;
+} MallocReplay;
+
+static void reserveMallocSlots(MallocReplay *m, int id)
+{
+    if (id < m->capacity)
+        return;
+    int cap = m->capacity ? m->capacity : 1024;
+    while (cap <= id)
+        cap *= 2;
+    void **ptr = realloc(m->ptr, (size_t)cap * sizeof(void *));
+    long long *requested = realloc(m->requested, (size_t)cap * sizeof(long long));
+    long long *held = realloc(m->held, (size_t)cap * sizeof(long long));
+    if (ptr == NULL || requested == NULL || held == NULL)
+    {
+        printf(RED "\nFatal: out of memory in malloc replay\n" RESET);
+        exit(EXIT_FAILURE);
+    }
+    for (int i = m->capacity; i < cap; i++)
+        ptr[i] = NULL;
+    m->ptr = ptr;
+    m->requested = requested;
+    m->held = held;
+    m->capacity = cap;
+}
+
+static long long replayMalloc(MallocReplay *m, const HeapEvent events[], int count)
+{
+    for (int i = 0; i < count; i++)
+        if (events[i].id >= 0)
+            reserveMallocSlots(m, events[i].id);
+
+    long long start = monotonicNanos();
+    for (int i = 0; i < count; i++)
+    {
+        int id = events[i].id;
+        if (id < 0)
+            continue;
+        if (events[i].op == HEAP_ALLOC && m->ptr[id] == NULL)
+        {
+            void *p = malloc((size_t)events[i].size);
+            if (p == NULL)
+            {
+                m->failures++;
+                continue;
+            }
+#ifdef __GLIBC__
+            long long held = (long long)malloc_usable_size(p);
+#else
+            long long held = events[i].size;
+#endif
+            m->ptr[id] = p;
+            m->requested[id] = events[i].size;
+            m->held[id] = held;
+            m->requestedBytes += events[i].size;
+            m->heldBytes += held;
+            if (m->heldBytes > m->peakHeld)
+                m->peakHeld = m->heldBytes;
+            m->allocs++;
+        }
+        else if (events[i].op == HEAP_FREE && m->ptr[id] != NULL)
+        {
+            free(m->ptr[id]);
+            m->ptr[id] = NULL;
+            m->requestedBytes -= m->requested[id];
+            m->heldBytes -= m->held[id];
+            m->frees++;
+        }
+    }
+    return monotonicNanos() - start;
+}
+
+static void freeMallocReplay(MallocReplay *m)
+{
+    for (int i = 0; i < m->capacity; i++)
+        free(m->ptr[i]);
+    free(m->ptr);
+    free(m->requested);
+    free(m->held);
+}
+
+// ==========================================
+//      BENCHMARK HARNESS
+// ==========================================
+
+// Folds the engines' current state into their fragmentation, internal waste and metadata figures
+static void sampleEngines(const Allocator allocators[], const HeapReplay replays[], int count,
+                          TraceBenchResult results[], double fragSum[])
+{
+    for (int i = 0; i < count; i++)
+    {
+        TraceBenchResult *r = &results[i];
+        AllocatorStats st;
+        allocators[i].ops->stats(allocators[i].self, &st);
+        double frag = externalFragmentation(&st);
+        fragSum[i] += frag;
+        if (frag > r->maxExternalFrag)
+            r->maxExternalFrag = frag;
+        if (st.blockBytes - replays[i].requestedBytes > r->peakInternal)
+            r->peakInternal = st.blockBytes - replays[i].requestedBytes;
+        if (st.metadataBytes > r->peakMetadataBytes)
+            r->peakMetadataBytes = st.metadataBytes;
+    }
+}
+
+int benchmarkTrace(const char *path, long long arenaSize, unsigned engineMask, bool withMalloc,
+                   TraceBenchResult results[], char *error, size_t errorSize)
+{
+    AllocTrace trace;
+    if (!openAllocTrace(&trace, path))
+    {
+        snprintf(error, errorSize, "cannot open %s", path ? path : "stdin");
+        return -1;
+    }
+
+    Allocator allocators[ENGINE_COUNT];
+    HeapReplay replays[ENGINE_COUNT];
+    double fragSum[ENGINE_COUNT];
+    int count = 0;
+    for (int e = ENGINE_BEST_FIT; e <= ENGINE_SLAB; e++)
+    {
+        if (!(engineMask & (1u << (e - 1))))
+            continue;
+        if (!createAllocator((AllocatorEngine)e, arenaSize, &allocators[count]))
+        {
+            snprintf(error, errorSize, "arena of %lld bytes is too small for %s", arenaSize,
+                     engineName((AllocatorEngine)e));
+            for (int i = 0; i < count; i++)
+            {
+                freeHeapReplay(&replays[i]);
+                destroyAllocator(&allocators[i]);
+            }
+            closeAllocTrace(&trace);
+            return -1;
+        }
+        initHeapReplay(&replays[count], allocators[count]);
+        TraceBenchResult *r = &results[count];
+        memset(r, 0, sizeof(*r));
+        r->name = engineName((AllocatorEngine)e);
+        fragSum[count++] = 0.0;
+    }
+    MallocReplay sys;
+    memset(&sys, 0, sizeof(sys));
+
+    // Every chunk goes through all engines before the next is read, so the
+    // trace is streamed once. Stats are sampled every TRACE_SAMPLE_EVERY
+    // events, and after the last one, wherever the chunks happen to end.
+    HeapEvent *chunk = safeMalloc(TRACE_CHUNK * sizeof(HeapEvent));
+    long long samples = 0, replayed = 0, mallocElapsed = 0, mallocPeakInternal = 0;
+    int n;
+    while ((n = readAllocTrace(&trace, chunk, TRACE_CHUNK)) > 0)
+    {
+        for (int done = 0; done < n;)
+        {
+            int step = (int)(TRACE_SAMPLE_EVERY - replayed % TRACE_SAMPLE_EVERY);
+            if (step > n - done)
+                step = n - done;
+            for (int i = 0; i < count; i++)
+                results[i].elapsedNs += replayHeapBatch(&replays[i], chunk + done, step);
+            if (withMalloc)
+            {
+                mallocElapsed += replayMalloc(&sys, chunk + done, step);
+                if (sys.heldBytes - sys.requestedBytes > mallocPeakInternal)
+                    mallocPeakInternal = sys.heldBytes - sys.requestedBytes;
+            }
+            done += step;
+            replayed += step;
+            if (replayed % TRACE_SAMPLE_EVERY == 0)
+            {
+                sampleEngines(allocators, replays, count, results, fragSum);
+                samples++;
+            }
+        }
+    }
+    if (replayed % TRACE_SAMPLE_EVERY != 0)
+    {
+        sampleEngines(allocators, replays, count, results, fragSum);
+        samples++;
+    }
+    free(chunk);
+
+    for (int i = 0; i < count; i++)
+    {
+        AllocatorStats st;
+        allocators[i].ops->stats(allocators[i].self, &st);
+        TraceBenchResult *r = &results[i];
+        r->events = replays[i].events;
+        r->allocs = st.allocs;
+        r->frees = st.frees;
+        r->failures = st.failures;
+        r->peakBytes = st.peakBlockBytes;
+        r->meanExternalFrag = samples ? fragSum[i] / samples : 0.0;
+        freeHeapReplay(&replays[i]);
+        destroyAllocator(&allocators[i]);
+    }
+    if (withMalloc)
+    {
+        TraceBenchResult *r = &results[count++];
+        r->name = "System malloc";
+        r->events = trace.events;
+        r->allocs = sys.allocs;
+        r->frees = sys.frees;
+        r->failures = sys.failures;
+        r->elapsedNs = mallocElapsed;
+        r->peakBytes = sys.peakHeld;
+        r->peakInternal = mallocPeakInternal;
+        r->peakMetadataBytes = -1; // headers and free lists are hidden inside the C library
+        r->meanExternalFrag = r->maxExternalFrag = -1.0;
+        freeMallocReplay(&sys);
+    }
+
+    if (trace.error[0] != '\0')
+    {
+        snprintf(error, errorSize, "%s", trace.error);
+        count = -1;
+    }
+    closeAllocTrace(&trace);
+    return count;
+}
@@ -0,0 +1,97 @@
+#ifndef ALLOC_TRACE_H
+#define ALLOC_TRACE_H
+
+#include "allocator.h"
+
+// --- Constants ---
+#define TRACE_CHUNK 65536      // events decoded per read
+#define TRACE_BUFFER (1 << 20) // bytes of input held at a time
+#define TRACE_SAMPLE_EVERY 256 // events between fragmentation samples in benchmarkTrace
+#define BENCH_MALLOC ENGINE_COUNT
+#define BENCH_COUNT (ENGINE_COUNT + 1) // the engines plus the system malloc baseline
+
+// --- Structures ---
+/**
+ * Open-addressing hash (linear probing) from the ids in a trace - arbitrary
+ * 64-bit values such as pointers from a malloc log - to small dense slots.
+ * Slots of freed ids are recycled, so replay tables only grow with the
+ * number of blocks live at once, not with the length of the trace.
+ */
+typedef struct
+{
+    uint64_t *keys;
+    int *slots; // -1 marks an empty bucket
+    long long mask;
+    long long used;
+    int *spare; // recycled slots
+    int spareCount, spareCapacity;
+    int nextSlot;
+} IdMap;
+
+typedef enum
+{
+    TRACE_TEXT,
+    TRACE_BINARY
+} TraceFormat;
+
+/**
+ * Streaming reader for allocation traces. Only one buffer of input is held,
+ * so traces far larger than memory can be replayed. Two formats:
+ *   text   - one event per line: "a ID SIZE" / "f ID" (1 and 2, or m for
+ *            malloc, also work), ids decimal or 0x-hex, '#' comments;
+ *   binary - "OSAT" header then fixed 16-byte records (see alloc_trace.c).
+ * Event ids come out already mapped to dense slots.
+ */
+typedef struct
+{
+    FILE *fp;
+    TraceFormat format;
+    char *buf;
+    size_t len, pos;
+    bool eof;
+    long long line;     // text: last line read, for error messages
+    long long events;   // events decoded so far
+    long long expected; // binary: record count from the header
+    char error[128];    // empty unless reading stopped on bad input
+    IdMap ids;
+} AllocTrace;
+
+typedef struct
+{
+    const char *name;
+    long long events, allocs, frees, failures;
+    long long elapsedNs;
+    long long peakBytes;         // most bytes held at once, including rounding and headers
+    long long peakInternal;      // most bytes held beyond what was requested
+    long long peakMetadataBytes; // -1 when the allocator does not expose it
+    double meanExternalFrag;     // sampled every TRACE_SAMPLE_EVERY events and at the end; -1 when unknown
+    double maxExternalFrag;
+} TraceBenchResult;
+
+// --- Function Prototypes ---
+void initIdMap(IdMap *m);
+void freeIdMap(IdMap *m);
+int idMapAcquire(IdMap *m, uint64_t key); // slot of a live key, or a fresh one
+int idMapRelease(IdMap *m, uint64_t key); // the key's slot (now recycled), or -1 if unknown
+
+bool openAllocTrace(AllocTrace *t, const char *path); // NULL or "-" reads stdin
+int readAllocTrace(AllocTrace *t, HeapEvent out[], int max); // events read, 0 at the end
+void closeAllocTrace(AllocTrace *t);
+
+/**
+ * Rewrites a trace (text or binary) as a binary trace, streaming. Returns
+ * false and fills `error` on bad input or I/O failure.
+ */
+bool convertAllocTrace(const char *inPath, const char *outPath, long long *events, char *error, size_t errorSize);
+
+/**
+ * Streams the trace once and replays each chunk through every engine in
+ * `engineMask` (bit e-1 for AllocatorEngine e) and, if `withMalloc`, the
+ * system malloc. Fragmentation is sampled every TRACE_SAMPLE_EVERY events
+ * and once more at the end. Fills results in engine order, malloc last;
+ * returns how many, or -1 with `error` filled.
+ */
+int benchmarkTrace(const char *path, long long arenaSize, unsigned engineMask, bool withMalloc,
+                   TraceBenchResult results[], char *error, size_t errorSize);
+
+#endif
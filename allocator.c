@@ -0,0 +1,261 @@
+#include "allocator.h"
+#include "dynamic_partition.h"
+#include "buddy_allocator.h"
+#include "slab_allocator.h"
+
+// ==========================================
+//      ALLOCATION ENGINES
+// ==========================================
+
+#define MAX_EVENT_ID (1 << 26)
+
+const char *engineName(AllocatorEngine engine)
+{
+    static const char *names[] = {"Best Fit", "First Fit", "Worst Fit", "Buddy", "Slab"};
+    return (engine >= ENGINE_BEST_FIT && engine <= ENGINE_SLAB) ? names[engine - 1] : "Unknown";
+}
+
+bool createAllocator(AllocatorEngine engine, long long arenaSize, Allocator *out)
+{
+    if (engine >= ENGINE_BEST_FIT && engine <= ENGINE_WORST_FIT)
+    {
+        PartitionHeap *h = safeMalloc(sizeof(PartitionHeap));
+        if (!initPartitionHeap(h, arenaSize, (FitStrategy)engine))
+        {
+            free(h);
+            return false;
+        }
+        out->ops = &partitionOps;
+        out->self = h;
+        return true;
+    }
+    if (engine == ENGINE_BUDDY)
+    {
+        BuddyAllocator *b = safeMalloc(sizeof(BuddyAllocator));
+        if (!initBuddy(b, arenaSize))
+        {
+            free(b);
+            return false;
+        }
+        out->ops = &buddyOps;
+        out->self = b;
+        return true;
+    }
+    if (engine == ENGINE_SLAB)
+    {
+        SlabAllocator *s = safeMalloc(sizeof(SlabAllocator));
+        if (!initSlab(s, arenaSize))
+        {
+            free(s);
+            return false;
+        }
+        out->ops = &slabOps;
+        out->self = s;
+        return true;
+    }
+    return false;
+}
+
+void destroyAllocator(Allocator *a)
+{
+    if (a->self != NULL)
+        a->ops->destroy(a->self);
+    a->self = NULL;
+}
+
+// Share of free memory that a single request could not use (0 = one big region)
+double externalFragmentation(const AllocatorStats *st)
+{
+    if (st->freeBytes <= 0)
+        return 0.0;
+    return 100.0 * (1.0 - (double)st->largestFree / (double)st->freeBytes);
+}
+
+// ==========================================
+//      EVENT REPLAY
+// ==========================================
+
+void initHeapReplay(HeapReplay *r, Allocator allocator)
+{
+    r->allocator = allocator;
+    r->offsetOf = NULL;
+    r->sizeOf = NULL;
+    r->idCapacity = 0;
+    r->requestedBytes = 0;
+    r->events = 0;
+    r->totalLatencyNs = 0;
+    r->maxLatencyNs = 0;
+    r->compaction = COMPACT_NONE;
+    r->compactions = r->rescued = 0;
+    r->bytesMoved = r->blocksMoved = 0;
+    r->compactionNs = 0;
+    r->loadAtCompaction = 0.0;
+}
+
+void freeHeapReplay(HeapReplay *r)
+{
+    free(r->offsetOf);
+    free(r->sizeOf);
+    r->offsetOf = r->sizeOf = NULL;
+    r->idCapacity = 0;
+}
+
+static bool reserveIds(HeapReplay *r, int id)
+{
+    if (id < 0 || id >= MAX_EVENT_ID)
+        return false;
+    if (id < r->idCapacity)
+        return true;
+    int cap = r->idCapacity ? r->idCapacity : 1024;
+    while (cap <= id)
+        cap *= 2;
+    long long *offsets = realloc(r->offsetOf, cap * sizeof(long long));
+    long long *sizes = realloc(r->sizeOf, cap * sizeof(long long));
+    if (offsets == NULL || sizes == NULL)
+    {
+        printf(RED "\nFatal: out of memory in heap replay\n" RESET);
+        exit(EXIT_FAILURE);
+    }
+    for (int i = r->idCapacity; i < cap; i++)
+        offsets[i] = -1;
+    r->offsetOf = offsets;
+    r->sizeOf = sizes;
+    r->idCapacity = cap;
+    return true;
+}
+
+static int compareRelocations(const void *a, const void *b)
+{
+    long long x = ((const Relocation *)a)->from, y = ((const Relocation *)b)->from;
+    return (x > y) - (x < y);
+}
+
+// Points every live id whose block moved at the block's new offset
+static void followRelocations(HeapReplay *r, Relocation moves[], int count)
+{
+    qsort(moves, (size_t)count, sizeof(Relocation), compareRelocations);
+    for (int id = 0; id < r->idCapacity; id++)
+    {
+        if (r->offsetOf[id] == -1)
+            continue;
+        int lo = 0, hi = count - 1;
+        while (lo <= hi)
+        {
+            int mid = (lo + hi) / 2;
+            if (moves[mid].from == r->offsetOf[id])
+            {
+                r->offsetOf[id] = moves[mid].to;
+                break;
+            }
+            if (moves[mid].from < r->offsetOf[id])
+                lo = mid + 1;
+            else
+                hi = mid - 1;
+        }
+    }
+}
+
+// A request failed: compact under the replay's policy and try once more
+static long long compactAndRetry(HeapReplay *r, long long size)
+{
+    const AllocatorOps *ops = r->allocator.ops;
+    void *self = r->allocator.self;
+    AllocatorStats st;
+    ops->stats(self, &st);
+    long long arena = st.blockBytes + st.freeBytes;
+
+    Relocation *moves = NULL;
+    int count = 0;
+    long long start = monotonicNanos();
+    if (!ops->compact(self, r->compaction, size, &moves, &count))
+        return -1;
+    r->compactionNs += monotonicNanos() - start;
+    r->compactions++;
+    r->loadAtCompaction += arena > 0 ? (double)st.blockBytes / arena : 0.0;
+    r->blocksMoved += count;
+    for (int i = 0; i < count; i++)
+        r->bytesMoved += moves[i].bytes;
+    followRelocations(r, moves, count);
+    free(moves);
+
+    long long offset = ops->alloc(self, size);
+    if (offset != -1)
+        r->rescued++;
+    return offset;
+}
+
+// One event against ids already reserved; unknown or stale ids are no-ops
+static bool replayStep(HeapReplay *r, const HeapEvent *ev, long long *offset)
+{
+    if (ev->id < 0 || ev->id >= r->idCapacity)
+        return false;
+    if (ev->op == HEAP_ALLOC && r->offsetOf[ev->id] == -1)
+    {
+        *offset = r->allocator.ops->alloc(r->allocator.self, ev->size);
+        if (*offset == -1 && r->compaction != COMPACT_NONE && r->allocator.ops->compact != NULL)
+            *offset = compactAndRetry(r, ev->size);
+        if (*offset == -1)
+            return false;
+        r->offsetOf[ev->id] = *offset;
+        r->sizeOf[ev->id] = ev->size;
+        r->requestedBytes += ev->size;
+        return true;
+    }
+    if (ev->op == HEAP_FREE && r->offsetOf[ev->id] != -1)
+    {
+        *offset = r->offsetOf[ev->id];
+        if (!r->allocator.ops->release(r->allocator.self, *offset))
+            return false;
+        r->offsetOf[ev->id] = -1;
+        r->requestedBytes -= r->sizeOf[ev->id];
+        return true;
+    }
+    return false;
+}
+
+// Applies one event; `sample` (optional) receives the allocator state afterwards
+bool applyHeapEvent(HeapReplay *r, const HeapEvent *ev, HeapSample *sample)
+{
+    long long offset = -1;
+    reserveIds(r, ev->id);
+    long long start = monotonicNanos();
+    bool ok = replayStep(r, ev, &offset);
+    long long latency = monotonicNanos() - start;
+
+    r->events++;
+    r->totalLatencyNs += latency;
+    if (latency > r->maxLatencyNs)
+        r->maxLatencyNs = latency;
+
+    if (sample != NULL)
+    {
+        AllocatorStats st;
+        r->allocator.ops->stats(r->allocator.self, &st);
+        sample->event = r->events;
+        sample->op = ev->op;
+        sample->ok = ok;
+        sample->offset = offset;
+        sample->blockBytes = st.blockBytes;
+        sample->freeBytes = st.freeBytes;
+        sample->largestHole = st.largestFree;
+        sample->holes = st.freeRegions;
+        sample->externalFrag = externalFragmentation(&st);
+        sample->latencyNs = latency;
+    }
+    return ok;
+}
+
+// Replays a run of events under one timer, so clock reads do not dominate
+// cheap operations. maxLatencyNs is not updated. Returns the elapsed time.
+long long replayHeapBatch(HeapReplay *r, const HeapEvent events[], int count)
+{
+    for (int i = 0; i < count; i++)
+        reserveIds(r, events[i].id);
+    long long offset, start = monotonicNanos();
+    for (int i = 0; i < count; i++)
+        replayStep(r, &events[i], &offset);
+    long long elapsed = monotonicNanos() - start;
+    r->events += count;
+    r->totalLatencyNs += elapsed;
+    return elapsed;
+}
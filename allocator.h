@@ -0,0 +1,132 @@
+#ifndef ALLOCATOR_H
+#define ALLOCATOR_H
+
+#include "utils.h"
+#include <stdint.h>
+
+// --- Structures ---
+typedef enum
+{
+    HEAP_ALLOC = 1,
+    HEAP_FREE = 2
+} HeapOp;
+
+typedef struct
+{
+    int op;         // HeapOp
+    int id;         // names the allocation so a later HEAP_FREE can refer to it
+    long long size; // bytes requested (HEAP_ALLOC only)
+} HeapEvent;
+
+typedef struct
+{
+    long long allocs, frees, failures;
+    long long blockBytes; // live bytes handed out, including tags, padding and rounding
+    long long peakBlockBytes;
+    long long freeBytes;     // arena bytes not handed out
+    long long largestFree;   // largest single free region
+    long long freeRegions;   // holes / free buddy blocks / free slab slots
+    long long metadataBytes; // bookkeeping kept outside the arena
+} AllocatorStats;
+
+// How an engine may rearrange live blocks when a request does not fit
+typedef enum
+{
+    COMPACT_NONE = 0,
+    COMPACT_SLIDING = 1,  // slide every block down to one end
+    COMPACT_MIN_MOVE = 2  // move only the cheapest set of blocks that opens a big enough hole
+} CompactionPolicy;
+
+// One block moved by compaction; offsets are as handed out by the engine
+typedef struct
+{
+    long long from, to;
+    long long bytes; // copied, tags and padding included
+} Relocation;
+
+/**
+ * What every allocation engine provides, so the same event stream can be
+ * replayed through fit strategies, the buddy system and the slab allocator.
+ * Offsets are positions in the engine's simulated arena.
+ */
+typedef struct
+{
+    const char *name;
+    long long (*alloc)(void *self, long long size); // offset, or -1 when it does not fit
+    bool (*release)(void *self, long long offset);
+    void (*stats)(const void *self, AllocatorStats *out);
+    void (*memoryMap)(const void *self, char *out, int width); // '#' used, '.' free
+    void (*destroy)(void *self);
+    // Makes room for `size` by moving live blocks; NULL if blocks cannot move.
+    // On success *moves is a new array the caller frees (may be NULL if nothing moved).
+    bool (*compact)(void *self, CompactionPolicy policy, long long size, Relocation **moves, int *count);
+} AllocatorOps;
+
+typedef struct
+{
+    const AllocatorOps *ops;
+    void *self;
+} Allocator;
+
+// Engines in menu order; the fit strategies keep their FitStrategy numbers
+typedef enum
+{
+    ENGINE_BEST_FIT = 1,
+    ENGINE_FIRST_FIT = 2,
+    ENGINE_WORST_FIT = 3,
+    ENGINE_BUDDY = 4,
+    ENGINE_SLAB = 5
+} AllocatorEngine;
+
+#define ENGINE_COUNT 5
+
+// One point of the allocator's state over time
+typedef struct
+{
+    long long event;
+    int op;
+    bool ok;
+    long long offset; // offset of the block allocated or freed, -1 if none
+    long long blockBytes;
+    long long freeBytes;
+    long long largestHole;
+    long long holes;
+    double externalFrag; // percent of free memory outside the largest free region
+    long long latencyNs;
+} HeapSample;
+
+/**
+ * Replays an allocate/free stream against an allocator: maps event ids to
+ * live blocks and times each operation. With a compaction policy, a failed
+ * allocation compacts the arena and is retried; ids follow moved blocks.
+ */
+typedef struct
+{
+    Allocator allocator;
+    long long *offsetOf; // by id; -1 when the id is not live
+    long long *sizeOf;
+    int idCapacity;
+    long long requestedBytes; // live payload bytes the program asked for
+    long long events;
+    long long totalLatencyNs, maxLatencyNs;
+    CompactionPolicy compaction;
+    long long compactions;
+    long long rescued;      // allocations that succeeded only after compacting
+    long long bytesMoved, blocksMoved;
+    long long compactionNs; // time spent compacting (included in the latencies)
+    double loadAtCompaction; // sum of arena utilization at each compaction
+} HeapReplay;
+
+// --- Engines ---
+bool createAllocator(AllocatorEngine engine, long long arenaSize, Allocator *out);
+void destroyAllocator(Allocator *a);
+const char *engineName(AllocatorEngine engine);
+double externalFragmentation(const AllocatorStats *st);
+
+// --- Replay ---
+void initHeapReplay(HeapReplay *r, Allocator allocator);
+void freeHeapReplay(HeapReplay *r);
+bool applyHeapEvent(HeapReplay *r, const HeapEvent *ev, HeapSample *sample);
+long long replayHeapBatch(HeapReplay *r, const HeapEvent events[], int count);
+
+#endif
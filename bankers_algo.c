@@ -3,6 +3,41 @@
 //      MODULE 3: BANKER'S ALGORITHM
 // ==========================================
 
+// Safety algorithm: fills safeSeq and returns true if every process can finish.
+// `work` starts as the available vector and is consumed by the search.
+bool findSafeSequence(int n, int m, int alloc[n][m], int need[n][m], int work[m], int safeSeq[n])
+{
+    bool finish[n];
+    for (int i = 0; i < n; i++)
+        finish[i] = false;
+    int count = 0;
+    while (count < n)
+    {
+        bool found = false;
+        for (int p = 0; p < n; p++)
+        {
+            if (!finish[p])
+            {
+                int j;
+                for (j = 0; j < m; j++)
+                    if (need[p][j] > work[j])
+                        break;
+                if (j == m)
+                {
+                    for (int k = 0; k < m; k++)
+                        work[k] += alloc[p][k];
+                    safeSeq[count++] = p;
+                    finish[p] = true;
+                    found = true;
+                }
+            }
+        }
+        if (!found)
+            return false;
+    }
+    return true;
+}
+
 void runBankersAlgorithm()
 {
     int n, m;
@@ -14,7 +49,6 @@ void runBankersAlgorithm()
 
     int alloc[n][m], max[n][m], avail[m], need[n][m], safeSeq[n];
     int work[m];
-    bool finish[n];
 
     printf("\nEnter Allocation Matrix:\n");
     for (int i = 0; i < n; i++)
@@ -42,35 +76,10 @@ void runBankersAlgorithm()
         work[i] = avail[i];
     }
 
-    for (int i = 0; i < n; i++)
-        finish[i] = false;
-    int count = 0;
-    while (count < n)
+    if (!findSafeSequence(n, m, alloc, need, work, safeSeq))
     {
-        bool found = false;
-        for (int p = 0; p < n; p++)
-        {
-            if (!finish[p])
-            {
-                int j;
-                for (j = 0; j < m; j++)
-                    if (need[p][j] > work[j])
-                        break;
-                if (j == m)
-                {
-                    for (int k = 0; k < m; k++)
-                        work[k] += alloc[p][k];
-                    safeSeq[count++] = p;
-                    finish[p] = true;
-                    found = true;
-                }
-            }
-        }
-        if (!found)
-        {
-            printf(RED "\nSystem is in an UNSAFE state! (Deadlock Risk)\n" RESET);
-            return;
-        }
+        printf(RED "\nSystem is in an UNSAFE state! (Deadlock Risk)\n" RESET);
+        return;
     }
     printf(GREEN "\nSystem is in a SAFE state.\nSafe Sequence: " RESET);
     for (int i = 0; i < n; i++)
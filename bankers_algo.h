@@ -4,6 +4,12 @@
 #include "utils.h"
 
 // --- Function Prototypes ---
+/**
+ * Runs the safety algorithm on the given matrices. Returns true and fills
+ * safeSeq when the state is safe. `work` is initialised from Available.
+ */
+bool findSafeSequence(int n, int m, int alloc[n][m], int need[n][m], int work[m], int safeSeq[n]);
+
 /**
  * Executes the Banker's Algorithm to determine if the system
  * is in a safe state and find a valid sequence.
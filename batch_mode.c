@@ -0,0 +1,1309 @@
+#include "batch_mode.h"
+#include "cpu_scheduling.h"
+#include "memory_Allocation.h"
+#include "bankers_algo.h"
+#include "disk_scheduler.h"
+#include "disk_timed.h"
+#include "block_trace.h"
+#include "page_replacement.h"
+#include "stack_distance.h"
+#include "page_trace.h"
+#include "page_bench.h"
+#include "virtual_memory.h"
+#include "race_condition.h"
+#include "reader_writer.h"
+#include "dining_philosophers.h"
+#include "priority_scheduling.h"
+#include "scheduler_compare.h"
+#include "smp_scheduling.h"
+#include "workload_gen.h"
+#include "alloc_trace.h"
+
+// ==========================================
+//      HEADLESS BATCH MODE
+// ==========================================
+
+#define READ_CHUNK (1 << 20)
+
+typedef struct
+{
+    const char *module;
+    const char *input; // NULL or "-" reads stdin
+    const char *algo;
+    int quantum;
+    int qMin, qMax, qStep; // quantum sweep for --algo compare
+    int threads;
+    int sampleEvery;          // --sample N: heap prints every Nth event, disk every Nth service (0 = summary only)
+    int aging;                // --aging: priority aging interval (0 = off)
+    MLFQConfig mlfq;          // --levels, --quantum (top queue), --boost
+    SMPConfig smp;            // --cores, --local, --balance, --balance-interval
+    bool generate;            // --generate N: synthesize the CPU workload
+    WorkloadConfig gen;       // distribution settings for --generate
+    const char *workloadFile; // --workload FILE: binary workload to map in
+    const char *output;       // --output FILE: where the gen and trace modules write
+    long long arenaSize;      // --arena BYTES: simulated arena for the trace module
+    CompactionPolicy compact; // --compact: heap module compacts and retries failed allocations
+    int frames;               // --frames N: frame count for the pagetrace module
+    long long pageSize;       // --page-size BYTES: address-to-page granularity for pagetrace
+    bool dataOnly;            // --data-only: pagetrace drops lackey instruction fetches
+    long long refs;           // --refs N: references per synthetic pattern in pagebench
+    DiskConfig disk;          // --cylinders, --direction (disk module)
+    IoWorkloadConfig io;      // --generate, --interarrival, --processes, --writes, --read-deadline (disktimed)
+    VmConfig vm;              // --pt-levels, --pt-bits, --tlb-sets, --tlb-ways, --memory, --huge (vm module)
+    int device;               // --device linear|hdd|ssd|all: disktimed device model (0 = all)
+    BlockReplayConfig replay; // --outstanding, --time-scale (blocktrace)
+    IoStagingConfig staging;  // --plug, --plug-limit, --merge-limit (disktimed, blocktrace)
+} BatchOptions;
+
+typedef struct
+{
+    const char *name;
+    bool needsInput;
+    int (*run)(IntReader *in, const BatchOptions *opt);
+    const char *inputFormat;
+} BatchModule;
+
+// ==========================================
+//      FAST INTEGER INPUT
+// ==========================================
+
+bool openIntReader(IntReader *r, const char *path)
+{
+    r->fp = (path == NULL || strcmp(path, "-") == 0) ? stdin : fopen(path, "rb");
+    if (r->fp == NULL)
+        return false;
+    r->buf = safeMalloc(READ_CHUNK);
+    r->len = 0;
+    r->pos = 0;
+    return true;
+}
+
+void closeIntReader(IntReader *r)
+{
+    if (r->fp != NULL && r->fp != stdin)
+        fclose(r->fp);
+    free(r->buf);
+    r->fp = NULL;
+    r->buf = NULL;
+}
+
+static int peekChar(IntReader *r)
+{
+    if (r->pos == r->len)
+    {
+        r->len = fread(r->buf, 1, READ_CHUNK, r->fp);
+        r->pos = 0;
+        if (r->len == 0)
+            return EOF;
+    }
+    return (unsigned char)r->buf[r->pos];
+}
+
+// Reads the next integer, skipping separators. Returns false at end of input.
+bool readInt(IntReader *r, int *out)
+{
+    int c = peekChar(r);
+    while (c != EOF && c != '-' && (c < '0' || c > '9'))
+    {
+        r->pos++;
+        c = peekChar(r);
+    }
+    if (c == EOF)
+        return false;
+
+    bool negative = false;
+    if (c == '-')
+    {
+        negative = true;
+        r->pos++;
+        c = peekChar(r);
+        if (c < '0' || c > '9')
+            return readInt(r, out); // a lone '-' is just another separator
+    }
+
+    long value = 0;
+    while (c >= '0' && c <= '9')
+    {
+        value = value * 10 + (c - '0');
+        r->pos++;
+        c = peekChar(r);
+    }
+    *out = (int)(negative ? -value : value);
+    return true;
+}
+
+// Reads a count followed by that many integers into a new array
+static int *readIntArray(IntReader *in, int *count)
+{
+    if (!readInt(in, count) || *count < 0)
+        return NULL;
+    int *values = safeMalloc((*count) * sizeof(int));
+    for (int i = 0; i < *count; i++)
+    {
+        if (!readInt(in, &values[i]))
+        {
+            free(values);
+            return NULL;
+        }
+    }
+    return values;
+}
+
+static int inputError(const char *module, const char *what)
+{
+    fprintf(stderr, "batch %s: %s\n", module, what);
+    return 1;
+}
+
+static bool algoSelected(const BatchOptions *opt, const char *name)
+{
+    return opt->algo == NULL || strcmp(opt->algo, "all") == 0 || strcmp(opt->algo, name) == 0;
+}
+
+// ==========================================
+//      MODULE RUNNERS
+// ==========================================
+
+// CPU workload from --generate, --workload or the text input, in that order
+static Process *readCPUWorkload(IntReader *in, const BatchOptions *opt, int *n)
+{
+    if (opt->generate)
+    {
+        char error[128];
+        if (!validateWorkloadConfig(&opt->gen, error, sizeof(error)))
+        {
+            inputError("cpu", error);
+            return NULL;
+        }
+        *n = (int)opt->gen.count;
+        return generateWorkload(&opt->gen);
+    }
+    if (opt->workloadFile != NULL)
+    {
+        Process *p = loadWorkload(opt->workloadFile, n);
+        if (p == NULL)
+            inputError("cpu", "cannot load the binary workload file");
+        return p;
+    }
+
+    if (!readInt(in, n) || *n <= 0)
+    {
+        inputError("cpu", "expected a positive process count");
+        return NULL;
+    }
+    Process *p = safeMalloc(*n * sizeof(Process));
+    for (int i = 0; i < *n; i++)
+    {
+        p[i].id = i + 1;
+        if (!readInt(in, &p[i].bt) || !readInt(in, &p[i].at) || !readInt(in, &p[i].pr))
+        {
+            free(p);
+            inputError("cpu", "expected Burst, Arrival, Priority for every process");
+            return NULL;
+        }
+    }
+    return p;
+}
+
+static int batchCPU(IntReader *in, const BatchOptions *opt)
+{
+    int n;
+    Process *original = readCPUWorkload(in, opt, &n);
+    if (original == NULL)
+        return 1;
+    Process *working = safeMalloc(n * sizeof(Process));
+
+    sortByArrival(original, n);
+
+    if (opt->algo != NULL && strcmp(opt->algo, "compare") == 0)
+    {
+        int count;
+        ComparisonRow *rows = compareSchedulers(original, n, opt->qMin, opt->qMax, opt->qStep,
+                                                opt->threads, &count);
+        printf("# compare,algorithm,quantum,avg_waiting,avg_turnaround,context_switches,cpu_utilization\n");
+        for (int i = 0; i < count; i++)
+            printf("compare,%s,%d,%.4f,%.4f,%d,%.4f\n", rows[i].algorithm, rows[i].quantum,
+                   rows[i].avgWaiting, rows[i].avgTurnaround, rows[i].contextSwitches, rows[i].cpuUtilization);
+        free(rows);
+        free(original);
+        free(working);
+        return 0;
+    }
+
+    if (opt->algo != NULL && strcmp(opt->algo, "smp") == 0)
+    {
+        SMPResult res;
+        initSMPResult(&res, opt->smp.cores);
+        scheduleSMP(original, n, &opt->smp, &res);
+        printf("# process,algorithm,id,arrival,burst,priority,completion,turnaround,waiting\n");
+        printf("# smp_segment,core,pid,start,end\n");
+        printf("# core,core,busy,utilization,segments,context_switches\n");
+        printf("# smp_summary,cores,balance,processes,avg_waiting,avg_turnaround,makespan,migrations,"
+               "context_switches\n");
+        double sumWt = 0, sumTat = 0;
+        int switches = 0;
+        for (int i = 0; i < n; i++)
+        {
+            printf("process,SMP,%d,%d,%d,%d,%d,%d,%d\n", original[i].id, original[i].at, original[i].bt,
+                   original[i].pr, original[i].ct, original[i].tat, original[i].wt);
+            sumWt += original[i].wt;
+            sumTat += original[i].tat;
+        }
+        for (int c = 0; c < res.cores; c++)
+            for (int i = 0; i < res.traces[c].count; i++)
+                printf("smp_segment,%d,%d,%d,%d\n", c, res.traces[c].segments[i].pid,
+                       res.traces[c].segments[i].startTime, res.traces[c].segments[i].endTime);
+        for (int c = 0; c < res.cores; c++)
+        {
+            printf("core,%d,%lld,%.4f,%d,%d\n", c, res.busyTime[c], smpUtilization(&res, c),
+                   res.traces[c].count, res.traces[c].contextSwitches);
+            switches += res.traces[c].contextSwitches;
+        }
+        printf("smp_summary,%d,%s,%d,%.4f,%.4f,%d,%lld,%d\n", res.cores, smpBalanceName(opt->smp.balance), n,
+               sumWt / n, sumTat / n, res.endTime - res.startTime, res.migrations, switches);
+        freeSMPResult(&res);
+        free(original);
+        free(working);
+        return 0;
+    }
+
+    const char *names[] = {"fcfs", "sjf", "srtf", "rr", "priority", "mlfq"};
+    const char *labels[] = {"FCFS", "SJF", "SRTF", "RR", "PRIORITY", "MLFQ"};
+    SchedTrace trace;
+    initTrace(&trace);
+
+    printf("# process,algorithm,id,arrival,burst,priority,completion,turnaround,waiting\n");
+    printf("# segment,algorithm,pid,start,end\n");
+    printf("# summary,algorithm,processes,avg_waiting,avg_turnaround,segments,context_switches\n");
+    int ran = 0;
+    for (int a = 0; a < 6; a++)
+    {
+        if (!algoSelected(opt, names[a]))
+            continue;
+        ran++;
+        memcpy(working, original, n * sizeof(Process));
+
+        if (a == 0)
+            scheduleFCFS(working, n, &trace);
+        else if (a == 1)
+            scheduleSJF(working, n, &trace);
+        else if (a == 2)
+            scheduleSRTF(working, n, &trace);
+        else if (a == 3)
+            scheduleRoundRobin(working, n, opt->quantum, &trace);
+        else if (a == 4)
+            schedulePriority(working, n, opt->aging, &trace);
+        else
+            scheduleMLFQ(working, n, &opt->mlfq, &trace);
+
+        double sumWt = 0, sumTat = 0;
+        for (int i = 0; i < n; i++)
+        {
+            printf("process,%s,%d,%d,%d,%d,%d,%d,%d\n", labels[a], working[i].id, working[i].at,
+                   working[i].bt, working[i].pr, working[i].ct, working[i].tat, working[i].wt);
+            sumWt += working[i].wt;
+            sumTat += working[i].tat;
+        }
+        for (int i = 0; i < trace.count; i++)
+            printf("segment,%s,%d,%d,%d\n", labels[a], trace.segments[i].pid,
+                   trace.segments[i].startTime, trace.segments[i].endTime);
+        printf("summary,%s,%d,%.4f,%.4f,%d,%d\n", labels[a], n, sumWt / n, sumTat / n, trace.count,
+               trace.contextSwitches);
+    }
+
+    freeTrace(&trace);
+    free(original);
+    free(working);
+    return ran ? 0 : inputError("cpu", "unknown --algo (use fcfs, sjf, srtf, rr, priority, mlfq or all)");
+}
+
+static int batchMemory(IntReader *in, const BatchOptions *opt)
+{
+    int blocks, processes;
+    int *bSize = readIntArray(in, &blocks);
+    if (bSize == NULL)
+        return inputError("memory", "expected block count followed by block sizes");
+    int *pSize = readIntArray(in, &processes);
+    if (pSize == NULL)
+    {
+        free(bSize);
+        return inputError("memory", "expected process count followed by process sizes");
+    }
+
+    const char *names[] = {"best", "first", "worst"};
+    const char *labels[] = {"BEST", "FIRST", "WORST"};
+    int *allocation = safeMalloc(processes * sizeof(int));
+
+    printf("# allocation,strategy,process,size,block,internal_frag\n");
+    printf("# summary,strategy,total_internal_frag,unallocated\n");
+    int ran = 0;
+    for (int t = 0; t < 3; t++)
+    {
+        if (!algoSelected(opt, names[t]))
+            continue;
+        ran++;
+        allocateMemory(t + 1, blocks, bSize, processes, pSize, allocation);
+
+        long totalFrag = 0;
+        int unallocated = 0;
+        for (int i = 0; i < processes; i++)
+        {
+            if (allocation[i] == -1)
+            {
+                unallocated++;
+                printf("allocation,%s,%d,%d,-1,-1\n", labels[t], i + 1, pSize[i]);
+                continue;
+            }
+            int frag = bSize[allocation[i]] - pSize[i];
+            totalFrag += frag;
+            printf("allocation,%s,%d,%d,%d,%d\n", labels[t], i + 1, pSize[i], allocation[i] + 1, frag);
+        }
+        printf("summary,%s,%ld,%d\n", labels[t], totalFrag, unallocated);
+    }
+
+    free(allocation);
+    free(bSize);
+    free(pSize);
+    return ran ? 0 : inputError("memory", "unknown --algo (use best, first, worst or all)");
+}
+
+static int batchHeap(IntReader *in, const BatchOptions *opt)
+{
+    int arenaSize;
+    if (!readInt(in, &arenaSize))
+        return inputError("heap", "expected the arena size");
+
+    // Events: "1 id size" allocates, "2 id" frees, until end of input
+    int count = 0, capacity = 1024, op, id, size;
+    HeapEvent *events = safeMalloc(capacity * sizeof(HeapEvent));
+    while (readInt(in, &op) && readInt(in, &id))
+    {
+        size = 0;
+        if (op == HEAP_ALLOC && !readInt(in, &size))
+            break;
+        if (count == capacity)
+        {
+            HeapEvent *grown = safeMalloc(2 * capacity * sizeof(HeapEvent));
+            memcpy(grown, events, count * sizeof(HeapEvent));
+            free(events);
+            events = grown;
+            capacity *= 2;
+        }
+        events[count].op = op;
+        events[count].id = id;
+        events[count].size = size;
+        count++;
+    }
+
+    const char *names[] = {"best", "first", "worst", "buddy", "slab"};
+    const char *labels[] = {"BEST", "FIRST", "WORST", "BUDDY", "SLAB"};
+    printf("# heap_event,engine,event,op,ok,offset,allocated,free,largest_free,free_regions,ext_frag,latency_ns\n");
+    printf("# heap_summary,engine,events,allocs,frees,failures,peak_allocated,internal_frag,ext_frag,"
+           "largest_free,metadata_bytes,avg_latency_ns,max_latency_ns,ops_per_sec\n");
+    if (opt->compact != COMPACT_NONE)
+        printf("# heap_compaction,engine,policy,compactions,rescued,bytes_moved,blocks_moved,avg_load,compaction_ns\n");
+    int ran = 0;
+    for (int e = 0; e < ENGINE_COUNT; e++)
+    {
+        if (!algoSelected(opt, names[e]))
+            continue;
+        Allocator allocator;
+        if (!createAllocator((AllocatorEngine)(e + 1), arenaSize, &allocator))
+        {
+            free(events);
+            return inputError("heap", "arena too small");
+        }
+        ran++;
+        HeapReplay replay;
+        initHeapReplay(&replay, allocator);
+        replay.compaction = opt->compact;
+        HeapSample s;
+        for (int i = 0; i < count; i++)
+        {
+            bool sampled = opt->sampleEvery > 0 && (i + 1) % opt->sampleEvery == 0;
+            applyHeapEvent(&replay, &events[i], sampled ? &s : NULL);
+            if (sampled)
+                printf("heap_event,%s,%lld,%s,%d,%lld,%lld,%lld,%lld,%lld,%.4f,%lld\n", labels[e], s.event,
+                       (s.op == HEAP_ALLOC) ? "alloc" : "free", s.ok, s.offset, s.blockBytes, s.freeBytes,
+                       s.largestHole, s.holes, s.externalFrag, s.latencyNs);
+        }
+        AllocatorStats st;
+        allocator.ops->stats(allocator.self, &st);
+        printf("heap_summary,%s,%lld,%lld,%lld,%lld,%lld,%lld,%.4f,%lld,%lld,%.1f,%lld,%.0f\n", labels[e],
+               replay.events, st.allocs, st.frees, st.failures, st.peakBlockBytes,
+               st.blockBytes - replay.requestedBytes, externalFragmentation(&st), st.largestFree, st.metadataBytes,
+               count ? (double)replay.totalLatencyNs / count : 0.0, replay.maxLatencyNs,
+               replay.totalLatencyNs ? replay.events * 1e9 / replay.totalLatencyNs : 0.0);
+        if (opt->compact != COMPACT_NONE && allocator.ops->compact != NULL)
+            printf("heap_compaction,%s,%s,%lld,%lld,%lld,%lld,%.4f,%lld\n", labels[e], compactionName(opt->compact),
+                   replay.compactions, replay.rescued, replay.bytesMoved, replay.blocksMoved,
+                   replay.compactions ? replay.loadAtCompaction / replay.compactions : 0.0, replay.compactionNs);
+        freeHeapReplay(&replay);
+        destroyAllocator(&allocator);
+    }
+    free(events);
+    return ran ? 0 : inputError("heap", "unknown --algo (use best, first, worst, buddy, slab or all)");
+}
+
+// Streams an allocation trace (never held in memory) through the engines
+// and the system malloc; with --output it converts the trace to binary instead
+static int batchTrace(IntReader *in, const BatchOptions *opt)
+{
+    (void)in;
+    char error[160];
+    if (opt->output != NULL)
+    {
+        long long events;
+        if (!convertAllocTrace(opt->input, opt->output, &events, error, sizeof(error)))
+            return inputError("trace", error);
+        fprintf(stderr, "wrote %lld events to %s\n", events, opt->output);
+        return 0;
+    }
+
+    const char *names[] = {"best", "first", "worst", "buddy", "slab"};
+    unsigned mask = 0;
+    for (int e = 0; e < ENGINE_COUNT; e++)
+        if (algoSelected(opt, names[e]))
+            mask |= 1u << e;
+    bool withMalloc = algoSelected(opt, "malloc");
+    if (mask == 0 && !withMalloc)
+        return inputError("trace", "unknown --algo (use best, first, worst, buddy, slab, malloc or all)");
+
+    TraceBenchResult results[BENCH_COUNT];
+    int count = benchmarkTrace(opt->input, opt->arenaSize, mask, withMalloc, results, error, sizeof(error));
+    if (count < 0)
+        return inputError("trace", error);
+
+    printf("# trace_bench,engine,events,allocs,frees,failures,ns_per_op,peak_bytes,peak_internal,"
+           "peak_metadata_bytes,mean_ext_frag,max_ext_frag\n");
+    for (int i = 0; i < count; i++)
+    {
+        const TraceBenchResult *r = &results[i];
+        printf("trace_bench,%s,%lld,%lld,%lld,%lld,%.2f,%lld,%lld,%lld,%.4f,%.4f\n", r->name, r->events, r->allocs,
+               r->frees, r->failures, r->events ? (double)r->elapsedNs / r->events : 0.0, r->peakBytes,
+               r->peakInternal, r->peakMetadataBytes, r->meanExternalFrag, r->maxExternalFrag);
+    }
+    return 0;
+}
+
+static int batchBankers(IntReader *in, const BatchOptions *opt)
+{
+    (void)opt;
+    int n, m;
+    if (!readInt(in, &n) || !readInt(in, &m) || n <= 0 || m <= 0)
+        return inputError("bankers", "expected process and resource counts");
+
+    int (*alloc)[m] = safeMalloc(sizeof(int[n][m]));
+    int (*need)[m] = safeMalloc(sizeof(int[n][m]));
+    int *work = safeMalloc(m * sizeof(int));
+    int *safeSeq = safeMalloc(n * sizeof(int));
+    bool ok = true;
+
+    for (int i = 0; i < n && ok; i++)
+        for (int j = 0; j < m && ok; j++)
+            ok = readInt(in, &alloc[i][j]);
+    for (int i = 0; i < n && ok; i++)
+        for (int j = 0; j < m && ok; j++)
+        {
+            int max;
+            ok = readInt(in, &max);
+            need[i][j] = max - alloc[i][j];
+        }
+    for (int j = 0; j < m && ok; j++)
+        ok = readInt(in, &work[j]);
+
+    int status = 0;
+    if (!ok)
+        status = inputError("bankers", "expected Allocation, Max and Available values");
+    else
+    {
+        bool safe = findSafeSequence(n, m, alloc, need, work, safeSeq);
+        printf("# summary,bankers,processes,resources,safe\n");
+        printf("summary,bankers,%d,%d,%d\n", n, m, safe);
+        if (safe)
+        {
+            printf("# sequence,position,process\n");
+            for (int i = 0; i < n; i++)
+                printf("sequence,%d,%d\n", i + 1, safeSeq[i]);
+        }
+    }
+
+    free(alloc);
+    free(need);
+    free(work);
+    free(safeSeq);
+    return status;
+}
+
+static int batchDisk(IntReader *in, const BatchOptions *opt)
+{
+    int head, n;
+    if (!readInt(in, &head))
+        return inputError("disk", "expected the head position");
+    int *values = readIntArray(in, &n);
+    if (values == NULL)
+        return inputError("disk", "expected request count followed by requests");
+    long long *req = safeMalloc((n > 0 ? n : 1) * sizeof(long long));
+    long long highest = head;
+    for (int i = 0; i < n; i++)
+    {
+        req[i] = values[i];
+        if (req[i] > highest)
+            highest = req[i];
+    }
+    free(values);
+
+    // Without --cylinders the disk ends just past the highest cylinder in use
+    DiskConfig cfg = opt->disk;
+    if (cfg.cylinders <= 0)
+        cfg.cylinders = highest + 1;
+    char error[160];
+    if (!checkDiskRequests(head, &cfg, req, n, error, sizeof(error)))
+    {
+        free(req);
+        return inputError("disk", error);
+    }
+
+    const char *names[] = {"fcfs", "sstf", "scan", "cscan", "look", "clook"};
+    int *order = safeMalloc((n > 0 ? n : 1) * sizeof(int));
+    long long *travel = safeMalloc((n > 0 ? n : 1) * sizeof(long long));
+    DeviceConfig hdd, ssd;
+    defaultDeviceConfig(&hdd, DEVICE_HDD);
+    defaultDeviceConfig(&ssd, DEVICE_SSD);
+    bool any = false;
+    if (opt->sampleEvery > 0)
+        printf("# order,policy,position,request,cylinder\n");
+    for (int policy = DISK_FCFS; policy <= DISK_POLICY_COUNT; policy++)
+    {
+        if (!algoSelected(opt, names[policy - 1]))
+            continue;
+        if (!any)
+            printf("# summary,policy,head,requests,total_seek,avg_seek,ms,requests_per_sec,hdd_us,ssd_us\n");
+        any = true;
+        long long start = monotonicNanos();
+        long long seek = scheduleDisk((DiskPolicy)policy, head, &cfg, req, n, order, travel);
+        long long elapsed = monotonicNanos() - start;
+        for (int i = opt->sampleEvery - 1; opt->sampleEvery > 0 && i < n; i += opt->sampleEvery)
+            printf("order,%s,%d,%d,%lld\n", diskPolicyName((DiskPolicy)policy), i + 1, order[i], req[order[i]]);
+        printf("summary,%s,%d,%d,%lld,%.3f,%.3f,%.0f,%lld,%lld\n", diskPolicyName((DiskPolicy)policy), head, n, seek,
+               n ? (double)seek / n : 0.0, elapsed / 1e6, elapsed ? 1e9 * n / elapsed : 0.0,
+               timeDiskOrder(&hdd, &cfg, req, order, travel, n, error, sizeof(error)),
+               timeDiskOrder(&ssd, &cfg, req, order, travel, n, error, sizeof(error)));
+    }
+    free(order);
+    free(travel);
+    free(req);
+    if (!any)
+        return inputError("disk", "unknown --algo (use fcfs, sstf, scan, cscan, look, clook or all)");
+    return 0;
+}
+
+// Columns after the row kind ("timed" or "replay")
+#define TIMED_CSV_COLUMNS \
+    "device,policy,requests,mean_us,p50_us,p99_us,p999_us,max_us,with_deadline,missed,worst_process_mean_us," \
+    "total_seek,iops,ms,peak_queued,plug_us,dispatched,merge_rate,batches,mean_batch,max_batch"
+
+#define STAGING_CSV_COLUMNS \
+    "device,policy,plug_us,merge_rate,mean_batch,seek_unplugged,seek,seek_change_pct,iops_unplugged,iops,iops_change_pct"
+
+static double timedIops(const TimedDiskResult *r)
+{
+    return r->makespanUs ? 1e6 * r->requests / r->makespanUs : 0.0;
+}
+
+static double mergeRate(const TimedDiskResult *r)
+{
+    return r->requests ? (double)(r->requests - r->dispatched) / r->requests : 0.0;
+}
+
+static double meanBatch(const TimedDiskResult *r)
+{
+    return r->batches ? (double)r->dispatched / r->batches : 0.0;
+}
+
+static void printTimedRow(const char *kind, DeviceKind device, long long plugUs, const TimedDiskResult *r)
+{
+    const LatencyHistogram *h = &r->latency;
+    printf("%s,%s,%s,%lld,%.1f,%lld,%lld,%lld,%lld,%lld,%lld,%.1f,%lld,%.1f,%.3f,%lld,%lld,%lld,%.4f,%lld,%.2f,%lld\n",
+           kind, deviceKindName(device), diskPolicyName(r->policy), r->requests, h->total ? h->sum / h->total : 0.0,
+           latencyPercentile(h, 0.5), latencyPercentile(h, 0.99), latencyPercentile(h, 0.999), h->max,
+           r->withDeadline, r->missed, r->worstProcessMeanUs, r->seek, timedIops(r), r->elapsedNs / 1e6,
+           r->peakQueued, plugUs, r->dispatched, mergeRate(r), r->batches, meanBatch(r), r->largestBatch);
+}
+
+// What the plug did to one policy: the same run without staging next to the run with it
+static void printStagingRow(DeviceKind device, long long plugUs, const TimedDiskResult *base, const TimedDiskResult *r)
+{
+    printf("staging,%s,%s,%lld,%.4f,%.2f,%lld,%lld,%.2f,%.1f,%.1f,%.2f\n", deviceKindName(device),
+           diskPolicyName(r->policy), plugUs, mergeRate(r), meanBatch(r), base->seek, r->seek,
+           base->seek ? 100.0 * (r->seek - base->seek) / base->seek : 0.0, timedIops(base), timedIops(r),
+           timedIops(base) > 0 ? 100.0 * (timedIops(r) - timedIops(base)) / timedIops(base) : 0.0);
+}
+
+// Requests arriving over time: n, then n x (arrival_us cylinder op process deadline_us), or --generate N
+static int batchDiskTimed(IntReader *in, const BatchOptions *opt)
+{
+    TimedDiskConfig cfg;
+    defaultTimedDiskConfig(&cfg, DEVICE_HDD);
+    cfg.disk = opt->disk;
+    IoRequest *req;
+    int n;
+    if (opt->generate)
+    {
+        if (cfg.disk.cylinders <= 0)
+            cfg.disk.cylinders = 200;
+        IoWorkloadConfig w = opt->io;
+        w.count = opt->gen.count;
+        w.seed = opt->gen.seed;
+        if (w.count < 1 || w.count > INT_MAX || w.meanInterarrivalUs <= 0 || w.processes < 1)
+            return inputError("disktimed", "--generate needs a count, a positive --interarrival and --processes");
+        n = (int)w.count;
+        req = safeMalloc((size_t)n * sizeof(IoRequest));
+        generateIoWorkload(&w, cfg.disk.cylinders, sectorsPerCylinder(&cfg.device), req);
+    }
+    else
+    {
+        if (!readInt(in, &n) || n < 0)
+            return inputError("disktimed", "expected the request count");
+        req = safeMalloc((n > 0 ? n : 1) * sizeof(IoRequest));
+        long long highest = 0;
+        for (int i = 0; i < n; i++)
+        {
+            int arrival, cylinder, op, process, deadline;
+            if (!readInt(in, &arrival) || !readInt(in, &cylinder) || !readInt(in, &op) || !readInt(in, &process) ||
+                !readInt(in, &deadline))
+            {
+                free(req);
+                return inputError("disktimed", "expected arrival_us cylinder op(0=read,1=write) process deadline_us");
+            }
+            req[i].arrival = arrival;
+            req[i].cylinder = cylinder;
+            req[i].op = (IoOp)op;
+            req[i].process = process;
+            req[i].deadline = deadline;
+            req[i].sector = 0;
+            req[i].length = 1;
+            if (cylinder > highest)
+                highest = cylinder;
+        }
+        if (cfg.disk.cylinders <= 0)
+            cfg.disk.cylinders = highest + 1;
+    }
+
+    // With --plug every policy also runs unstaged, and a staging row compares the two
+    const char *names[] = {"fcfs", "sstf", "scan", "cscan", "look", "clook", "deadline", "budget"};
+    char error[160];
+    bool any = false;
+    IoStagingConfig staged = opt->staging;
+    cfg.staging = staged;
+    cfg.staging.plugUs = 0;
+    for (int kind = DEVICE_LINEAR; kind <= DEVICE_KIND_COUNT; kind++)
+    {
+        if (opt->device != 0 && kind != opt->device)
+            continue;
+        defaultDeviceConfig(&cfg.device, (DeviceKind)kind);
+        for (int policy = DISK_FCFS; policy <= DISK_TIMED_POLICY_COUNT; policy++)
+        {
+            if (!algoSelected(opt, names[policy - 1]))
+                continue;
+            TimedDiskResult r, plugged;
+            TimedDiskConfig plugCfg = cfg;
+            plugCfg.staging = staged;
+            if (!simulateTimedDisk((DiskPolicy)policy, &cfg, 0, req, n, &r, error, sizeof(error)) ||
+                (staged.plugUs > 0 &&
+                 !simulateTimedDisk((DiskPolicy)policy, &plugCfg, 0, req, n, &plugged, error, sizeof(error))))
+            {
+                free(req);
+                return inputError("disktimed", error);
+            }
+            if (!any)
+            {
+                printf("# timed,%s\n", TIMED_CSV_COLUMNS);
+                if (staged.plugUs > 0)
+                    printf("# staging,%s\n", STAGING_CSV_COLUMNS);
+            }
+            any = true;
+            printTimedRow("timed", (DeviceKind)kind, 0, &r);
+            if (staged.plugUs > 0)
+            {
+                printTimedRow("timed", (DeviceKind)kind, staged.plugUs, &plugged);
+                printStagingRow((DeviceKind)kind, staged.plugUs, &r, &plugged);
+            }
+        }
+    }
+    free(req);
+    if (!any)
+        return inputError("disktimed", "unknown --algo (use fcfs, sstf, scan, cscan, look, clook, deadline, budget or all)");
+    return 0;
+}
+
+// Streams a block I/O trace through the timed policies; --output converts it to binary instead
+static int batchBlockTrace(IntReader *in, const BatchOptions *opt)
+{
+    (void)in;
+    char error[160];
+    if (opt->output != NULL)
+    {
+        long long ios;
+        if (!convertBlockTrace(opt->input, opt->output, &ios, error, sizeof(error)))
+            return inputError("blocktrace", error);
+        fprintf(stderr, "wrote %lld I/Os to %s\n", ios, opt->output);
+        return 0;
+    }
+
+    const char *names[] = {"fcfs", "sstf", "scan", "cscan", "look", "clook", "deadline", "budget"};
+    unsigned mask = 0;
+    for (int policy = DISK_FCFS; policy <= DISK_TIMED_POLICY_COUNT; policy++)
+        if (algoSelected(opt, names[policy - 1]))
+            mask |= 1u << (policy - 1);
+    if (mask == 0)
+        return inputError("blocktrace", "unknown --algo (use fcfs, sstf, scan, cscan, look, clook, deadline, budget or all)");
+
+    // Without --cylinders the disk holds about 1 TiB of 4 KiB blocks
+    TimedDiskConfig cfg;
+    defaultTimedDiskConfig(&cfg, DEVICE_HDD);
+    cfg.disk = opt->disk;
+    if (cfg.disk.cylinders <= 0)
+        cfg.disk.cylinders = DEFAULT_TRACE_CYLINDERS;
+    BlockReplayConfig replay = opt->replay;
+    replay.readDeadlineUs = opt->io.readDeadlineUs;
+    cfg.staging = opt->staging;
+
+    // One pass over the trace per device, plus an unstaged one with --plug; each pass feeds every selected policy
+    TimedDiskResult results[DISK_TIMED_POLICY_COUNT], unplugged[DISK_TIMED_POLICY_COUNT];
+    bool fromStdin = (opt->input == NULL || strcmp(opt->input, "-") == 0);
+    if (opt->device == 0 && fromStdin)
+        return inputError("blocktrace", "--device all reads the trace once per device; pass it with --input FILE");
+    if (opt->staging.plugUs > 0 && fromStdin)
+        return inputError("blocktrace", "--plug compares against a pass without staging; pass the trace with --input FILE");
+    bool any = false;
+    for (int kind = DEVICE_LINEAR; kind <= DEVICE_KIND_COUNT; kind++)
+    {
+        if (opt->device != 0 && kind != opt->device)
+            continue;
+        defaultDeviceConfig(&cfg.device, (DeviceKind)kind);
+        TimedDiskConfig baseCfg = cfg;
+        baseCfg.staging.plugUs = 0;
+        int count = replayBlockTrace(opt->input, &baseCfg, &replay, mask, unplugged, error, sizeof(error));
+        if (count >= 0 && opt->staging.plugUs > 0)
+            count = replayBlockTrace(opt->input, &cfg, &replay, mask, results, error, sizeof(error));
+        if (count < 0)
+            return inputError("blocktrace", error);
+        if (!any)
+        {
+            printf("# replay,%s\n", TIMED_CSV_COLUMNS);
+            if (opt->staging.plugUs > 0)
+                printf("# staging,%s\n", STAGING_CSV_COLUMNS);
+        }
+        any = true;
+        for (int i = 0; i < count; i++)
+        {
+            printTimedRow("replay", (DeviceKind)kind, 0, &unplugged[i]);
+            if (opt->staging.plugUs > 0)
+            {
+                printTimedRow("replay", (DeviceKind)kind, opt->staging.plugUs, &results[i]);
+                printStagingRow((DeviceKind)kind, opt->staging.plugUs, &unplugged[i], &results[i]);
+            }
+        }
+    }
+    return 0;
+}
+
+// Streams a memory reference trace through the replacement policies; --output converts it instead
+static int batchPageTrace(IntReader *in, const BatchOptions *opt)
+{
+    (void)in;
+    char error[160];
+    if (opt->output != NULL)
+    {
+        long long refs;
+        if (!convertPageTrace(opt->input, opt->output, !opt->dataOnly, &refs, error, sizeof(error)))
+            return inputError("pagetrace", error);
+        fprintf(stderr, "wrote %lld references to %s\n", refs, opt->output);
+        return 0;
+    }
+
+    const char *names[] = {"fifo", "lru", "lfu", "clock", "opt", "arc", "2q", "clockpro"};
+    unsigned mask = 0;
+    for (int policy = PAGE_FIFO; policy <= PAGE_POLICY_COUNT; policy++)
+        if (policy != PAGE_OPT && algoSelected(opt, names[policy - 1]))
+            mask |= 1u << (policy - 1);
+    if (mask == 0)
+        return inputError("pagetrace", "unknown --algo (use fifo, lru, lfu, clock, arc, 2q, clockpro or all)");
+
+    PageTraceResult results[PAGE_POLICY_COUNT];
+    int count = replayPageTrace(opt->input, opt->pageSize, !opt->dataOnly, opt->frames, mask, results, error,
+                                sizeof(error));
+    if (count < 0)
+        return inputError("pagetrace", error);
+
+    printf("# page_trace,policy,frames,page_size,references,faults,hit_ratio,ns_per_ref,metadata_bytes\n");
+    for (int i = 0; i < count; i++)
+    {
+        const PageTraceResult *r = &results[i];
+        printf("page_trace,%s,%d,%lld,%lld,%lld,%.6f,%.2f,%zu\n", pagePolicyName(r->policy), opt->frames,
+               opt->pageSize, r->refs, r->faults, r->refs ? (double)(r->refs - r->faults) / r->refs : 0.0,
+               r->refs ? (double)r->elapsedNs / r->refs : 0.0, r->metadataBytes);
+    }
+    return 0;
+}
+
+// Translates a streamed address trace through the page table and TLB, once per selected policy
+static int batchVirtualMemory(IntReader *in, const BatchOptions *opt)
+{
+    (void)in;
+    VmConfig base = opt->vm;
+    base.pageShift = 0;
+    while (base.pageShift < 62 && (1LL << base.pageShift) < opt->pageSize)
+        base.pageShift++;
+    if (opt->pageSize < 1 || (1LL << base.pageShift) != opt->pageSize)
+        return inputError("vm", "--page-size must be a power of two");
+
+    // Base pages for every selected policy, then the same with huge pages under --huge
+    const char *names[] = {"fifo", "lru", "lfu", "clock", "opt", "arc", "2q", "clockpro"};
+    VmConfig cfgs[2 * PAGE_POLICY_COUNT];
+    int count = 0;
+    for (int huge = 0; huge <= (opt->vm.hugePages ? 1 : 0); huge++)
+        for (int policy = PAGE_FIFO; policy <= PAGE_POLICY_COUNT; policy++)
+            if (policy != PAGE_OPT && algoSelected(opt, names[policy - 1]))
+            {
+                cfgs[count] = base;
+                cfgs[count].policy = (PagePolicy)policy;
+                cfgs[count++].hugePages = (huge == 1);
+            }
+    if (count == 0)
+        return inputError("vm", "unknown --algo (use fifo, lru, lfu, clock, arc, 2q, clockpro or all)");
+
+    VmStats stats[2 * PAGE_POLICY_COUNT];
+    size_t tables[2 * PAGE_POLICY_COUNT];
+    char error[160];
+    if (!replayVmTrace(opt->input, !opt->dataOnly, cfgs, count, stats, tables, error, sizeof(error)))
+        return inputError("vm", error);
+
+    printf("# vm,policy,page_size,levels,tlb_entries,memory,translations,tlb_hit_ratio,avg_walk_depth,faults,"
+           "evictions,translations_per_sec,page_table_bytes\n");
+    for (int i = 0; i < count; i++)
+    {
+        const VmConfig *c = &cfgs[i];
+        const VmStats *r = &stats[i];
+        printf("vm,%s,%lld,%d,%d,%lld,%lld,%.6f,%.3f,%lld,%lld,%.0f,%zu\n", pagePolicyName(c->policy),
+               1LL << (c->pageShift + (c->hugePages ? c->bitsPerLevel : 0)), c->levels, c->tlbSets * c->tlbWays,
+               c->memoryBytes, r->translations, r->translations ? (double)r->tlbHits / r->translations : 0.0,
+               r->walks ? (double)r->walkSteps / r->walks : 0.0, r->faults, r->evictions,
+               r->elapsedNs ? 1e9 * r->translations / r->elapsedNs : 0.0, tables[i]);
+    }
+    return 0;
+}
+
+// Every policy over the synthetic patterns, plus --input as a streamed trace when given
+static int batchPageBench(IntReader *in, const BatchOptions *opt)
+{
+    (void)in;
+    int count;
+    char error[160];
+    PageBenchRow *rows = runPageBenchmark(opt->frames, opt->refs, opt->gen.seed, opt->input, opt->pageSize,
+                                          !opt->dataOnly, &count, error, sizeof(error));
+    if (rows == NULL)
+        return inputError("pagebench", error);
+
+    printf("# page_bench,workload,policy,frames,references,faults,hit_ratio,ns_per_ref,metadata_bytes_per_frame\n");
+    for (int i = 0; i < count; i++)
+    {
+        const PageBenchRow *r = &rows[i];
+        printf("page_bench,%s,%s,%d,%lld,%lld,%.6f,%.2f,%.2f\n", r->workload, pagePolicyName(r->policy),
+               opt->frames, r->refs, r->faults, r->refs ? (double)(r->refs - r->faults) / r->refs : 0.0,
+               r->refs ? (double)r->elapsedNs / r->refs : 0.0, (double)r->metadataBytes / opt->frames);
+    }
+    free(rows);
+    return 0;
+}
+
+// Faults for every frame count 1..maxFrames: LRU and OPT in one pass, FIFO swept in parallel
+static void batchFaultCurves(const long long refs[], int count, int maxFrames, int threads)
+{
+    FaultCurve curves[3];
+    long long elapsed[3];
+    for (int i = 0; i < 3; i++)
+    {
+        long long start = monotonicNanos();
+        if (i == 0)
+            fifoFaultSweep(refs, count, maxFrames, threads, &curves[i]);
+        else
+            stackFaultCurve(i == 1 ? PAGE_LRU : PAGE_OPT, refs, count, maxFrames, &curves[i]);
+        elapsed[i] = monotonicNanos() - start;
+    }
+
+    printf("# curve,policy,frames,faults\n");
+    for (int i = 0; i < 3; i++)
+        for (int f = 1; f <= maxFrames; f++)
+            printf("curve,%s,%d,%lld\n", pagePolicyName(curves[i].policy), f, curves[i].faults[f]);
+
+    int total = beladyAnomalies(&curves[0], NULL, 0);
+    int *frames = safeMalloc((total > 0 ? total : 1) * sizeof(int));
+    beladyAnomalies(&curves[0], frames, total);
+    printf("# anomaly,policy,frames,faults,faults_with_one_more_frame\n");
+    for (int i = 0; i < total; i++)
+        printf("anomaly,FIFO,%d,%lld,%lld\n", frames[i], curves[0].faults[frames[i]],
+               curves[0].faults[frames[i] + 1]);
+    free(frames);
+
+    printf("# curve_summary,policy,references,distinct_pages,max_frames,ms\n");
+    for (int i = 0; i < 3; i++)
+    {
+        printf("curve_summary,%s,%d,%lld,%d,%.3f\n", pagePolicyName(curves[i].policy), count, curves[i].cold,
+               maxFrames, elapsed[i] / 1e6);
+        freeFaultCurve(&curves[i]);
+    }
+}
+
+static int batchPage(IntReader *in, const BatchOptions *opt)
+{
+    int frameCount, count;
+    if (!readInt(in, &frameCount) || frameCount <= 0)
+        return inputError("page", "expected a positive frame count");
+    int *values = readIntArray(in, &count);
+    if (values == NULL)
+        return inputError("page", "expected sequence size followed by the sequence");
+    long long *refs = safeMalloc((count > 0 ? count : 1) * sizeof(long long));
+    for (int i = 0; i < count; i++)
+        refs[i] = values[i];
+    free(values);
+
+    if (opt->algo != NULL && strcmp(opt->algo, "curve") == 0)
+    {
+        batchFaultCurves(refs, count, frameCount, opt->threads);
+        free(refs);
+        return 0;
+    }
+
+    const char *names[] = {"fifo", "lru", "lfu", "clock", "opt", "arc", "2q", "clockpro"};
+    printf("# summary,policy,frames,references,faults,hits\n");
+    int ran = 0;
+    for (int policy = PAGE_FIFO; policy <= PAGE_POLICY_COUNT; policy++)
+    {
+        PageReplacer r;
+        if (!algoSelected(opt, names[policy - 1]) || !createPageReplacer((PagePolicy)policy, frameCount, refs, count, &r))
+            continue;
+        ran++;
+        long long evicted;
+        for (int i = 0; i < count; i++)
+            pageAccess(&r, refs[i], &evicted);
+        printf("summary,%s,%d,%d,%lld,%lld\n", pagePolicyName((PagePolicy)policy), frameCount, count, r.faults,
+               r.hits);
+        destroyPageReplacer(&r);
+    }
+    free(refs);
+    return ran ? 0 : inputError("page", "unknown --algo (use fifo, lru, lfu, clock, opt, arc, 2q, clockpro, curve or all)");
+}
+
+// Writes a synthetic workload: binary to --output, or cpu-module text to stdout
+static int batchGenerate(IntReader *in, const BatchOptions *opt)
+{
+    (void)in;
+    char error[128];
+    if (!validateWorkloadConfig(&opt->gen, error, sizeof(error)))
+        return inputError("gen", error);
+
+    if (opt->output != NULL)
+    {
+        if (!saveWorkload(opt->output, &opt->gen))
+            return inputError("gen", "cannot write the output file");
+        fprintf(stderr, "wrote %ld processes to %s\n", opt->gen.count, opt->output);
+        return 0;
+    }
+
+    Process *p = generateWorkload(&opt->gen);
+    printf("%ld\n", opt->gen.count);
+    for (long i = 0; i < opt->gen.count; i++)
+        printf("%d %d %d\n", p[i].bt, p[i].at, p[i].pr);
+    free(p);
+    return 0;
+}
+
+static int batchRace(IntReader *in, const BatchOptions *opt)
+{
+    (void)in;
+    (void)opt;
+    int initial = 100;
+    printf("# summary,race,initial,final,expected\n");
+    printf("summary,race,%d,%d,%d\n", initial, simulateLostUpdate(initial), initial + 2);
+    return 0;
+}
+
+static int batchReaderWriter(IntReader *in, const BatchOptions *opt)
+{
+    (void)opt;
+    RWState state;
+    char msg[256];
+    int action, step = 0;
+    initRWState(&state);
+
+    printf("# step,index,action,accepted,readers,writer_active,mutex,wrt\n");
+    while (readInt(in, &action))
+    {
+        bool accepted = applyRWAction(&state, action, msg);
+        printf("step,%d,%d,%d,%d,%d,%d,%d\n", ++step, action, accepted, state.read_count,
+               state.wrt == 0 && state.read_count == 0, state.mutex, state.wrt);
+    }
+    return 0;
+}
+
+static int batchDining(IntReader *in, const BatchOptions *opt)
+{
+    (void)opt;
+    char msg[256];
+    int p_id, action, step = 0;
+    initDining();
+
+    printf("# step,index,philosopher,action,accepted,deadlock,state0,state1,state2,state3,state4\n");
+    while (readInt(in, &p_id) && readInt(in, &action))
+    {
+        bool accepted = applyDiningAction(p_id, action, msg);
+        printf("step,%d,%d,%d,%d,%d", ++step, p_id, action, accepted, isDiningDeadlocked());
+        for (int i = 0; i < 5; i++)
+            printf(",%d", p_state[i]);
+        printf("\n");
+    }
+    return 0;
+}
+
+static const BatchModule batchModules[] = {
+    {"cpu", true, batchCPU, "n, then n x (burst arrival priority); --algo fcfs|sjf|srtf|rr|priority|mlfq|all|compare|smp"},
+    {"memory", true, batchMemory, "blocks, block sizes, processes, process sizes; --algo best|first|worst|all"},
+    {"heap", true, batchHeap, "arena size, then events '1 id size' / '2 id'; --algo best|first|worst|buddy|slab|all"},
+    {"trace", false, batchTrace, "'a id size' / 'f id' lines or binary, streamed; --algo best|...|slab|malloc|all"},
+    {"bankers", true, batchBankers, "n m, Allocation (n*m), Max (n*m), Available (m)"},
+    {"disk", true, batchDisk, "head, request count, requests; --algo fcfs|sstf|scan|cscan|look|clook|all"},
+    {"disktimed", true, batchDiskTimed, "n, then n x (arrival_us cylinder op process deadline_us), or --generate N"},
+    {"blocktrace", false, batchBlockTrace, "\"timestamp_us sector length R|W [process]\" lines, or binary"},
+    {"page", true, batchPage, "frames, sequence size, sequence; --algo fifo|lru|...|arc|2q|clockpro|all|curve"},
+    {"pagetrace", false, batchPageTrace, "lackey or hex-address lines, or binary; --frames N --algo fifo|...|all"},
+    {"pagebench", false, batchPageBench, "(no input) loop/scan/zipf/phase patterns; --input adds a trace"},
+    {"vm", false, batchVirtualMemory, "address trace as in pagetrace; page table + TLB, --algo lru|...|all"},
+    {"race", false, batchRace, "(no input)"},
+    {"gen", false, batchGenerate, "(no input) synthetic CPU workload, text to stdout or binary to --output"},
+    {"rw", true, batchReaderWriter, "action codes 1-4 until end of input"},
+    {"dining", true, batchDining, "pairs of (philosopher 0-4, action 1-4) until end of input"},
+};
+
+#define BATCH_MODULE_COUNT (int)(sizeof(batchModules) / sizeof(batchModules[0]))
+
+static void printBatchUsage(const char *prog)
+{
+    fprintf(stderr, "Usage: %s --batch MODULE [--input FILE|-] [--algo NAME] [--quantum Q]\n", prog);
+    fprintf(stderr, "       [--qmin Q --qmax Q --qstep S] [--threads N]   (cpu --algo compare, page --algo curve)\n");
+    fprintf(stderr, "       [--aging T] [--levels L] [--boost T]         (cpu priority / mlfq)\n");
+    fprintf(stderr, "       [--cores N] [--local fcfs|rr] [--balance none|periodic|steal]\n");
+    fprintf(stderr, "       [--balance-interval T]                        (cpu --algo smp)\n");
+    fprintf(stderr, "       [--sample N] [--compact none|sliding|minmove] (heap: print every Nth event, compaction)\n");
+    fprintf(stderr, "       [--arena BYTES] [--output FILE]               (trace: arena size / convert to binary)\n");
+    fprintf(stderr, "       [--cylinders N] [--direction up|down] [--sample N] (disk: --sample 0 for summaries only)\n");
+    fprintf(stderr, "       [--generate N] [--interarrival US] [--processes P] [--writes PCT]\n");
+    fprintf(stderr, "       [--read-deadline US] [--seed S]               (disktimed: synthetic timed arrivals)\n");
+    fprintf(stderr, "       [--device linear|hdd|ssd|all]                 (disktimed, blocktrace: device model, default hdd)\n");
+    fprintf(stderr, "       [--outstanding N] [--time-scale X]            (blocktrace: as fast as possible / scaled time)\n");
+    fprintf(stderr, "       [--plug US] [--plug-limit N] [--merge-limit BLOCKS] (disktimed, blocktrace: merge and batch)\n");
+    fprintf(stderr, "       [--frames N] [--page-size BYTES] [--data-only] (pagetrace; --output converts to binary)\n");
+    fprintf(stderr, "       [--refs N] [--seed S]                         (pagebench: references per pattern)\n");
+    fprintf(stderr, "       [--pt-levels 2-4] [--pt-bits B] [--tlb-sets S] [--tlb-ways W]\n");
+    fprintf(stderr, "       [--memory BYTES] [--huge] [--page-size BYTES]  (vm: --huge adds huge-page rows)\n");
+    fprintf(stderr, "       [--generate N | --workload FILE]              (cpu: synthetic or binary input)\n");
+    fprintf(stderr, "       [--seed S] [--interarrival MEAN] [--burst-dist exp|pareto] [--burst-mean MEAN]\n");
+    fprintf(stderr, "       [--pareto-alpha A] [--prio-dist uniform|zipf] [--prio-levels L] [--zipf-s S]\n");
+    fprintf(stderr, "       [--output FILE]                               (gen: binary workload file)\n\n");
+    fprintf(stderr, "Reads the workload from FILE (default: stdin) and writes CSV to stdout.\n");
+    fprintf(stderr, "Modules and their input layout:\n");
+    for (int i = 0; i < BATCH_MODULE_COUNT; i++)
+        fprintf(stderr, "  %-9s %s\n", batchModules[i].name, batchModules[i].inputFormat);
+}
+
+int runBatchMode(int argc, char *argv[])
+{
+    BatchOptions opt = {NULL, NULL, NULL, 2, 1, 10, 1, 0, 1, 0, {3, 0, 0}, {4, 0, SMP_WORK_STEALING, 10},
+                        false, {0}, NULL, NULL, 64LL << 20, COMPACT_NONE, 64, DEFAULT_PAGE_SIZE, false,
+                        1000000, {0, true}, {0}, {0}, DEVICE_HDD, {1.0, 0, 0}, {0}};
+    defaultWorkloadConfig(&opt.gen);
+    defaultVmConfig(&opt.vm);
+    defaultIoWorkloadConfig(&opt.io);
+    defaultBlockReplayConfig(&opt.replay);
+    defaultIoStagingConfig(&opt.staging);
+    bool smpRoundRobin = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        bool hasValue = (i + 1 < argc);
+        if (strcmp(argv[i], "--batch") == 0 && hasValue)
+            opt.module = argv[++i];
+        else if (strcmp(argv[i], "--input") == 0 && hasValue)
+            opt.input = argv[++i];
+        else if (strcmp(argv[i], "--algo") == 0 && hasValue)
+            opt.algo = argv[++i];
+        else if (strcmp(argv[i], "--quantum") == 0 && hasValue)
+            opt.quantum = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--qmin") == 0 && hasValue)
+            opt.qMin = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--qmax") == 0 && hasValue)
+            opt.qMax = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--qstep") == 0 && hasValue)
+            opt.qStep = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0 && hasValue)
+            opt.threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--sample") == 0 && hasValue)
+            opt.sampleEvery = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--aging") == 0 && hasValue)
+            opt.aging = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--levels") == 0 && hasValue)
+            opt.mlfq.levels = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--boost") == 0 && hasValue)
+            opt.mlfq.boostInterval = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--cores") == 0 && hasValue)
+            opt.smp.cores = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--local") == 0 && hasValue)
+            smpRoundRobin = (strcmp(argv[++i], "rr") == 0);
+        else if (strcmp(argv[i], "--balance") == 0 && hasValue)
+        {
+            const char *mode = argv[++i];
+            opt.smp.balance = (strcmp(mode, "periodic") == 0) ? SMP_BALANCE_PERIODIC
+                              : (strcmp(mode, "none") == 0)   ? SMP_BALANCE_NONE
+                                                              : SMP_WORK_STEALING;
+        }
+        else if (strcmp(argv[i], "--balance-interval") == 0 && hasValue)
+            opt.smp.balanceInterval = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--generate") == 0 && hasValue)
+        {
+            opt.generate = true;
+            opt.gen.count = atol(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--count") == 0 && hasValue)
+            opt.gen.count = atol(argv[++i]);
+        else if (strcmp(argv[i], "--workload") == 0 && hasValue)
+            opt.workloadFile = argv[++i];
+        else if (strcmp(argv[i], "--output") == 0 && hasValue)
+            opt.output = argv[++i];
+        else if (strcmp(argv[i], "--compact") == 0 && hasValue)
+        {
+            const char *mode = argv[++i];
+            opt.compact = (strcmp(mode, "sliding") == 0)   ? COMPACT_SLIDING
+                          : (strcmp(mode, "minmove") == 0) ? COMPACT_MIN_MOVE
+                                                           : COMPACT_NONE;
+        }
+        else if (strcmp(argv[i], "--arena") == 0 && hasValue)
+            opt.arenaSize = atoll(argv[++i]);
+        else if (strcmp(argv[i], "--frames") == 0 && hasValue)
+            opt.frames = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--page-size") == 0 && hasValue)
+            opt.pageSize = atoll(argv[++i]);
+        else if (strcmp(argv[i], "--data-only") == 0)
+            opt.dataOnly = true;
+        else if (strcmp(argv[i], "--processes") == 0 && hasValue)
+            opt.io.processes = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--writes") == 0 && hasValue)
+            opt.io.writeFraction = atof(argv[++i]) / 100.0;
+        else if (strcmp(argv[i], "--read-deadline") == 0 && hasValue)
+            opt.io.readDeadlineUs = atoll(argv[++i]);
+        else if (strcmp(argv[i], "--cylinders") == 0 && hasValue)
+            opt.disk.cylinders = atoll(argv[++i]);
+        else if (strcmp(argv[i], "--direction") == 0 && hasValue)
+            opt.disk.up = (strcmp(argv[++i], "down") != 0);
+        else if (strcmp(argv[i], "--outstanding") == 0 && hasValue)
+            opt.replay.outstanding = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--time-scale") == 0 && hasValue)
+            opt.replay.timeScale = atof(argv[++i]);
+        else if (strcmp(argv[i], "--plug") == 0 && hasValue)
+            opt.staging.plugUs = atoll(argv[++i]);
+        else if (strcmp(argv[i], "--plug-limit") == 0 && hasValue)
+            opt.staging.plugLimit = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--merge-limit") == 0 && hasValue)
+            opt.staging.mergeLimit = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--device") == 0 && hasValue)
+        {
+            const char *model = argv[++i];
+            opt.device = (strcmp(model, "linear") == 0) ? DEVICE_LINEAR
+                         : (strcmp(model, "ssd") == 0)  ? DEVICE_SSD
+                         : (strcmp(model, "all") == 0)  ? 0
+                                                        : DEVICE_HDD;
+        }
+        else if (strcmp(argv[i], "--pt-levels") == 0 && hasValue)
+            opt.vm.levels = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--pt-bits") == 0 && hasValue)
+            opt.vm.bitsPerLevel = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--tlb-sets") == 0 && hasValue)
+            opt.vm.tlbSets = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--tlb-ways") == 0 && hasValue)
+            opt.vm.tlbWays = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--memory") == 0 && hasValue)
+            opt.vm.memoryBytes = atoll(argv[++i]);
+        else if (strcmp(argv[i], "--huge") == 0)
+            opt.vm.hugePages = true;
+        else if (strcmp(argv[i], "--refs") == 0 && hasValue)
+            opt.refs = atoll(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && hasValue)
+            opt.gen.seed = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--interarrival") == 0 && hasValue)
+        {
+            opt.gen.meanInterarrival = atof(argv[++i]);
+            opt.io.meanInterarrivalUs = opt.gen.meanInterarrival; // disktimed reads it in microseconds
+        }
+        else if (strcmp(argv[i], "--burst-mean") == 0 && hasValue)
+            opt.gen.meanBurst = atof(argv[++i]);
+        else if (strcmp(argv[i], "--burst-dist") == 0 && hasValue)
+            opt.gen.burstDist = (strcmp(argv[++i], "pareto") == 0) ? BURST_PARETO : BURST_EXPONENTIAL;
+        else if (strcmp(argv[i], "--pareto-alpha") == 0 && hasValue)
+            opt.gen.paretoAlpha = atof(argv[++i]);
+        else if (strcmp(argv[i], "--prio-dist") == 0 && hasValue)
+            opt.gen.priorityDist = (strcmp(argv[++i], "zipf") == 0) ? PRIORITY_ZIPF : PRIORITY_UNIFORM;
+        else if (strcmp(argv[i], "--prio-levels") == 0 && hasValue)
+            opt.gen.priorityLevels = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--zipf-s") == 0 && hasValue)
+            opt.gen.zipfExponent = atof(argv[++i]);
+        else
+        {
+            if (strcmp(argv[i], "--help") != 0)
+                fprintf(stderr, "Unknown or incomplete option: %s\n", argv[i]);
+            printBatchUsage(argv[0]);
+            return strcmp(argv[i], "--help") == 0 ? 0 : 2;
+        }
+    }
+
+    const BatchModule *module = NULL;
+    for (int i = 0; opt.module != NULL && i < BATCH_MODULE_COUNT; i++)
+        if (strcmp(batchModules[i].name, opt.module) == 0)
+            module = &batchModules[i];
+    if (module == NULL)
+    {
+        printBatchUsage(argv[0]);
+        return 2;
+    }
+    if (opt.quantum <= 0 || opt.qMin <= 0 || opt.qStep <= 0)
+    {
+        fprintf(stderr, "--quantum, --qmin and --qstep must be positive\n");
+        return 2;
+    }
+
+    if (opt.aging < 0 || opt.mlfq.boostInterval < 0 || opt.mlfq.levels < 1 || opt.mlfq.levels > PRIO_LEVELS)
+    {
+        fprintf(stderr, "--aging and --boost must be >= 0, --levels between 1 and %d\n", PRIO_LEVELS);
+        return 2;
+    }
+    opt.mlfq.baseQuantum = opt.quantum;
+    if (opt.smp.cores < 1 || opt.smp.cores > SMP_MAX_CORES || opt.smp.balanceInterval < 1)
+    {
+        fprintf(stderr, "--cores must be between 1 and %d, --balance-interval positive\n", SMP_MAX_CORES);
+        return 2;
+    }
+    opt.smp.quantum = smpRoundRobin ? opt.quantum : 0;
+
+    headlessMode = true;
+    IntReader in = {NULL, NULL, 0, 0};
+    if (module->needsInput && !openIntReader(&in, opt.input))
+    {
+        fprintf(stderr, "Cannot open input file: %s\n", opt.input);
+        return 1;
+    }
+
+    int status = module->run(&in, &opt);
+    fflush(stdout);
+    if (module->needsInput)
+        closeIntReader(&in);
+    return status;
+}
@@ -0,0 +1,33 @@
+#ifndef BATCH_MODE_H
+#define BATCH_MODE_H
+
+#include "utils.h"
+
+// --- Structures ---
+/**
+ * Buffered integer scanner for workload files. Anything that is not part of
+ * a number (spaces, commas, newlines) is treated as a separator, so the same
+ * layout typed into the interactive prompts can be fed from a file.
+ */
+typedef struct
+{
+    FILE *fp;
+    char *buf;
+    size_t len;
+    size_t pos;
+} IntReader;
+
+// --- Function Prototypes ---
+bool openIntReader(IntReader *r, const char *path);
+void closeIntReader(IntReader *r);
+bool readInt(IntReader *r, int *out);
+
+/**
+ * Entry point for the non-interactive mode, e.g.
+ *   ./simulator --batch cpu --algo all --input workload.txt
+ * Runs a module's algorithm with sleeps and screen clears disabled and
+ * writes CSV records to stdout. Returns the process exit status.
+ */
+int runBatchMode(int argc, char *argv[]);
+
+#endif
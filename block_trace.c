@@ -0,0 +1,449 @@
+#include "block_trace.h"
+
+// ==========================================
+//      ON-DISK FORMAT
+// ==========================================
+
+#define BLOCK_TRACE_MAGIC "OSBT"
+#define BLOCK_TRACE_VERSION 1u
+
+// Binary layout: header followed by one record per I/O (count 0 = not recorded)
+typedef struct
+{
+    char magic[4];
+    uint32_t version;
+    uint64_t count;
+} BlockTraceHeader;
+
+typedef struct
+{
+    uint64_t timestampNs;
+    uint64_t sector;
+    uint32_t length; // sectors
+    uint16_t op;     // 0 = read, 1 = write
+    uint16_t process;
+} BlockTraceRecord;
+
+// ==========================================
+//      READER
+// ==========================================
+
+static void refill(BlockTrace *t)
+{
+    memmove(t->buf, t->buf + t->pos, t->len - t->pos);
+    t->len -= t->pos;
+    t->pos = 0;
+    size_t got = fread(t->buf + t->len, 1, BLOCK_TRACE_BUFFER - t->len, t->fp);
+    if (got == 0)
+        t->eof = true;
+    t->len += got;
+}
+
+static void blockTraceError(BlockTrace *t, const char *what)
+{
+    if (t->format == BLOCK_TRACE_TEXT)
+        snprintf(t->error, sizeof(t->error), "line %lld: %s", t->line, what);
+    else
+        snprintf(t->error, sizeof(t->error), "record %lld: %s", t->ios + 1, what);
+}
+
+bool openBlockTrace(BlockTrace *t, const char *path)
+{
+    t->fp = (path == NULL || strcmp(path, "-") == 0) ? stdin : fopen(path, "rb");
+    if (t->fp == NULL)
+        return false;
+    t->buf = safeMalloc(BLOCK_TRACE_BUFFER + 1); // + 1 for the terminator of a final unterminated line
+    t->len = t->pos = 0;
+    t->eof = false;
+    t->expected = 0;
+    t->line = t->ios = 0;
+    t->error[0] = '\0';
+    t->format = BLOCK_TRACE_TEXT;
+
+    while (!t->eof && t->len < sizeof(BlockTraceHeader))
+        refill(t);
+    if (t->len < 4 || memcmp(t->buf, BLOCK_TRACE_MAGIC, 4) != 0)
+        return true;
+
+    t->format = BLOCK_TRACE_BINARY;
+    BlockTraceHeader header;
+    if (t->len < sizeof(header))
+    {
+        blockTraceError(t, "truncated header");
+        return true;
+    }
+    memcpy(&header, t->buf, sizeof(header));
+    t->pos = sizeof(header);
+    t->expected = (long long)header.count;
+    if (header.version != BLOCK_TRACE_VERSION)
+        blockTraceError(t, "unsupported binary trace version");
+    return true;
+}
+
+void closeBlockTrace(BlockTrace *t)
+{
+    if (t->fp != NULL && t->fp != stdin)
+        fclose(t->fp);
+    free(t->buf);
+    t->fp = NULL;
+    t->buf = NULL;
+}
+
+// Next line, NUL-terminated in place; NULL at the end of input
+static char *nextLine(BlockTrace *t)
+{
+    while (1)
+    {
+        char *start = t->buf + t->pos;
+        char *newline = memchr(start, '\n', t->len - t->pos);
+        if (newline != NULL)
+        {
+            *newline = '\0';
+            t->pos = (size_t)(newline - t->buf) + 1;
+            t->line++;
+            return start;
+        }
+        if (t->eof)
+        {
+            if (t->pos == t->len)
+                return NULL;
+            t->buf[t->len] = '\0';
+            t->pos = t->len;
+            t->line++;
+            return start;
+        }
+        if (t->pos == 0 && t->len == BLOCK_TRACE_BUFFER)
+        {
+            t->line++;
+            blockTraceError(t, "line too long");
+            return NULL;
+        }
+        refill(t);
+    }
+}
+
+static const char *skipSeparators(const char *p)
+{
+    while (*p == ' ' || *p == '\t' || *p == ',')
+        p++;
+    return p;
+}
+
+// Unsigned decimal, with a fraction when `fraction` is set; NULL if there are no digits
+static const char *parseNumber(const char *p, bool fraction, double *value)
+{
+    const char *start = p;
+    unsigned long long whole = 0;
+    while (*p >= '0' && *p <= '9')
+        whole = whole * 10 + (unsigned long long)(*p++ - '0');
+    *value = (double)whole;
+    if (fraction && *p == '.')
+    {
+        double scale = 0.1;
+        for (p++; *p >= '0' && *p <= '9'; p++, scale /= 10)
+            *value += (*p - '0') * scale;
+    }
+    return (p == start) ? NULL : p;
+}
+
+static bool endOfField(char c)
+{
+    return c == '\0' || c == ' ' || c == '\t' || c == ',' || c == '\r' || c == '#';
+}
+
+// 1 = I/O, 0 = line to skip, -1 = malformed
+static int parseLine(const char *p, BlockIo *io)
+{
+    p = skipSeparators(p);
+    if (*p == '\0' || *p == '\r' || *p == '#')
+        return 0;
+
+    double timestamp, sector, length, process = 0;
+    if ((p = parseNumber(p, true, &timestamp)) == NULL || !endOfField(*p))
+        return -1;
+    p = skipSeparators(p);
+    if ((p = parseNumber(p, false, &sector)) == NULL || !endOfField(*p))
+        return -1;
+    p = skipSeparators(p);
+    if ((p = parseNumber(p, false, &length)) == NULL || !endOfField(*p))
+        return -1;
+    p = skipSeparators(p);
+
+    if (*p == 'R' || *p == 'r' || *p == '0')
+        io->op = IO_READ;
+    else if (*p == 'W' || *p == 'w' || *p == '1')
+        io->op = IO_WRITE;
+    else
+        return -1;
+    while (!endOfField(*p))
+        p++;
+    p = skipSeparators(p);
+    if (*p >= '0' && *p <= '9' && ((p = parseNumber(p, false, &process)) == NULL || !endOfField(*p)))
+        return -1;
+
+    io->timestamp = timestamp;
+    io->sector = (long long)sector;
+    io->length = (long long)length;
+    io->process = (int)process;
+    return 1;
+}
+
+// Next I/O in the stream; false at the end or on error
+static bool nextIo(BlockTrace *t, BlockIo *io)
+{
+    if (t->error[0] != '\0')
+        return false;
+    if (t->format == BLOCK_TRACE_TEXT)
+    {
+        char *line;
+        while ((line = nextLine(t)) != NULL)
+        {
+            int status = parseLine(line, io);
+            if (status == 1)
+                return true;
+            if (status == -1)
+            {
+                blockTraceError(t, "expected timestamp_us sector length R|W [process]");
+                return false;
+            }
+        }
+        return false;
+    }
+
+    BlockTraceRecord record;
+    while (!t->eof && t->len - t->pos < sizeof(record))
+        refill(t);
+    if (t->len - t->pos < sizeof(record))
+    {
+        if (t->len != t->pos)
+            blockTraceError(t, "truncated record");
+        else if (t->expected != 0 && t->ios != t->expected)
+            blockTraceError(t, "fewer records than the header promises");
+        return false;
+    }
+    memcpy(&record, t->buf + t->pos, sizeof(record));
+    t->pos += sizeof(record);
+    if (record.op > IO_WRITE)
+    {
+        blockTraceError(t, "op must be 0 (read) or 1 (write)");
+        return false;
+    }
+    io->timestamp = record.timestampNs / 1e3;
+    io->sector = (long long)record.sector;
+    io->length = record.length;
+    io->op = (IoOp)record.op;
+    io->process = record.process;
+    return true;
+}
+
+int readBlockTrace(BlockTrace *t, BlockIo out[], int max)
+{
+    int n = 0;
+    for (; n < max && nextIo(t, &out[n]); n++)
+        t->ios++;
+    return n;
+}
+
+bool convertBlockTrace(const char *inPath, const char *outPath, long long *ios, char *error, size_t errorSize)
+{
+    BlockTrace t;
+    if (!openBlockTrace(&t, inPath))
+    {
+        snprintf(error, errorSize, "cannot open %s", inPath ? inPath : "stdin");
+        return false;
+    }
+    FILE *fp = fopen(outPath, "wb");
+    if (fp == NULL)
+    {
+        closeBlockTrace(&t);
+        snprintf(error, errorSize, "cannot create %s", outPath);
+        return false;
+    }
+
+    BlockTraceHeader header;
+    memcpy(header.magic, BLOCK_TRACE_MAGIC, 4);
+    header.version = BLOCK_TRACE_VERSION;
+    header.count = 0;
+    bool ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+
+    BlockIo *chunk = safeMalloc(BLOCK_TRACE_CHUNK * sizeof(BlockIo));
+    BlockTraceRecord *records = safeMalloc(BLOCK_TRACE_CHUNK * sizeof(BlockTraceRecord));
+    int n;
+    while (ok && (n = readBlockTrace(&t, chunk, BLOCK_TRACE_CHUNK)) > 0)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            records[i].timestampNs = (uint64_t)llround(chunk[i].timestamp * 1e3);
+            records[i].sector = (uint64_t)chunk[i].sector;
+            records[i].length = (uint32_t)chunk[i].length;
+            records[i].op = (uint16_t)chunk[i].op;
+            records[i].process = (uint16_t)chunk[i].process;
+        }
+        ok = fwrite(records, sizeof(BlockTraceRecord), (size_t)n, fp) == (size_t)n;
+    }
+    free(chunk);
+    free(records);
+
+    // Now that the count is known, patch it into the header
+    header.count = (uint64_t)t.ios;
+    ok = ok && fseek(fp, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, fp) == 1;
+    if (fclose(fp) != 0)
+        ok = false;
+
+    *ios = t.ios;
+    if (t.error[0] != '\0')
+        snprintf(error, errorSize, "%s", t.error);
+    else if (!ok)
+        snprintf(error, errorSize, "cannot write %s", outPath);
+    bool success = ok && t.error[0] == '\0';
+    closeBlockTrace(&t);
+    return success;
+}
+
+// ==========================================
+//      STREAMING REPLAY
+// ==========================================
+
+void defaultBlockReplayConfig(BlockReplayConfig *cfg)
+{
+    cfg->timeScale = 1.0;
+    cfg->outstanding = 0;
+    cfg->readDeadlineUs = 0;
+}
+
+int replayBlockTrace(const char *path, const TimedDiskConfig *cfg, const BlockReplayConfig *replay,
+                     unsigned policyMask, TimedDiskResult results[], char *error, size_t errorSize)
+{
+    if (replay->outstanding == 0 && !(replay->timeScale > 0))
+    {
+        snprintf(error, errorSize, "time scale must be positive");
+        return -1;
+    }
+    BlockTrace t;
+    if (!openBlockTrace(&t, path))
+    {
+        snprintf(error, errorSize, "cannot open %s", path ? path : "stdin");
+        return -1;
+    }
+
+    TimedDiskSim *sims = safeMalloc(DISK_TIMED_POLICY_COUNT * sizeof(TimedDiskSim));
+    int count = 0;
+    bool ok = true;
+    for (int policy = DISK_FCFS; policy <= DISK_TIMED_POLICY_COUNT && ok; policy++)
+        if (policyMask & (1u << (policy - 1)))
+        {
+            ok = createTimedDiskSim(&sims[count], (DiskPolicy)policy, cfg, 0, replay->outstanding, error, errorSize);
+            count += ok;
+        }
+
+    BlockIo *chunk = safeMalloc(BLOCK_TRACE_CHUNK * sizeof(BlockIo));
+    IoRequest *req = safeMalloc(BLOCK_TRACE_CHUNK * sizeof(IoRequest));
+    int blocksPerCylinder = sectorsPerCylinder(&cfg->device);
+    const long long sectorsPerBlock = DEVICE_BLOCK_BYTES / SECTOR_BYTES;
+    double first = 0;
+    bool started = false;
+    long long lastArrival = 0;
+    int n;
+    while (ok && (n = readBlockTrace(&t, chunk, BLOCK_TRACE_CHUNK)) > 0)
+    {
+        int m = 0;
+        for (int k = 0; k < n; k++)
+        {
+            const BlockIo *io = &chunk[k];
+            if (io->length == 0)
+                continue;
+            if (!started)
+                first = io->timestamp;
+            started = true;
+            IoRequest *r = &req[m++];
+            long long block = io->sector / sectorsPerBlock;
+            r->cylinder = block / blocksPerCylinder;
+            r->sector = (int)(block % blocksPerCylinder);
+            r->length = (int)((io->sector + io->length - 1) / sectorsPerBlock - block + 1);
+            r->op = io->op;
+            r->process = io->process;
+            r->deadline = (io->op == IO_READ) ? replay->readDeadlineUs : 0;
+            // Traces merged from several CPUs can be slightly out of order; nothing arrives before its predecessor
+            r->arrival = llround((io->timestamp - first) * replay->timeScale);
+            if (r->arrival < lastArrival)
+                r->arrival = lastArrival;
+            lastArrival = r->arrival;
+        }
+        for (int i = 0; i < count && ok; i++)
+            ok = feedTimedDisk(&sims[i], req, m, error, errorSize);
+    }
+    free(chunk);
+    free(req);
+
+    if (ok && t.error[0] != '\0')
+    {
+        snprintf(error, errorSize, "%s", t.error);
+        ok = false;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        if (ok)
+            finishTimedDisk(&sims[i], &results[i]);
+        freeTimedDiskSim(&sims[i]);
+    }
+    free(sims);
+    closeBlockTrace(&t);
+    return ok ? count : -1;
+}
+
+// ==========================================
+//      INTERACTIVE FRONT END
+// ==========================================
+
+void runBlockTraceReplay()
+{
+    char path[256];
+    printHeader("BLOCK TRACE REPLAY");
+    readPath("Trace file (\"timestamp_us sector length R|W\" lines, or binary): ", path, sizeof(path));
+    printf("Device (1. Linear seek model  2. HDD  3. SSD): ");
+    int device = getSafeInt();
+    printf("Outstanding I/Os for an as-fast-as-possible replay (0 = follow the timestamps): ");
+    BlockReplayConfig replay;
+    defaultBlockReplayConfig(&replay);
+    replay.outstanding = getSafeInt();
+    if (replay.outstanding == 0)
+    {
+        printf("Time scale in percent (100 = as recorded, 50 = twice as fast): ");
+        replay.timeScale = getSafeInt() / 100.0;
+    }
+    printf("Plug window in microseconds, to merge and batch requests (0 = none): ");
+    long long plugUs = getSafeInt();
+
+    TimedDiskConfig cfg;
+    defaultTimedDiskConfig(&cfg, (device >= DEVICE_LINEAR && device <= DEVICE_KIND_COUNT) ? (DeviceKind)device
+                                                                                          : DEVICE_HDD);
+    cfg.disk.cylinders = DEFAULT_TRACE_CYLINDERS;
+    TimedDiskResult results[DISK_TIMED_POLICY_COUNT], plugged[DISK_TIMED_POLICY_COUNT];
+    char error[160];
+    long long start = monotonicNanos();
+    int count = replayBlockTrace(path, &cfg, &replay, ~0u, results, error, sizeof(error));
+    if (count >= 0 && plugUs > 0)
+    {
+        TimedDiskConfig plugCfg = cfg;
+        plugCfg.staging.plugUs = plugUs;
+        count = replayBlockTrace(path, &plugCfg, &replay, ~0u, plugged, error, sizeof(error));
+    }
+    long long elapsed = monotonicNanos() - start;
+    if (count < 0)
+    {
+        printf(RED "Cannot replay: %s\n" RESET, error);
+        waitForStudent();
+        return;
+    }
+
+    printTimedDiskResults(deviceKindName(cfg.device.kind), results, count);
+    if (plugUs > 0)
+        printStagingResults(deviceKindName(cfg.device.kind), plugUs, results, plugged, count);
+    printf(YELLOW "%lld I/Os on a %lld-cylinder disk, %.2f s in total.\n" RESET, count ? results[0].requests : 0,
+           cfg.disk.cylinders, elapsed / 1e9);
+    if (replay.outstanding > 0)
+        printf("Replayed as fast as possible with %d I/Os outstanding.\n", replay.outstanding);
+    else
+        printf("Replayed at %.0f%% of the recorded pace.\n", 100.0 / replay.timeScale);
+    waitForStudent();
+}
@@ -0,0 +1,97 @@
+#ifndef BLOCK_TRACE_H
+#define BLOCK_TRACE_H
+
+#include "disk_timed.h"
+
+// --- Constants ---
+#define BLOCK_TRACE_CHUNK 65536      // I/Os decoded per read
+#define BLOCK_TRACE_BUFFER (1 << 20) // bytes of input held at a time
+#define SECTOR_BYTES 512
+#define DEVICE_BLOCK_BYTES 4096       // the unit of IoRequest.sector and length
+#define DEFAULT_TRACE_CYLINDERS 262144 // 1000 blocks each: about 1 TiB
+
+// --- Structures ---
+typedef enum
+{
+    BLOCK_TRACE_TEXT,
+    BLOCK_TRACE_BINARY
+} BlockTraceFormat;
+
+// One traced I/O as recorded, before it is mapped onto the simulated disk
+typedef struct
+{
+    double timestamp; // microseconds
+    long long sector; // 512-byte sectors from the start of the device
+    long long length; // sectors
+    IoOp op;
+    int process;
+} BlockIo;
+
+/**
+ * Streaming reader for block I/O traces. Two formats:
+ *   text   - one I/O per line: "timestamp sector length op [process]",
+ *            separated by spaces, tabs or commas. The timestamp is in
+ *            microseconds (fractions allowed); op is R or W (any word
+ *            starting with either, in either case) or 0/1. Lines starting
+ *            with '#' are skipped;
+ *   binary - "OSBT" header then one 24-byte record per I/O (see
+ *            block_trace.c).
+ * Either way the input goes through one fixed buffer, so memory does not
+ * grow with the trace.
+ */
+typedef struct
+{
+    FILE *fp;
+    BlockTraceFormat format;
+    char *buf;
+    size_t len, pos;
+    bool eof;
+    long long expected; // binary: record count from the header
+    long long line;     // text: last line read, for error messages
+    long long ios;      // I/Os decoded so far
+    char error[128];    // empty unless reading stopped on bad input
+} BlockTrace;
+
+/**
+ * How traced I/Os become arrivals. By default they arrive at their
+ * timestamps, rebased to start at 0 and multiplied by timeScale (0.5
+ * replays twice as fast). With outstanding > 0 the timestamps are ignored
+ * and the trace is replayed as fast as possible: each I/O is issued as
+ * soon as fewer than `outstanding` are queued or in flight.
+ */
+typedef struct
+{
+    double timeScale;
+    int outstanding;
+    long long readDeadlineUs; // attached to every read; 0 = none
+} BlockReplayConfig;
+
+// --- Function Prototypes ---
+/**
+ * Opens a trace (NULL or "-" reads stdin). Returns false only when the
+ * file cannot be opened; bad input shows up in t->error.
+ */
+bool openBlockTrace(BlockTrace *t, const char *path);
+int readBlockTrace(BlockTrace *t, BlockIo out[], int max); // I/Os read, 0 at the end
+void closeBlockTrace(BlockTrace *t);
+
+// Rewrites a text trace as a binary one, streaming; false with `error` filled on failure
+bool convertBlockTrace(const char *inPath, const char *outPath, long long *ios, char *error, size_t errorSize);
+
+void defaultBlockReplayConfig(BlockReplayConfig *cfg);
+
+/**
+ * Streams the trace once through every policy in `policyMask` (bit p-1
+ * for DiskPolicy p) on the disk and device of cfg, with the arm starting
+ * at cylinder 0. Sectors map onto 4 KiB blocks, 1000 to a cylinder with
+ * the default geometry. I/Os of length 0 (flushes) are skipped. Fills
+ * results in policy order and returns how many, or -1 with `error`
+ * filled. Memory follows the simulated backlog, not the trace length.
+ */
+int replayBlockTrace(const char *path, const TimedDiskConfig *cfg, const BlockReplayConfig *replay,
+                     unsigned policyMask, TimedDiskResult results[], char *error, size_t errorSize);
+
+// Interactive front end: asks for a file, a device and the replay mode
+void runBlockTraceReplay();
+
+#endif
@@ -0,0 +1,333 @@
+#include "buddy_allocator.h"
+
+// ==========================================
+//      HIERARCHICAL BITMAP
+// ==========================================
+
+static void initBitIndex(BitIndex *bi, long long bits)
+{
+    bi->levels = 0;
+    long long words = (bits + 63) / 64;
+    do
+    {
+        if (words < 1)
+            words = 1;
+        bi->words[bi->levels] = calloc((size_t)words, sizeof(uint64_t));
+        if (bi->words[bi->levels] == NULL)
+        {
+            printf(RED "\nFatal: out of memory for buddy bitmaps\n" RESET);
+            exit(EXIT_FAILURE);
+        }
+        bi->wordCount[bi->levels] = words;
+        bi->levels++;
+        words = (words + 63) / 64;
+    } while (bi->wordCount[bi->levels - 1] > 1);
+}
+
+static void freeBitIndex(BitIndex *bi)
+{
+    for (int l = 0; l < bi->levels; l++)
+        free(bi->words[l]);
+    bi->levels = 0;
+}
+
+static void setBitIndex(BitIndex *bi, long long i)
+{
+    for (int l = 0; l < bi->levels; l++)
+    {
+        uint64_t *word = &bi->words[l][i >> 6];
+        bool wasEmpty = (*word == 0);
+        *word |= 1ULL << (i & 63);
+        if (!wasEmpty)
+            return; // the levels above already know this word is non-empty
+        i >>= 6;
+    }
+}
+
+static void clearBitIndex(BitIndex *bi, long long i)
+{
+    for (int l = 0; l < bi->levels; l++)
+    {
+        uint64_t *word = &bi->words[l][i >> 6];
+        *word &= ~(1ULL << (i & 63));
+        if (*word != 0)
+            return;
+        i >>= 6;
+    }
+}
+
+static bool testBitIndex(const BitIndex *bi, long long i)
+{
+    return (bi->words[0][i >> 6] >> (i & 63)) & 1;
+}
+
+static long long firstBitIndex(const BitIndex *bi)
+{
+    int top = bi->levels - 1;
+    if (bi->words[top][0] == 0)
+        return -1;
+    long long i = 0;
+    for (int l = top; l >= 0; l--)
+        i = i * 64 + lowestSetBit(bi->words[l][i]);
+    return i;
+}
+
+static size_t bitIndexBytes(const BitIndex *bi)
+{
+    size_t bytes = 0;
+    for (int l = 0; l < bi->levels; l++)
+        bytes += (size_t)bi->wordCount[l] * sizeof(uint64_t);
+    return bytes;
+}
+
+// ==========================================
+//      BUDDY SYSTEM
+// ==========================================
+
+static long long blockBytes(int order)
+{
+    return 1LL << (order + BUDDY_MIN_SHIFT);
+}
+
+static long long nodeOf(const BuddyAllocator *b, int order, long long idx)
+{
+    return (1LL << (b->maxOrder - order)) + idx;
+}
+
+static bool isSplit(const BuddyAllocator *b, long long node)
+{
+    return (b->splitBits[node >> 6] >> (node & 63)) & 1;
+}
+
+static void setSplit(BuddyAllocator *b, long long node, bool split)
+{
+    if (split)
+        b->splitBits[node >> 6] |= 1ULL << (node & 63);
+    else
+        b->splitBits[node >> 6] &= ~(1ULL << (node & 63));
+}
+
+static void markFree(BuddyAllocator *b, int order, long long idx)
+{
+    setBitIndex(&b->freeBits[order], idx);
+    b->freeCount[order]++;
+}
+
+static void markUsed(BuddyAllocator *b, int order, long long idx)
+{
+    clearBitIndex(&b->freeBits[order], idx);
+    b->freeCount[order]--;
+}
+
+// Frees every block that lies inside the arena; the padding past its end stays reserved
+static void carveArena(BuddyAllocator *b, int order, long long idx)
+{
+    long long start = idx * blockBytes(order);
+    if (start >= b->size)
+        return;
+    if (start + blockBytes(order) <= b->size)
+    {
+        markFree(b, order, idx);
+        return;
+    }
+    setSplit(b, nodeOf(b, order, idx), true);
+    carveArena(b, order - 1, 2 * idx);
+    carveArena(b, order - 1, 2 * idx + 1);
+}
+
+bool initBuddy(BuddyAllocator *b, long long arenaSize)
+{
+    arenaSize -= arenaSize % blockBytes(0);
+    if (arenaSize < blockBytes(0))
+        return false;
+    int maxOrder = 0;
+    while (blockBytes(maxOrder) < arenaSize)
+        maxOrder++;
+    if (maxOrder > BUDDY_MAX_ORDER)
+        return false;
+
+    b->size = arenaSize;
+    b->maxOrder = maxOrder;
+    b->splitBits = calloc((size_t)((2LL << maxOrder) + 63) / 64, sizeof(uint64_t));
+    if (b->splitBits == NULL)
+        return false;
+    for (int k = 0; k <= maxOrder; k++)
+    {
+        initBitIndex(&b->freeBits[k], 1LL << (maxOrder - k));
+        b->freeCount[k] = 0;
+    }
+    b->freeBytes = arenaSize;
+    memset(&b->stats, 0, sizeof(b->stats));
+    carveArena(b, maxOrder, 0);
+    return true;
+}
+
+void freeBuddy(BuddyAllocator *b)
+{
+    for (int k = 0; k <= b->maxOrder; k++)
+        freeBitIndex(&b->freeBits[k]);
+    free(b->splitBits);
+    b->splitBits = NULL;
+}
+
+long long buddyAlloc(BuddyAllocator *b, long long size)
+{
+    if (size < 0)
+    {
+        b->stats.failures++;
+        return -1;
+    }
+    int order = 0;
+    while (order <= b->maxOrder && blockBytes(order) < size)
+        order++;
+    int from = order;
+    while (from <= b->maxOrder && b->freeCount[from] == 0)
+        from++;
+    if (from > b->maxOrder)
+    {
+        b->stats.failures++;
+        return -1;
+    }
+
+    // Take the lowest free block of the nearest order, then halve it down
+    long long idx = firstBitIndex(&b->freeBits[from]);
+    markUsed(b, from, idx);
+    while (from > order)
+    {
+        setSplit(b, nodeOf(b, from, idx), true);
+        from--;
+        idx *= 2;
+        markFree(b, from, idx + 1); // the upper half is the new free buddy
+    }
+
+    b->freeBytes -= blockBytes(order);
+    b->stats.allocs++;
+    b->stats.blockBytes += blockBytes(order);
+    if (b->stats.blockBytes > b->stats.peakBlockBytes)
+        b->stats.peakBlockBytes = b->stats.blockBytes;
+    return idx * blockBytes(order);
+}
+
+// Walks down the split bits to the unsplit block holding `offset`
+static int findBlock(const BuddyAllocator *b, long long offset, long long *idx)
+{
+    int order = b->maxOrder;
+    *idx = 0;
+    while (order > 0 && isSplit(b, nodeOf(b, order, *idx)))
+    {
+        order--;
+        *idx = offset / blockBytes(order);
+    }
+    return order;
+}
+
+long long buddyBlockSize(const BuddyAllocator *b, long long offset)
+{
+    if (offset < 0 || offset >= b->size)
+        return 0;
+    long long idx;
+    int order = findBlock(b, offset, &idx);
+    if (idx * blockBytes(order) != offset || testBitIndex(&b->freeBits[order], idx) ||
+        offset + blockBytes(order) > b->size)
+        return 0; // inside a block, a free block, or the reserved padding
+    return blockBytes(order);
+}
+
+bool buddyFree(BuddyAllocator *b, long long offset)
+{
+    long long size = buddyBlockSize(b, offset);
+    if (size == 0)
+        return false;
+    long long idx;
+    int order = findBlock(b, offset, &idx);
+
+    b->freeBytes += size;
+    b->stats.frees++;
+    b->stats.blockBytes -= size;
+
+    // Merge upwards while the buddy is free as a whole
+    while (order < b->maxOrder && testBitIndex(&b->freeBits[order], idx ^ 1))
+    {
+        markUsed(b, order, idx ^ 1);
+        order++;
+        idx >>= 1;
+        setSplit(b, nodeOf(b, order, idx), false);
+    }
+    markFree(b, order, idx);
+    return true;
+}
+
+void buddyStats(const BuddyAllocator *b, AllocatorStats *out)
+{
+    *out = b->stats;
+    out->freeBytes = b->freeBytes;
+    out->largestFree = 0;
+    out->freeRegions = 0;
+    out->metadataBytes = (long long)(((2LL << b->maxOrder) + 63) / 64 * sizeof(uint64_t));
+    for (int k = 0; k <= b->maxOrder; k++)
+    {
+        out->freeRegions += b->freeCount[k];
+        if (b->freeCount[k] > 0)
+            out->largestFree = blockBytes(k);
+        out->metadataBytes += (long long)bitIndexBytes(&b->freeBits[k]);
+    }
+}
+
+static void mapBlocks(const BuddyAllocator *b, int order, long long idx, char *out, int width)
+{
+    long long start = idx * blockBytes(order);
+    if (start >= b->size)
+        return;
+    if (order > 0 && isSplit(b, nodeOf(b, order, idx)))
+    {
+        mapBlocks(b, order - 1, 2 * idx, out, width);
+        mapBlocks(b, order - 1, 2 * idx + 1, out, width);
+        return;
+    }
+    if (testBitIndex(&b->freeBits[order], idx))
+        return;
+    long long end = start + blockBytes(order);
+    int first = (int)(start * width / b->size);
+    int last = (int)((end - 1) * width / b->size);
+    for (int c = first; c <= last && c < width; c++)
+        out[c] = '#';
+}
+
+void buddyMemoryMap(const BuddyAllocator *b, char *out, int width)
+{
+    memset(out, '.', (size_t)width);
+    out[width] = '\0';
+    mapBlocks(b, b->maxOrder, 0, out, width);
+}
+
+// ==========================================
+//      ALLOCATOR INTERFACE
+// ==========================================
+
+static long long opsAlloc(void *self, long long size)
+{
+    return buddyAlloc(self, size);
+}
+
+static bool opsRelease(void *self, long long offset)
+{
+    return buddyFree(self, offset);
+}
+
+static void opsStats(const void *self, AllocatorStats *out)
+{
+    buddyStats(self, out);
+}
+
+static void opsMemoryMap(const void *self, char *out, int width)
+{
+    buddyMemoryMap(self, out, width);
+}
+
+static void opsDestroy(void *self)
+{
+    freeBuddy(self);
+    free(self);
+}
+
+const AllocatorOps buddyOps = {"Buddy", opsAlloc, opsRelease, opsStats, opsMemoryMap, opsDestroy, NULL};
@@ -0,0 +1,54 @@
+#ifndef BUDDY_ALLOCATOR_H
+#define BUDDY_ALLOCATOR_H
+
+#include "allocator.h"
+
+// --- Constants ---
+#define BUDDY_MIN_SHIFT 5 // order-0 blocks are 32 bytes
+#define BUDDY_MAX_ORDER 40
+
+// --- Structures ---
+/**
+ * Hierarchical bitmap: level 0 holds one bit per item, each higher level
+ * one bit per non-empty word below it, so the lowest set bit is found in
+ * O(log64 n) word reads.
+ */
+typedef struct
+{
+    uint64_t *words[8];
+    long long wordCount[8];
+    int levels;
+} BitIndex;
+
+/**
+ * Binary buddy system. All metadata is bitmaps kept outside the arena:
+ * freeBits[k] marks which order-k blocks are free (one BitIndex per order,
+ * playing the role of the per-order free lists), and splitBits has one bit
+ * per node of the buddy tree telling whether that block is split. A block
+ * that is neither split nor free is allocated, so freeing an offset needs
+ * no header - just a walk down the tree.
+ */
+typedef struct
+{
+    long long size;  // usable arena bytes
+    int maxOrder;    // the root block is 2^(maxOrder + BUDDY_MIN_SHIFT) bytes
+    BitIndex freeBits[BUDDY_MAX_ORDER + 1];
+    uint64_t *splitBits; // heap-numbered tree nodes: root 1, children 2i and 2i+1
+    long long freeCount[BUDDY_MAX_ORDER + 1];
+    long long freeBytes;
+    AllocatorStats stats;
+} BuddyAllocator;
+
+// Allocator interface for a BuddyAllocator (self = BuddyAllocator *)
+extern const AllocatorOps buddyOps;
+
+// --- Function Prototypes ---
+bool initBuddy(BuddyAllocator *b, long long arenaSize);
+void freeBuddy(BuddyAllocator *b);
+long long buddyAlloc(BuddyAllocator *b, long long size); // offset, or -1
+bool buddyFree(BuddyAllocator *b, long long offset);
+long long buddyBlockSize(const BuddyAllocator *b, long long offset); // 0 if not allocated
+void buddyStats(const BuddyAllocator *b, AllocatorStats *out);
+void buddyMemoryMap(const BuddyAllocator *b, char *out, int width);
+
+#endif
@@ -0,0 +1,306 @@
+#include "compaction.h"
+
+// ==========================================
+//      PLANNING
+// ==========================================
+
+const char *compactionName(CompactionPolicy policy)
+{
+    switch (policy)
+    {
+    case COMPACT_SLIDING:
+        return "Sliding";
+    case COMPACT_MIN_MOVE:
+        return "Min-move";
+    default:
+        return "None";
+    }
+}
+
+int planSliding(const HeapBlock blocks[], int n, Relocation moves[])
+{
+    int count = 0;
+    long long cursor = 0;
+    for (int i = 0; i < n; i++)
+    {
+        if (blocks[i].offset != cursor)
+        {
+            moves[count].from = blocks[i].offset;
+            moves[count].to = cursor;
+            moves[count].bytes = blocks[i].size;
+            count++;
+        }
+        cursor += blocks[i].size;
+    }
+    return count;
+}
+
+typedef struct
+{
+    int first, last; // blocks[first..last] have to move
+    long long cost;
+} Window;
+
+static int compareWindows(const void *a, const void *b)
+{
+    long long x = ((const Window *)a)->cost, y = ((const Window *)b)->cost;
+    return (x > y) - (x < y);
+}
+
+static int compareLargestFirst(const void *a, const void *b)
+{
+    long long x = ((const HeapBlock *)a)->size, y = ((const HeapBlock *)b)->size;
+    return (x < y) - (x > y);
+}
+
+static long long blockEnd(const HeapBlock blocks[], int i)
+{
+    return (i < 0) ? 0 : blocks[i].offset + blocks[i].size;
+}
+
+// Places blocks[w.first..w.last] into the holes outside the window, largest first
+static int evacuate(const HeapBlock blocks[], int n, long long arenaSize, Window w, long long minGap,
+                    Relocation moves[])
+{
+    FitIndex outside;
+    initFitIndex(&outside);
+    for (int i = 0; i <= n; i++)
+    {
+        if (i >= w.first && i <= w.last + 1)
+            continue; // gaps inside the window become part of the new hole
+        long long start = blockEnd(blocks, i - 1);
+        long long end = (i < n) ? blocks[i].offset : arenaSize;
+        if (end > start)
+            fitInsertHole(&outside, start, end - start);
+    }
+
+    int k = w.last - w.first + 1;
+    HeapBlock *moving = safeMalloc(k * sizeof(HeapBlock));
+    memcpy(moving, &blocks[w.first], k * sizeof(HeapBlock));
+    qsort(moving, (size_t)k, sizeof(HeapBlock), compareLargestFirst);
+
+    int count = 0;
+    for (int i = 0; i < k; i++)
+    {
+        long long size = moving[i].size, holeSize = 0;
+        long long at = fitFindHole(&outside, FIT_BEST, size, &holeSize);
+        if (at != -1 && holeSize != size && holeSize - size < minGap)
+            at = fitFindHole(&outside, FIT_BEST, size + minGap, &holeSize); // no unusable slivers
+        if (at == -1)
+        {
+            count = -1;
+            break;
+        }
+        fitRemoveHole(&outside, at, holeSize);
+        if (holeSize > size)
+            fitInsertHole(&outside, at + size, holeSize - size);
+        moves[count].from = moving[i].offset;
+        moves[count].to = at;
+        moves[count].bytes = size;
+        count++;
+    }
+    free(moving);
+    freeFitIndex(&outside);
+    return count;
+}
+
+int planMinMove(const HeapBlock blocks[], int n, long long arenaSize, long long need, long long minGap,
+                Relocation moves[], long long *windowStart)
+{
+    if (n == 0)
+        return -1;
+
+    long long *prefix = safeMalloc((n + 1) * sizeof(long long));
+    prefix[0] = 0;
+    for (int i = 0; i < n; i++)
+        prefix[i + 1] = prefix[i] + blocks[i].size;
+
+    // For each first block, the shortest run of blocks whose removal opens
+    // `need` bytes; the run's end never moves backwards (two pointers)
+    Window *windows = safeMalloc(n * sizeof(Window));
+    int count = 0, last = 0;
+    for (int first = 0; first < n; first++)
+    {
+        long long start = blockEnd(blocks, first - 1);
+        if (last < first)
+            last = first;
+        while (last + 1 < n && blocks[last + 1].offset - start < need)
+            last++;
+        long long end = (last + 1 < n) ? blocks[last + 1].offset : arenaSize;
+        if (end - start >= need)
+        {
+            windows[count].first = first;
+            windows[count].last = last;
+            windows[count].cost = prefix[last + 1] - prefix[first];
+            count++;
+        }
+    }
+    free(prefix);
+    qsort(windows, (size_t)count, sizeof(Window), compareWindows);
+
+    int moved = -1;
+    for (int i = 0; i < count && i < MIN_MOVE_ATTEMPTS && moved == -1; i++)
+    {
+        moved = evacuate(blocks, n, arenaSize, windows[i], minGap, moves);
+        if (moved != -1)
+            *windowStart = blockEnd(blocks, windows[i].first - 1);
+    }
+    free(windows);
+    return moved;
+}
+
+static int compareRelocationSource(const void *a, const void *b)
+{
+    long long x = ((const Relocation *)a)->from, y = ((const Relocation *)b)->from;
+    return (x > y) - (x < y);
+}
+
+static int compareBlockOffset(const void *a, const void *b)
+{
+    long long x = ((const HeapBlock *)a)->offset, y = ((const HeapBlock *)b)->offset;
+    return (x > y) - (x < y);
+}
+
+void applyRelocations(HeapBlock blocks[], int n, Relocation moves[], int m)
+{
+    qsort(moves, (size_t)m, sizeof(Relocation), compareRelocationSource);
+    // Both lists are in address order, so one merge pass finds every moved block
+    for (int i = 0, j = 0; i < n && j < m; i++)
+    {
+        while (j < m && moves[j].from < blocks[i].offset)
+            j++;
+        if (j < m && moves[j].from == blocks[i].offset)
+            blocks[i].offset = moves[j].to;
+    }
+    qsort(blocks, (size_t)n, sizeof(HeapBlock), compareBlockOffset);
+}
+
+// ==========================================
+//      PARTITION HEAP
+// ==========================================
+
+bool partitionCompact(PartitionHeap *h, CompactionPolicy policy, long long request, Relocation **moves, int *count)
+{
+    long long need = heapBlockSizeFor(request);
+    *moves = NULL;
+    *count = 0;
+    if (policy == COMPACT_NONE || request < 0 || need > h->freeBytes)
+        return false; // no arrangement of the live blocks can fit it
+
+    HeapBlock *blocks;
+    int n = heapLiveBlocks(h, &blocks);
+    Relocation *plan = safeMalloc((n > 0 ? n : 1) * sizeof(Relocation));
+    long long window;
+    int m = -1;
+    if (policy == COMPACT_MIN_MOVE)
+        m = planMinMove(blocks, n, h->size, need, HEAP_MIN_BLOCK, plan, &window);
+    if (m == -1)
+        m = planSliding(blocks, n, plan); // always opens one hole of every free byte
+
+    // Copy in planned order (sliding relies on it), then settle the layout
+    Relocation *ordered = safeMalloc((m > 0 ? m : 1) * sizeof(Relocation));
+    memcpy(ordered, plan, m * sizeof(Relocation));
+    applyRelocations(blocks, n, plan, m);
+    heapRelocate(h, ordered, m, blocks, n);
+    free(ordered);
+    free(blocks);
+
+    for (int i = 0; i < m; i++)
+    {
+        plan[i].from += HEAP_TAG_BYTES;
+        plan[i].to += HEAP_TAG_BYTES;
+    }
+    *moves = plan;
+    *count = m;
+    h->stats.failures--; // the retry is certain to fit
+    return true;
+}
+
+// ==========================================
+//      FIXED PARTITIONS (WHAT-IF)
+// ==========================================
+
+// First gap of at least `need` bytes between the sorted regions, or -1
+static long long firstGap(const HeapBlock regions[], int n, long long total, long long need)
+{
+    for (int i = 0; i <= n; i++)
+    {
+        long long start = blockEnd(regions, i - 1);
+        long long end = (i < n) ? regions[i].offset : total;
+        if (end - start >= need)
+            return start;
+    }
+    return -1;
+}
+
+void fixedCompactionWhatIf(int blocks, const int bSize[], int processes, const int pSize[], const int allocation[],
+                           CompactionPolicy policy, CompactionReport *out)
+{
+    memset(out, 0, sizeof(*out));
+    out->policy = policy;
+
+    long long *blockStart = safeMalloc((blocks + 1) * sizeof(long long));
+    blockStart[0] = 0;
+    for (int j = 0; j < blocks; j++)
+        blockStart[j + 1] = blockStart[j] + (bSize[j] > 0 ? bSize[j] : 0);
+    long long total = blockStart[blocks], used = 0;
+
+    HeapBlock *regions = safeMalloc((processes > 0 ? processes : 1) * sizeof(HeapBlock));
+    Relocation *plan = safeMalloc((processes > 0 ? processes : 1) * sizeof(Relocation));
+    int n = 0;
+    for (int i = 0; i < processes; i++)
+        if (allocation[i] != -1)
+        {
+            regions[n].offset = blockStart[allocation[i]];
+            regions[n].size = pSize[i];
+            used += pSize[i];
+            n++;
+        }
+    qsort(regions, (size_t)n, sizeof(HeapBlock), compareBlockOffset);
+
+    for (int i = 0; i < processes; i++)
+    {
+        if (allocation[i] != -1)
+            continue;
+        long long need = pSize[i];
+        if (policy == COMPACT_NONE || need <= 0 || need > total - used)
+        {
+            out->stillFailed++;
+            continue;
+        }
+        // Once the partitions are gone, the process may already fit in a merged gap
+        long long at = firstGap(regions, n, total, need);
+        if (at == -1)
+        {
+            int m = -1;
+            if (policy == COMPACT_MIN_MOVE)
+                m = planMinMove(regions, n, total, need, 1, plan, &at);
+            if (m == -1)
+            {
+                m = planSliding(regions, n, plan);
+                at = used;
+            }
+            out->compactions++;
+            out->blocksMoved += m;
+            for (int k = 0; k < m; k++)
+                out->bytesMoved += plan[k].bytes;
+            applyRelocations(regions, n, plan, m);
+        }
+
+        // Insert the new region, keeping address order
+        int pos = n;
+        while (pos > 0 && regions[pos - 1].offset > at)
+        {
+            regions[pos] = regions[pos - 1];
+            pos--;
+        }
+        regions[pos].offset = at;
+        regions[pos].size = need;
+        n++;
+        used += need;
+        out->rescued++;
+    }
+    free(plan);
+    free(regions);
+    free(blockStart);
+}
@@ -0,0 +1,57 @@
+#ifndef COMPACTION_H
+#define COMPACTION_H
+
+#include "dynamic_partition.h"
+
+// --- Constants ---
+#define MIN_MOVE_ATTEMPTS 16 // cheapest windows tried before falling back to sliding
+
+// --- Structures ---
+// Outcome of compacting on demand while placing a list of requests
+typedef struct
+{
+    CompactionPolicy policy;
+    int rescued;     // requests that failed before and were placed after compacting
+    int stillFailed; // more than all free memory put together, or no room even after compacting
+    int compactions;
+    long long bytesMoved;
+    long long blocksMoved;
+} CompactionReport;
+
+// --- Planning ---
+/**
+ * Both planners work on live blocks in address order and write at most
+ * `n` moves (block offsets) into `moves`, returning how many they wrote.
+ *
+ * Sliding packs every block against offset 0, leaving one hole at the top.
+ * Min-move looks for the address window that can be cleared for `need`
+ * bytes by moving the fewest bytes, where the blocks inside must fit into
+ * holes outside it; leftovers smaller than `minGap` are never created. It
+ * returns -1 when no window works and reports the window in *windowStart.
+ */
+int planSliding(const HeapBlock blocks[], int n, Relocation moves[]);
+int planMinMove(const HeapBlock blocks[], int n, long long arenaSize, long long need, long long minGap,
+                Relocation moves[], long long *windowStart);
+
+// Moves the blocks named in `moves` (sorted by source as a side effect) and re-sorts `blocks`
+void applyRelocations(HeapBlock blocks[], int n, Relocation moves[], int m);
+
+// --- Engines ---
+/**
+ * Makes room for `request` in a partition heap. A successful call
+ * guarantees the retried allocation fits, so the failure that triggered it
+ * is taken off the heap's failure count. *moves gets payload offsets.
+ */
+bool partitionCompact(PartitionHeap *h, CompactionPolicy policy, long long request, Relocation **moves, int *count);
+
+/**
+ * What-if for fixed partitions: treats the blocks as one contiguous memory
+ * with each placed process at the start of its block, then places the
+ * unallocated processes in order, compacting whenever one does not fit.
+ */
+void fixedCompactionWhatIf(int blocks, const int bSize[], int processes, const int pSize[], const int allocation[],
+                           CompactionPolicy policy, CompactionReport *out);
+
+const char *compactionName(CompactionPolicy policy);
+
+#endif
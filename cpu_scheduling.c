@@ -3,110 +3,157 @@
 //      MODULE 1: CPU SCHEDULING
 // ==========================================
 
-GanttSegment history[1000];
-int historyIndex = 0;
+// ==========================================
+//      GANTT TRACE
+// ==========================================
+
+void initTrace(SchedTrace *trace)
+{
+    trace->segments = NULL;
+    trace->count = 0;
+    trace->capacity = 0;
+    trace->contextSwitches = 0;
+}
 
-void addToHistory(int pid, int start, int end)
+// Make room for at least `capacity` segments without touching recorded ones
+void reserveTrace(SchedTrace *trace, int capacity)
 {
-    if (historyIndex > 0 && history[historyIndex - 1].pid == pid)
+    if (capacity <= trace->capacity)
+        return;
+    GanttSegment *grown = realloc(trace->segments, (size_t)capacity * sizeof(GanttSegment));
+    if (grown == NULL)
     {
-        history[historyIndex - 1].endTime = end;
+        printf(RED "\nFatal: out of memory growing the Gantt trace\n" RESET);
+        exit(EXIT_FAILURE);
     }
-    else
+    trace->segments = grown;
+    trace->capacity = capacity;
+}
+
+// Forget recorded segments but keep the buffer for the next run
+void resetTrace(SchedTrace *trace)
+{
+    trace->count = 0;
+    trace->contextSwitches = 0;
+}
+
+void freeTrace(SchedTrace *trace)
+{
+    free(trace->segments);
+    initTrace(trace);
+}
+
+void addToHistory(SchedTrace *trace, int pid, int start, int end)
+{
+    if (trace->count > 0 && trace->segments[trace->count - 1].pid == pid)
     {
-        history[historyIndex].pid = pid;
-        history[historyIndex].startTime = start;
-        history[historyIndex].endTime = end;
-        historyIndex++;
+        trace->segments[trace->count - 1].endTime = end;
+        return;
     }
+    if (trace->count > 0)
+        trace->contextSwitches++; // CPU handed to a different process
+    if (trace->count == trace->capacity)
+        reserveTrace(trace, trace->capacity ? trace->capacity * 2 : 64);
+
+    GanttSegment *seg = &trace->segments[trace->count++];
+    seg->pid = pid;
+    seg->startTime = start;
+    seg->endTime = end;
 }
 
-void printGanttChart()
+// Printed width of one segment: two columns per time unit, at least 4
+static int segmentWidth(const GanttSegment *seg)
 {
-    printf("\n" YELLOW "--- GANTT CHART ---\n" RESET);
-    int segWidths[1000];
+    int width = (seg->endTime - seg->startTime) * 2;
+    return (width < 4) ? 4 : width;
+}
 
-    for (int i = 0; i < historyIndex; i++)
+void printGanttChart(const SchedTrace *trace)
+{
+    holdOutput();
+    const GanttSegment *history = trace->segments;
+    int historyIndex = trace->count;
+
+    outPuts("\n" YELLOW "--- GANTT CHART ---\n" RESET);
+    if (historyIndex == 0)
     {
-        int duration = history[i].endTime - history[i].startTime;
-        segWidths[i] = (duration * 2);
-        if (segWidths[i] < 4)
-            segWidths[i] = 4;
+        outPuts(" (no segments recorded)\n");
+        releaseOutput();
+        return;
     }
 
-    printf(" ");
+    outPuts(" ");
     for (int i = 0; i < historyIndex; i++)
     {
-        printf("+");
-        for (int j = 0; j < segWidths[i]; j++)
-            printf("-");
+        outPuts("+");
+        outRepeat('-', segmentWidth(&history[i]));
     }
-    printf("+\n");
+    outPuts("+\n");
 
-    printf(" ");
+    outPuts(" ");
     for (int i = 0; i < historyIndex; i++)
     {
-        printf("|");
-        int totalSpaces = segWidths[i] - countDigits(history[i].pid) - 1;
+        outPuts("|");
+        int totalSpaces = segmentWidth(&history[i]) - countDigits(history[i].pid) - 1;
         int leftPad = totalSpaces / 2;
         int rightPad = totalSpaces - leftPad;
-        for (int j = 0; j < leftPad; j++)
-            printf(" ");
-        printf(CYAN "P%d" RESET, history[i].pid);
-        for (int j = 0; j < rightPad; j++)
-            printf(" ");
+        outRepeat(' ', leftPad);
+        outPrintf(CYAN "P%d" RESET, history[i].pid);
+        outRepeat(' ', rightPad);
     }
-    printf("|\n");
+    outPuts("|\n");
 
-    printf(" ");
+    outPuts(" ");
     for (int i = 0; i < historyIndex; i++)
     {
-        printf("+");
-        for (int j = 0; j < segWidths[i]; j++)
-            printf("-");
+        outPuts("+");
+        outRepeat('-', segmentWidth(&history[i]));
     }
-    printf("+\n");
+    outPuts("+\n");
 
-    printf(" ");
-    printf("%d", history[0].startTime);
+    outPuts(" ");
+    outPrintf("%d", history[0].startTime);
     int currentPos = countDigits(history[0].startTime);
     int accumWidth = 0;
 
     for (int i = 0; i < historyIndex; i++)
     {
-        accumWidth += segWidths[i] + 1;
+        accumWidth += segmentWidth(&history[i]) + 1;
         int nextTime = history[i].endTime;
         int spacesNeeded = accumWidth - currentPos;
         if (spacesNeeded < 1)
             spacesNeeded = 1;
 
-        for (int s = 0; s < spacesNeeded; s++)
-            printf(" ");
-        printf("%d", nextTime);
+        outRepeat(' ', spacesNeeded);
+        outPrintf("%d", nextTime);
         currentPos += spacesNeeded + countDigits(nextTime);
     }
-    printf("\n");
+    outPuts("\n");
+    releaseOutput();
 }
 
-void displaySchedulingTable(Process p[], int n)
+void displaySchedulingTable(Process p[], int n, const SchedTrace *trace)
 {
+    holdOutput();
     float avg_wt = 0, avg_tat = 0;
     printLine(78);
-    printf(CYAN "| %-5s | %-10s | %-10s | %-10s | %-15s | %-12s |\n" RESET,
-           "ID", "Arrival", "Burst", "Priority", "Turnaround", "Waiting");
+    outPrintf(CYAN "| %-5s | %-10s | %-10s | %-10s | %-15s | %-12s |\n" RESET,
+              "ID", "Arrival", "Burst", "Priority", "Turnaround", "Waiting");
     printLine(78);
 
     for (int i = 0; i < n; i++)
     {
-        printf("| P%-4d | %-10d | %-10d | %-10d | %-15d | %-12d |\n",
-               p[i].id, p[i].at, p[i].bt, p[i].pr, p[i].tat, p[i].wt);
+        outPrintf("| P%-4d | %-10d | %-10d | %-10d | %-15d | %-12d |\n",
+                  p[i].id, p[i].at, p[i].bt, p[i].pr, p[i].tat, p[i].wt);
         avg_wt += p[i].wt;
         avg_tat += p[i].tat;
     }
     printLine(78);
-    printf(YELLOW "\nAverage Waiting Time: %.2f\n", avg_wt / (float)n);
-    printf("Average Turnaround Time: %.2f\n" RESET, avg_tat / (float)n);
-    printGanttChart();
+    outPrintf(YELLOW "\nAverage Waiting Time: %.2f\n", avg_wt / (float)n);
+    outPrintf("Average Turnaround Time: %.2f\n", avg_tat / (float)n);
+    outPrintf("Context Switches: %d\n" RESET, trace->contextSwitches);
+    printGanttChart(trace);
+    releaseOutput();
 }
 
 void calculateMetrics(Process p[], int n)
@@ -120,17 +167,101 @@ void calculateMetrics(Process p[], int n)
     }
 }
 
-void runFCFS(Process p[], int n)
+// ==========================================
+//      ARRIVAL ORDERING
+// ==========================================
+
+// Arrival stream entry: processes are admitted in (arrival, index) order
+typedef struct
 {
-    historyIndex = 0;
-    for (int i = 0; i < n - 1; i++)
-        for (int j = 0; j < n - i - 1; j++)
-            if (p[j].at > p[j + 1].at)
-            {
-                Process t = p[j];
-                p[j] = p[j + 1];
-                p[j + 1] = t;
-            }
+    int at;
+    int idx;
+} ArrivalKey;
+
+bool isSortedByArrival(const Process p[], int n)
+{
+    for (int i = 1; i < n; i++)
+        if (p[i - 1].at > p[i].at)
+            return false;
+    return true;
+}
+
+/**
+ * Stable LSD radix sort of compact (arrival, index) keys, one byte per pass.
+ * Passes where every key shares the same byte are skipped, so small arrival
+ * ranges cost a single counting pass. O(n) time, O(n) scratch.
+ */
+static void radixSortArrival(ArrivalKey keys[], int n)
+{
+    ArrivalKey *scratch = safeMalloc(n * sizeof(ArrivalKey));
+    ArrivalKey *src = keys, *dst = scratch;
+
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+        int count[257] = {0};
+        for (int i = 0; i < n; i++)
+        {
+            // Flip the sign bit so negative arrivals order before positive ones
+            unsigned int key = (unsigned int)src[i].at ^ 0x80000000u;
+            count[((key >> shift) & 0xFF) + 1]++;
+        }
+        bool trivial = false;
+        for (int b = 1; b <= 256; b++)
+            if (count[b] == n)
+                trivial = true;
+        if (trivial)
+            continue;
+
+        for (int b = 0; b < 256; b++)
+            count[b + 1] += count[b];
+        for (int i = 0; i < n; i++)
+        {
+            unsigned int key = (unsigned int)src[i].at ^ 0x80000000u;
+            dst[count[(key >> shift) & 0xFF]++] = src[i];
+        }
+        ArrivalKey *t = src;
+        src = dst;
+        dst = t;
+    }
+
+    if (src != keys)
+        memcpy(keys, src, n * sizeof(ArrivalKey));
+    free(scratch);
+}
+
+// Fills order[] with the (arrival, index)-sorted admission sequence of p[].
+// Already-sorted input (the common case, see sortByArrival) costs one O(n) check.
+static void buildArrivalOrder(const Process p[], int n, ArrivalKey order[])
+{
+    for (int i = 0; i < n; i++)
+    {
+        order[i].at = p[i].at;
+        order[i].idx = i;
+    }
+    if (!isSortedByArrival(p, n))
+        radixSortArrival(order, n);
+}
+
+// Stable sort of p[] by arrival: sort the keys, then move every struct exactly once
+void sortByArrival(Process p[], int n)
+{
+    ArrivalKey *order = safeMalloc(n * sizeof(ArrivalKey));
+    buildArrivalOrder(p, n, order);
+
+    Process *sorted = safeMalloc(n * sizeof(Process));
+    for (int i = 0; i < n; i++)
+        sorted[i] = p[order[i].idx];
+    memcpy(p, sorted, n * sizeof(Process));
+
+    free(sorted);
+    free(order);
+}
+
+void scheduleFCFS(Process p[], int n, SchedTrace *trace)
+{
+    resetTrace(trace);
+    if (!isSortedByArrival(p, n))
+        sortByArrival(p, n);
 
     int time = 0;
     for (int i = 0; i < n; i++)
@@ -140,167 +271,299 @@ void runFCFS(Process p[], int n)
         int start = time;
         time += p[i].bt;
         p[i].ct = time;
-        addToHistory(p[i].id, start, time);
+        addToHistory(trace, p[i].id, start, time);
     }
     calculateMetrics(p, n);
+}
+
+void runFCFS(Process p[], int n, SchedTrace *trace)
+{
+    scheduleFCFS(p, n, trace);
     printHeader("FCFS Results");
-    displaySchedulingTable(p, n);
+    displaySchedulingTable(p, n, trace);
 }
 
-void runSJF(Process p[], int n)
+// ==========================================
+//      EVENT-DRIVEN SHORTEST-FIRST ENGINE
+// ==========================================
+
+// Ready queue: binary min-heap of process indices keyed on remaining burst
+typedef struct
 {
-    historyIndex = 0;
-    int completed = 0, time = 0;
-    bool isCompleted[100] = {false};
+    int *idx;
+    int size;
+} ReadyHeap;
 
-    while (completed != n)
+// Shorter remaining burst first; ties go to the lower index, exactly like the old linear scan
+static bool readyBefore(Process p[], int a, int b)
+{
+    if (p[a].rem_bt != p[b].rem_bt)
+        return p[a].rem_bt < p[b].rem_bt;
+    return a < b;
+}
+
+static void heapPush(ReadyHeap *h, Process p[], int i)
+{
+    int pos = h->size++;
+    while (pos > 0)
     {
-        int idx = -1, minBt = INT_MAX;
-        for (int i = 0; i < n; i++)
-        {
-            if (p[i].at <= time && !isCompleted[i] && p[i].bt < minBt)
-            {
-                minBt = p[i].bt;
-                idx = i;
-            }
-        }
-        if (idx != -1)
-        {
-            int start = time;
-            time += p[idx].bt;
-            p[idx].ct = time;
-            isCompleted[idx] = true;
-            completed++;
-            addToHistory(p[idx].id, start, time);
-        }
-        else
-            time++;
+        int parent = (pos - 1) / 2;
+        if (!readyBefore(p, i, h->idx[parent]))
+            break;
+        h->idx[pos] = h->idx[parent];
+        pos = parent;
     }
-    calculateMetrics(p, n);
-    printHeader("SJF Results");
-    displaySchedulingTable(p, n);
+    h->idx[pos] = i;
 }
 
-void runStandardSRTF(Process p[], int n)
+static int heapPop(ReadyHeap *h, Process p[])
 {
-    historyIndex = 0;
-    int completed = 0, time = 0, minRem = INT_MAX, shortest = -1;
-    bool check = false;
+    int top = h->idx[0];
+    int last = h->idx[--h->size];
+    int pos = 0;
+    while (1)
+    {
+        int child = 2 * pos + 1;
+        if (child >= h->size)
+            break;
+        if (child + 1 < h->size && readyBefore(p, h->idx[child + 1], h->idx[child]))
+            child++;
+        if (!readyBefore(p, h->idx[child], last))
+            break;
+        h->idx[pos] = h->idx[child];
+        pos = child;
+    }
+    if (h->size > 0)
+        h->idx[pos] = last;
+    return top;
+}
+
+/**
+ * Shared engine for SJF (non-preemptive) and SRTF (preemptive).
+ * Time jumps straight between events (arrivals and completions) instead of
+ * ticking, so the cost is O((n + preemptions) log n) regardless of burst size.
+ */
+static void simulateShortestFirst(Process p[], int n, bool preemptive, SchedTrace *trace)
+{
+    ArrivalKey *order = safeMalloc(n * sizeof(ArrivalKey));
+    ReadyHeap ready = {safeMalloc(n * sizeof(int)), 0};
+
     for (int i = 0; i < n; i++)
         p[i].rem_bt = p[i].bt;
+    buildArrivalOrder(p, n, order);
 
+    int next = 0, completed = 0, time = 0, running = -1, segStart = 0;
     while (completed != n)
     {
-        for (int i = 0; i < n; i++)
+        while (next < n && order[next].at <= time)
+            heapPush(&ready, p, order[next++].idx);
+
+        if (running == -1)
         {
-            if ((p[i].at <= time) && (p[i].rem_bt < minRem) && (p[i].rem_bt > 0))
+            if (ready.size == 0)
             {
-                minRem = p[i].rem_bt;
-                shortest = i;
-                check = true;
+                time = order[next].at; // CPU idle: skip ahead to the next arrival
+                continue;
             }
+            running = heapPop(&ready, p);
+            segStart = time;
         }
-        if (!check)
+        else if (preemptive && ready.size > 0 && p[ready.idx[0]].rem_bt < p[running].rem_bt)
         {
-            time++;
-            continue;
+            addToHistory(trace, p[running].id, segStart, time);
+            heapPush(&ready, p, running);
+            running = heapPop(&ready, p);
+            segStart = time;
         }
 
-        p[shortest].rem_bt--;
-        addToHistory(p[shortest].id, time, time + 1);
-        minRem = p[shortest].rem_bt;
-        if (minRem == 0)
-            minRem = INT_MAX;
-        time++;
-        if (p[shortest].rem_bt == 0)
+        int finish = time + p[running].rem_bt;
+        if (preemptive && next < n && order[next].at < finish)
         {
-            completed++;
-            check = false;
-            p[shortest].ct = time;
+            // Run only up to the next arrival, which may preempt us
+            p[running].rem_bt -= order[next].at - time;
+            time = order[next].at;
+            continue;
         }
+
+        time = finish;
+        p[running].rem_bt = 0;
+        p[running].ct = time;
+        addToHistory(trace, p[running].id, segStart, time);
+        completed++;
+        running = -1;
     }
+
+    free(order);
+    free(ready.idx);
+}
+
+void scheduleSJF(Process p[], int n, SchedTrace *trace)
+{
+    resetTrace(trace);
+    simulateShortestFirst(p, n, false, trace);
     calculateMetrics(p, n);
+}
+
+void scheduleSRTF(Process p[], int n, SchedTrace *trace)
+{
+    resetTrace(trace);
+    simulateShortestFirst(p, n, true, trace);
+    calculateMetrics(p, n);
+}
+
+void runSJF(Process p[], int n, SchedTrace *trace)
+{
+    scheduleSJF(p, n, trace);
+    printHeader("SJF Results");
+    displaySchedulingTable(p, n, trace);
+}
+
+void runStandardSRTF(Process p[], int n, SchedTrace *trace)
+{
+    scheduleSRTF(p, n, trace);
     printHeader("SRTF Results");
-    displaySchedulingTable(p, n);
+    displaySchedulingTable(p, n, trace);
 }
 
-void runRoundRobin(Process p[], int n, int quantum)
+// ==========================================
+//      ROUND ROBIN (RING-BUFFER RUN QUEUE)
+// ==========================================
+
+void initRunQueue(RunQueue *q, int capacity)
 {
-    historyIndex = 0;
+    q->slots = safeMalloc(capacity * sizeof(int));
+    q->capacity = capacity;
+    q->head = 0;
+    q->count = 0;
+}
+
+void freeRunQueue(RunQueue *q)
+{
+    free(q->slots);
+    q->slots = NULL;
+    q->capacity = q->count = 0;
+}
+
+void enqueueRun(RunQueue *q, int idx)
+{
+    int tail = q->head + q->count;
+    if (tail >= q->capacity)
+        tail -= q->capacity;
+    q->slots[tail] = idx;
+    q->count++;
+}
+
+int dequeueRun(RunQueue *q)
+{
+    int idx = q->slots[q->head];
+    if (++q->head == q->capacity)
+        q->head = 0;
+    q->count--;
+    return idx;
+}
+
+void scheduleRoundRobin(Process p[], int n, int quantum, SchedTrace *trace)
+{
+    resetTrace(trace);
     int remProc = n, time = 0;
     for (int i = 0; i < n; i++)
         p[i].rem_bt = p[i].bt;
-    // Sort by Arrival first
-    for (int i = 0; i < n - 1; i++)
-        for (int j = 0; j < n - i - 1; j++)
-            if (p[j].at > p[j + 1].at)
-            {
-                Process t = p[j];
-                p[j] = p[j + 1];
-                p[j + 1] = t;
-            }
+    if (!isSortedByArrival(p, n))
+        sortByArrival(p, n);
+
+    // FIFO ready queue; each process is queued at most once, so n slots suffice
+    RunQueue ready;
+    initRunQueue(&ready, n);
+    int next = 0;
 
     while (remProc > 0)
     {
-        bool done = false;
-        for (int i = 0; i < n; i++)
+        while (next < n && p[next].at <= time)
+            enqueueRun(&ready, next++);
+        if (ready.count == 0)
         {
-            if (p[i].rem_bt > 0 && p[i].at <= time)
+            time = p[next].at; // CPU idle: jump to the next arrival
+            continue;
+        }
+
+        int i = dequeueRun(&ready);
+        int exec = (p[i].rem_bt > quantum) ? quantum : p[i].rem_bt;
+        if (ready.count == 0)
+        {
+            // Alone on the CPU: run every quantum up to the next arrival in one step
+            long long limit = p[i].rem_bt;
+            if (next < n)
             {
-                done = true;
-                int exec = (p[i].rem_bt > quantum) ? quantum : p[i].rem_bt;
-                addToHistory(p[i].id, time, time + exec);
-                time += exec;
-                p[i].rem_bt -= exec;
-                if (p[i].rem_bt == 0)
-                {
-                    p[i].ct = time;
-                    remProc--;
-                }
+                long long slices = ((long long)p[next].at - time + quantum - 1) / quantum;
+                if (slices * quantum < limit)
+                    limit = slices * quantum;
             }
+            if (limit > exec)
+                exec = (int)limit;
+        }
+
+        addToHistory(trace, p[i].id, time, time + exec);
+        time += exec;
+        p[i].rem_bt -= exec;
+
+        // Processes that arrived during the slice queue ahead of the preempted one
+        while (next < n && p[next].at <= time)
+            enqueueRun(&ready, next++);
+        if (p[i].rem_bt > 0)
+            enqueueRun(&ready, i);
+        else
+        {
+            p[i].ct = time;
+            remProc--;
         }
-        if (!done)
-            time++;
     }
+    freeRunQueue(&ready);
     calculateMetrics(p, n);
+}
+
+void runRoundRobin(Process p[], int n, int quantum, SchedTrace *trace)
+{
+    scheduleRoundRobin(p, n, quantum, trace);
     printHeader("Round Robin Results");
-    displaySchedulingTable(p, n);
+    displaySchedulingTable(p, n, trace);
 }
 
 // --- Interactive Mode for CPU ---
 void printDashboard(int time, int runningID, Process p[], int n, char *explanation)
 {
-    system(CLEAR_SCREEN);
+    beginFrame();
     printHeader("INTERACTIVE TEACHING MODE");
-    printf(CYAN " Current Time: " RESET "%d\n\n", time);
+    outPrintf(CYAN " Current Time: " RESET "%d\n\n", time);
 
-    printf("  +-------+        \n");
+    outPuts("  +-------+        \n");
     if (runningID != -1)
-        printf("  |  P%d   | <--- " GREEN "RUNNING" RESET "\n", runningID);
+        outPrintf("  |  P%d   | <--- " GREEN "RUNNING" RESET "\n", runningID);
     else
-        printf("  | IDLE  | <--- " RED "IDLE" RESET "\n");
-    printf("  +-------+        \n\n");
+        outPuts("  | IDLE  | <--- " RED "IDLE" RESET "\n");
+    outPuts("  +-------+        \n\n");
 
-    printf("  " YELLOW "Ready Queue: " RESET "[ ");
+    outPuts("  " YELLOW "Ready Queue: " RESET "[ ");
     bool anyReady = false;
     for (int i = 0; i < n; i++)
     {
         if (p[i].at <= time && p[i].rem_bt > 0 && p[i].id != runningID)
         {
-            printf("P%d(%d) ", p[i].id, p[i].rem_bt);
+            outPrintf("P%d(%d) ", p[i].id, p[i].rem_bt);
             anyReady = true;
         }
     }
     if (!anyReady)
-        printf("Empty ");
-    printf("]\n\n");
+        outPuts("Empty ");
+    outPuts("]\n\n");
 
-    printf(MAGENTA "  LOGIC EXPLAINER:" RESET "\n  %s\n", explanation);
+    outPrintf(MAGENTA "  LOGIC EXPLAINER:" RESET "\n  %s\n", explanation);
     printLine(60);
+    endFrame();
 }
 
-void runInteractiveSRTF(Process p[], int n)
+void runInteractiveSRTF(Process p[], int n, SchedTrace *trace)
 {
+    resetTrace(trace);
     for (int i = 0; i < n; i++)
         p[i].rem_bt = p[i].bt;
     int completed = 0, currentTime = 0, prevProcess = -1;
@@ -339,6 +602,7 @@ void runInteractiveSRTF(Process p[], int n)
             waitForInput();
 
             p[idx].rem_bt--;
+            addToHistory(trace, p[idx].id, currentTime, currentTime + 1);
             prevProcess = idx;
             if (p[idx].rem_bt == 0)
             {
@@ -356,7 +620,7 @@ void runInteractiveSRTF(Process p[], int n)
         currentTime++;
     }
     calculateMetrics(p, n);
-    system(CLEAR_SCREEN);
+    clearScreen();
     printHeader("Interactive Session Finished");
-    displaySchedulingTable(p, n);
+    displaySchedulingTable(p, n, trace);
 }
\ No newline at end of file
@@ -17,24 +17,66 @@ typedef struct
     int endTime;
 } GanttSegment;
 
-// --- Shared Variables ---
-extern GanttSegment history[1000];
-extern int historyIndex;
+/**
+ * Growable Gantt trace owned by a single simulation run.
+ * Passing it explicitly (instead of a global array) lets several schedules
+ * be computed at once, even on different threads, and lets a caller reuse
+ * one allocation across runs.
+ */
+typedef struct
+{
+    GanttSegment *segments;
+    int count;
+    int capacity;
+    int contextSwitches; // times the CPU passed from one process to another
+} SchedTrace;
+
+// FIFO ready queue on a fixed ring buffer: O(1) enqueue and dequeue
+typedef struct
+{
+    int *slots;
+    int capacity;
+    int head;
+    int count;
+} RunQueue;
+
+// --- Trace Management ---
+void initTrace(SchedTrace *trace);
+void reserveTrace(SchedTrace *trace, int capacity);
+void resetTrace(SchedTrace *trace);
+void freeTrace(SchedTrace *trace);
+
+// --- Run Queue ---
+void initRunQueue(RunQueue *q, int capacity);
+void freeRunQueue(RunQueue *q);
+void enqueueRun(RunQueue *q, int idx);
+int dequeueRun(RunQueue *q);
+
+// --- Arrival Ordering ---
+// Sorting a workload once up front lets every algorithm skip its own sort
+bool isSortedByArrival(const Process p[], int n);
+void sortByArrival(Process p[], int n);
 
 // --- Function Prototypes ---
-void addToHistory(int pid, int start, int end);
-void printGanttChart();
-void displaySchedulingTable(Process p[], int n);
+void addToHistory(SchedTrace *trace, int pid, int start, int end);
+void printGanttChart(const SchedTrace *trace);
+void displaySchedulingTable(Process p[], int n, const SchedTrace *trace);
 void calculateMetrics(Process p[], int n);
 
-// Algorithms
-void runFCFS(Process p[], int n);
-void runSJF(Process p[], int n);
-void runStandardSRTF(Process p[], int n);
-void runRoundRobin(Process p[], int n, int quantum);
+// Simulation only: fill in p[] and the trace, print nothing (thread-safe)
+void scheduleFCFS(Process p[], int n, SchedTrace *trace);
+void scheduleSJF(Process p[], int n, SchedTrace *trace);
+void scheduleSRTF(Process p[], int n, SchedTrace *trace);
+void scheduleRoundRobin(Process p[], int n, int quantum, SchedTrace *trace);
+
+// Algorithms (simulate, then print the results table and Gantt chart)
+void runFCFS(Process p[], int n, SchedTrace *trace);
+void runSJF(Process p[], int n, SchedTrace *trace);
+void runStandardSRTF(Process p[], int n, SchedTrace *trace);
+void runRoundRobin(Process p[], int n, int quantum, SchedTrace *trace);
 
 // Interactive Mode
 void printDashboard(int time, int runningID, Process p[], int n, char *explanation);
-void runInteractiveSRTF(Process p[], int n);
+void runInteractiveSRTF(Process p[], int n, SchedTrace *trace);
 
 #endif
\ No newline at end of file
@@ -20,20 +20,20 @@ void initDining()
 
 void displayDiningTable()
 {
-    system(CLEAR_SCREEN);
+    beginFrame();
     printHeader("DINING PHILOSOPHERS & DEADLOCK VISUALIZER");
 
-    printf(YELLOW "Instructions:" RESET " Manually control philosophers to understand Deadlock.\n");
-    printf("Create Deadlock: Make EVERY philosopher pick up their LEFT chopstick.\n\n");
+    outPuts(YELLOW "Instructions:" RESET " Manually control philosophers to understand Deadlock.\n");
+    outPuts("Create Deadlock: Make EVERY philosopher pick up their LEFT chopstick.\n\n");
 
-    printf("      (P0)       \n");
-    printf("     /    \\     \n");
-    printf("  (P4)    (P1)   \n");
-    printf("    \\      /    \n");
-    printf("   (P3)--(P2)    \n\n");
+    outPuts("      (P0)       \n");
+    outPuts("     /    \\     \n");
+    outPuts("  (P4)    (P1)   \n");
+    outPuts("    \\      /    \n");
+    outPuts("   (P3)--(P2)    \n\n");
 
     printLine(60);
-    printf("| %-3s | %-10s | %-12s | %-15s |\n", "ID", "State", "Left Stick", "Right Stick");
+    outPrintf("| %-3s | %-10s | %-12s | %-15s |\n", "ID", "State", "Left Stick", "Right Stick");
     printLine(60);
 
     for (int i = 0; i < 5; i++)
@@ -66,9 +66,109 @@ void displayDiningTable()
         else
             strcpy(stateStr, GREEN "EATING" RESET);
 
-        printf("| P%d  | %-18s | %-21s | %-24s |\n", i, stateStr, lStatus, rStatus);
+        outPrintf("| P%d  | %-18s | %-21s | %-24s |\n", i, stateStr, lStatus, rStatus);
     }
     printLine(60);
+    endFrame();
+}
+
+// Applies one menu action for philosopher p_id. Returns false if it failed
+// (stick busy, nothing to drop, invalid choice); msg receives the log line.
+bool applyDiningAction(int p_id, int choice, char *msg)
+{
+    bool accepted = false;
+    if (p_id < 0 || p_id > 4)
+    {
+        strcpy(msg, "Invalid Philosopher ID");
+        return false;
+    }
+    int left = p_id;
+    int right = (p_id + 1) % 5;
+
+    switch (choice)
+    {
+    case 1:
+        if (chopstick[left] == 0)
+        {
+            sprintf(msg, RED "FAILURE:" RESET " Left stick is held by P%d.", (p_id + 4) % 5);
+        }
+        else if (held_sticks[p_id] & 1)
+        {
+            sprintf(msg, YELLOW "INFO:" RESET " You already hold the left stick.");
+        }
+        else
+        {
+            chopstick[left] = 0;
+            held_sticks[p_id] |= 1;
+            p_state[p_id] = HUNGRY;
+            sprintf(msg, GREEN "SUCCESS:" RESET " P%d picked up Left stick.", p_id);
+            accepted = true;
+            if (held_sticks[p_id] == 3)
+                p_state[p_id] = EATING;
+        }
+        break;
+
+    case 2:
+        if (chopstick[right] == 0)
+        {
+            sprintf(msg, RED "FAILURE:" RESET " Right stick is held by P%d.", (p_id + 1) % 5);
+        }
+        else if (held_sticks[p_id] & 2)
+        {
+            sprintf(msg, YELLOW "INFO:" RESET " You already hold the right stick.");
+        }
+        else
+        {
+            chopstick[right] = 0;
+            held_sticks[p_id] |= 2;
+            p_state[p_id] = HUNGRY;
+            sprintf(msg, GREEN "SUCCESS:" RESET " P%d picked up Right stick.", p_id);
+            accepted = true;
+            if (held_sticks[p_id] == 3)
+                p_state[p_id] = EATING;
+        }
+        break;
+
+    case 3:
+        if (held_sticks[p_id] == 0)
+        {
+            sprintf(msg, YELLOW "INFO:" RESET " P%d holds nothing.", p_id);
+        }
+        else
+        {
+            if (held_sticks[p_id] & 1)
+                chopstick[left] = 1;
+            if (held_sticks[p_id] & 2)
+                chopstick[right] = 1;
+            held_sticks[p_id] = 0;
+            p_state[p_id] = THINKING;
+            sprintf(msg, GREEN "SUCCESS:" RESET " P%d dropped sticks and is Thinking.", p_id);
+            accepted = true;
+        }
+        break;
+    case 4:
+        strcpy(msg, "Action Cancelled.");
+        break;
+    default:
+        strcpy(msg, "Invalid Action.");
+    }
+    return accepted;
+}
+
+// Deadlock: all sticks held and nobody has both of theirs
+bool isDiningDeadlocked()
+{
+    int sticks_held = 0;
+    for (int i = 0; i < 5; i++)
+        if (chopstick[i] == 0)
+            sticks_held++;
+
+    if (sticks_held != 5)
+        return false;
+    for (int i = 0; i < 5; i++)
+        if (p_state[i] == EATING)
+            return false;
+    return true;
 }
 
 void runDiningPhilosophers()
@@ -100,91 +200,9 @@ void runDiningPhilosophers()
         printf("Selection: ");
         choice = getSafeInt();
 
-        int left = p_id;
-        int right = (p_id + 1) % 5;
-
-        switch (choice)
-        {
-        case 1:
-            if (chopstick[left] == 0)
-            {
-                sprintf(msg, RED "FAILURE:" RESET " Left stick is held by P%d.", (p_id + 4) % 5);
-            }
-            else if (held_sticks[p_id] & 1)
-            {
-                sprintf(msg, YELLOW "INFO:" RESET " You already hold the left stick.");
-            }
-            else
-            {
-                chopstick[left] = 0;
-                held_sticks[p_id] |= 1;
-                p_state[p_id] = HUNGRY;
-                sprintf(msg, GREEN "SUCCESS:" RESET " P%d picked up Left stick.", p_id);
-                if (held_sticks[p_id] == 3)
-                    p_state[p_id] = EATING;
-            }
-            break;
-
-        case 2:
-            if (chopstick[right] == 0)
-            {
-                sprintf(msg, RED "FAILURE:" RESET " Right stick is held by P%d.", (p_id + 1) % 5);
-            }
-            else if (held_sticks[p_id] & 2)
-            {
-                sprintf(msg, YELLOW "INFO:" RESET " You already hold the right stick.");
-            }
-            else
-            {
-                chopstick[right] = 0;
-                held_sticks[p_id] |= 2;
-                p_state[p_id] = HUNGRY;
-                sprintf(msg, GREEN "SUCCESS:" RESET " P%d picked up Right stick.", p_id);
-                if (held_sticks[p_id] == 3)
-                    p_state[p_id] = EATING;
-            }
-            break;
-
-        case 3:
-            if (held_sticks[p_id] == 0)
-            {
-                sprintf(msg, YELLOW "INFO:" RESET " P%d holds nothing.", p_id);
-            }
-            else
-            {
-                if (held_sticks[p_id] & 1)
-                    chopstick[left] = 1;
-                if (held_sticks[p_id] & 2)
-                    chopstick[right] = 1;
-                held_sticks[p_id] = 0;
-                p_state[p_id] = THINKING;
-                sprintf(msg, GREEN "SUCCESS:" RESET " P%d dropped sticks and is Thinking.", p_id);
-            }
-            break;
-        case 4:
-            strcpy(msg, "Action Cancelled.");
-            break;
-        default:
-            strcpy(msg, "Invalid Action.");
-        }
-
-        // Logic to detect DEADLOCK (All sticks held, no one eating)
-        int sticks_held = 0;
-        for (int i = 0; i < 5; i++)
-            if (chopstick[i] == 0)
-                sticks_held++;
+        applyDiningAction(p_id, choice, msg);
 
-        if (sticks_held == 5)
-        {
-            bool anyone_eating = false;
-            for (int i = 0; i < 5; i++)
-                if (p_state[i] == EATING)
-                    anyone_eating = true;
-
-            if (!anyone_eating)
-            {
-                strcat(msg, RED " [DEADLOCK DETECTED! Everyone waiting]" RESET);
-            }
-        }
+        if (isDiningDeadlocked())
+            strcat(msg, RED " [DEADLOCK DETECTED! Everyone waiting]" RESET);
     }
-}
\ No newline at end of file
+}
@@ -11,6 +11,12 @@
 // --- Function Prototypes ---
 void initDining();
 void displayDiningTable();
+bool applyDiningAction(int p_id, int choice, char *msg);
+bool isDiningDeadlocked();
 void runDiningPhilosophers();
 
+// Table state (index = philosopher / chopstick)
+extern int chopstick[5];
+extern int p_state[5];
+
 #endif
\ No newline at end of file
@@ -0,0 +1,246 @@
+#include "disk_device.h"
+
+// ==========================================
+//      CONFIGURATION
+// ==========================================
+
+void defaultDeviceConfig(DeviceConfig *cfg, DeviceKind kind)
+{
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->kind = kind;
+    cfg->heads = 4;
+    cfg->sectorsPerTrack = 250; // 4 KiB blocks: 1000 per cylinder
+    cfg->settleUs = 1000;
+    cfg->fullStrokeUs = 8000;
+    cfg->transferUs = 4000; // half a turn at 7200 rpm plus the transfer
+    cfg->rpm = 7200;
+    cfg->trackToTrackUs = 800;
+    cfg->fullSeekUs = 15000; // about 9 ms across a third of the disk, a typical average seek
+    cfg->channels = 8;
+    cfg->diesPerChannel = 4;
+    cfg->pagesPerBlock = 64;
+    cfg->queueDepth = 32;
+    cfg->readUs = 50;
+    cfg->programUs = 500;
+    cfg->eraseUs = 3000;
+    cfg->pageTransferUs = 10; // 4 KiB at 400 MB/s
+}
+
+const char *deviceKindName(DeviceKind kind)
+{
+    static const char *names[] = {"Linear", "HDD", "SSD"};
+    if (kind < DEVICE_LINEAR || kind > DEVICE_KIND_COUNT)
+        return "?";
+    return names[kind - 1];
+}
+
+int sectorsPerCylinder(const DeviceConfig *cfg)
+{
+    return cfg->heads * cfg->sectorsPerTrack;
+}
+
+// ==========================================
+//      LINEAR SEEK MODEL
+// ==========================================
+
+typedef struct
+{
+    DeviceConfig cfg;
+    long long cylinders;
+    long long freeAt; // when the arm finishes its current request
+} LinearDevice;
+
+static long long linearSubmit(void *self, const IoRequest *r, long long travel, long long now)
+{
+    (void)r;
+    LinearDevice *d = self;
+    long long t = (now > d->freeAt) ? now : d->freeAt;
+    if (travel > 0)
+        t += d->cfg.settleUs + (long long)((double)d->cfg.fullStrokeUs * travel / d->cylinders);
+    d->freeAt = t + d->cfg.transferUs * r->length;
+    return d->freeAt;
+}
+
+static const DiskDeviceOps linearOps = {"Linear", linearSubmit, free};
+
+// ==========================================
+//      HARD DISK
+// ==========================================
+
+typedef struct
+{
+    DeviceConfig cfg;
+    long long cylinders;
+    double rotationUs, sectorUs;
+    double freeAt; // kept exact, so back-to-back sectors need no extra turn
+} HddDevice;
+
+static double hddSeekTime(const HddDevice *d, long long travel)
+{
+    if (travel <= 0)
+        return 0;
+    double span = (d->cylinders > 2) ? (double)(d->cylinders - 2) : 1.0;
+    double reach = (double)(travel - 1) / span; // above 1 for C-SCAN's return trip
+    return d->cfg.trackToTrackUs + (d->cfg.fullSeekUs - d->cfg.trackToTrackUs) * sqrt(reach);
+}
+
+static long long hddSubmit(void *self, const IoRequest *r, long long travel, long long now)
+{
+    HddDevice *d = self;
+    // The clock outside the device keeps whole microseconds: a request that comes within
+    // one of the arm falling idle starts exactly then, so back-to-back blocks need no extra turn
+    double t = ((double)now >= d->freeAt + 1.0) ? (double)now : d->freeAt;
+    t += hddSeekTime(d, travel);
+
+    double due = (r->sector % d->cfg.sectorsPerTrack) * d->sectorUs;
+    double wait = fmod(due - fmod(t, d->rotationUs) + d->rotationUs, d->rotationUs);
+    if (wait > d->rotationUs - 1e-6)
+        wait = 0; // rounding error on a block due right now
+    d->freeAt = t + wait + r->length * d->sectorUs;
+    return (long long)ceil(d->freeAt);
+}
+
+static const DiskDeviceOps hddOps = {"HDD", hddSubmit, free};
+
+// ==========================================
+//      SOLID-STATE DRIVE
+// ==========================================
+
+typedef struct
+{
+    DeviceConfig cfg;
+    int dies, nextDie;
+    int blocksPerCylinder;
+    long long *dieFree, *channelFree;
+    long long *programs; // pages programmed per die, for the erase every pagesPerBlock
+} SsdDevice;
+
+static uint64_t hashBlock(long long key)
+{
+    uint64_t x = (uint64_t)key;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+static long long ssdSubmit(void *self, const IoRequest *r, long long travel, long long now)
+{
+    (void)travel;
+    SsdDevice *d = self;
+    long long block = r->cylinder * d->blocksPerCylinder + r->sector, done = now;
+    for (int page = 0; page < r->length; page++)
+    {
+        int die = (int)(hashBlock(block + page) % (uint64_t)d->dies);
+        if (r->op == IO_WRITE)
+        {
+            die = d->nextDie;
+            d->nextDie = (d->nextDie + 1) % d->dies;
+        }
+        int channel = die % d->cfg.channels;
+        long long end;
+        if (r->op == IO_READ)
+        {
+            long long sensed = ((now > d->dieFree[die]) ? now : d->dieFree[die]) + d->cfg.readUs;
+            long long bus = (sensed > d->channelFree[channel]) ? sensed : d->channelFree[channel];
+            end = bus + d->cfg.pageTransferUs;
+            d->channelFree[channel] = end;
+        }
+        else
+        {
+            long long bus = (now > d->channelFree[channel]) ? now : d->channelFree[channel];
+            d->channelFree[channel] = bus + d->cfg.pageTransferUs;
+            long long start = (d->channelFree[channel] > d->dieFree[die]) ? d->channelFree[channel] : d->dieFree[die];
+            end = start + d->cfg.programUs;
+            if (++d->programs[die] % d->cfg.pagesPerBlock == 0)
+                end += d->cfg.eraseUs; // the die reclaims a block before taking more writes
+        }
+        d->dieFree[die] = end;
+        if (end > done)
+            done = end;
+    }
+    return done;
+}
+
+static void ssdDestroy(void *self)
+{
+    SsdDevice *d = self;
+    free(d->dieFree);
+    free(d->channelFree);
+    free(d->programs);
+    free(d);
+}
+
+static const DiskDeviceOps ssdOps = {"SSD", ssdSubmit, ssdDestroy};
+
+// ==========================================
+//      DEVICE LIFECYCLE
+// ==========================================
+
+bool createDiskDevice(const DeviceConfig *cfg, long long cylinders, DiskDevice *out, char *error, size_t errorSize)
+{
+    if (cfg->kind < DEVICE_LINEAR || cfg->kind > DEVICE_KIND_COUNT)
+        snprintf(error, errorSize, "unknown device model %d", (int)cfg->kind);
+    else if (cylinders < 1 || cfg->heads < 1 || cfg->sectorsPerTrack < 1 ||
+             (long long)cfg->heads * cfg->sectorsPerTrack > INT_MAX)
+        snprintf(error, errorSize, "the disk needs at least one cylinder, head and sector per track");
+    else if (cfg->kind == DEVICE_LINEAR && (cfg->settleUs < 0 || cfg->fullStrokeUs < 0 || cfg->transferUs < 0))
+        snprintf(error, errorSize, "linear service times must be non-negative");
+    else if (cfg->kind == DEVICE_HDD &&
+             (cfg->rpm < 1 || cfg->trackToTrackUs < 0 || cfg->fullSeekUs < cfg->trackToTrackUs))
+        snprintf(error, errorSize, "an HDD needs a positive rpm and 0 <= track-to-track <= full seek");
+    else if (cfg->kind == DEVICE_SSD &&
+             (cfg->channels < 1 || cfg->diesPerChannel < 1 || cfg->pagesPerBlock < 1 || cfg->queueDepth < 1 ||
+              cfg->readUs < 0 || cfg->programUs < 0 || cfg->eraseUs < 0 || cfg->pageTransferUs < 0))
+        snprintf(error, errorSize, "an SSD needs channels, dies, pages per block and queue depth >= 1");
+    else
+    {
+        out->queueDepth = 1;
+        if (cfg->kind == DEVICE_LINEAR)
+        {
+            LinearDevice *d = safeMalloc(sizeof(LinearDevice));
+            d->cfg = *cfg;
+            d->cylinders = cylinders;
+            d->freeAt = 0;
+            out->ops = &linearOps;
+            out->self = d;
+        }
+        else if (cfg->kind == DEVICE_HDD)
+        {
+            HddDevice *d = safeMalloc(sizeof(HddDevice));
+            d->cfg = *cfg;
+            d->cylinders = cylinders;
+            d->rotationUs = 60e6 / cfg->rpm;
+            d->sectorUs = d->rotationUs / cfg->sectorsPerTrack;
+            d->freeAt = 0;
+            out->ops = &hddOps;
+            out->self = d;
+        }
+        else
+        {
+            SsdDevice *d = safeMalloc(sizeof(SsdDevice));
+            d->cfg = *cfg;
+            d->dies = cfg->channels * cfg->diesPerChannel;
+            d->nextDie = 0;
+            d->blocksPerCylinder = sectorsPerCylinder(cfg);
+            d->dieFree = calloc(d->dies, sizeof(long long));
+            d->channelFree = calloc(cfg->channels, sizeof(long long));
+            d->programs = calloc(d->dies, sizeof(long long));
+            if (d->dieFree == NULL || d->channelFree == NULL || d->programs == NULL)
+            {
+                printf(RED "\nFatal: out of memory in SSD model\n" RESET);
+                exit(EXIT_FAILURE);
+            }
+            out->ops = &ssdOps;
+            out->self = d;
+            out->queueDepth = cfg->queueDepth;
+        }
+        return true;
+    }
+    return false;
+}
+
+void destroyDiskDevice(DiskDevice *device)
+{
+    device->ops->destroy(device->self);
+    device->self = NULL;
+}
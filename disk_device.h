@@ -0,0 +1,97 @@
+#ifndef DISK_DEVICE_H
+#define DISK_DEVICE_H
+
+#include "utils.h"
+
+// --- Structures ---
+typedef enum
+{
+    IO_READ = 0,
+    IO_WRITE = 1
+} IoOp;
+
+// One block I/O; times are in simulated microseconds
+typedef struct
+{
+    long long arrival;
+    long long cylinder;
+    long long deadline; // relative to arrival; 0 = none
+    int sector;         // block within the cylinder; fixes the rotational position on an HDD
+    int process;
+    int length; // blocks; the budget policy charges processes by length
+    IoOp op;
+} IoRequest;
+
+typedef enum
+{
+    DEVICE_LINEAR = 1,
+    DEVICE_HDD = 2,
+    DEVICE_SSD = 3
+} DeviceKind;
+
+#define DEVICE_KIND_COUNT 3
+
+/**
+ * What serving a request costs. Every model shares the geometry: a
+ * cylinder holds heads x sectorsPerTrack blocks, and block b of a
+ * cylinder sits at angle b % sectorsPerTrack.
+ *
+ * - Linear: settle + fullStroke * distance / cylinders for any move, plus
+ *   a fixed transfer for every block. The textbook model; one request at
+ *   a time, and a merged request costs what its blocks would separately.
+ * - HDD: seek time grows with the square root of the distance, from
+ *   trackToTrack for one cylinder to fullSeek across the disk. The
+ *   platter then turns until the block comes round, and each block takes
+ *   1/sectorsPerTrack of a turn to pass under the head. One at a time.
+ * - SSD: channels x diesPerChannel dies working in parallel, up to
+ *   queueDepth requests in flight. A read senses the page on its die,
+ *   then moves it over the die's channel; a write moves the page first and
+ *   then programs it, and every pagesPerBlock programs on a die cost an
+ *   erase. Writes go to the dies round robin, as a log-structured FTL
+ *   would place them; reads find their page where a hash of the block
+ *   puts it. Distance costs nothing.
+ */
+typedef struct
+{
+    DeviceKind kind;
+    int heads, sectorsPerTrack;
+    long long settleUs, fullStrokeUs, transferUs; // linear
+    int rpm;                                      // HDD
+    long long trackToTrackUs, fullSeekUs;
+    int channels, diesPerChannel, pagesPerBlock, queueDepth; // SSD
+    long long readUs, programUs, eraseUs, pageTransferUs;
+} DeviceConfig;
+
+/**
+ * A device in use. `submit` hands it request r at time `now`, after the
+ * arm has covered `travel` cylinders to reach it, and returns when the
+ * request completes. The device queues internally: a request submitted
+ * while the arm, a die or a channel is busy starts once it is free.
+ */
+typedef struct
+{
+    const char *name;
+    long long (*submit)(void *self, const IoRequest *r, long long travel, long long now);
+    void (*destroy)(void *self);
+} DiskDeviceOps;
+
+typedef struct
+{
+    const DiskDeviceOps *ops;
+    void *self;
+    int queueDepth; // requests the scheduler may keep in flight at once
+} DiskDevice;
+
+// --- Function Prototypes ---
+void defaultDeviceConfig(DeviceConfig *cfg, DeviceKind kind);
+const char *deviceKindName(DeviceKind kind);
+int sectorsPerCylinder(const DeviceConfig *cfg);
+
+/**
+ * Builds the device described by cfg for a disk of `cylinders`. Returns
+ * false with `error` filled if the configuration makes no sense.
+ */
+bool createDiskDevice(const DeviceConfig *cfg, long long cylinders, DiskDevice *out, char *error, size_t errorSize);
+void destroyDiskDevice(DiskDevice *device);
+
+#endif
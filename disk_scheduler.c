@@ -1,42 +1,404 @@
-
 #include "disk_scheduler.h"
+#include "disk_timed.h"
+#include "block_trace.h"
 
 // ==========================================
 //      MODULE 4: DISK SCHEDULING
 // ==========================================
 
+void defaultDiskConfig(DiskConfig *cfg)
+{
+    cfg->cylinders = 200;
+    cfg->up = true;
+}
+
+const char *diskPolicyName(DiskPolicy policy)
+{
+    static const char *names[] = {"FCFS", "SSTF", "SCAN", "C-SCAN", "LOOK", "C-LOOK", "Deadline", "Budget"};
+    return (policy >= DISK_FCFS && policy <= DISK_TIMED_POLICY_COUNT) ? names[policy - 1] : "unknown";
+}
+
+bool checkDiskRequests(long long head, const DiskConfig *cfg, const long long req[], int n, char *error,
+                       size_t errorSize)
+{
+    if (cfg->cylinders < 1)
+    {
+        snprintf(error, errorSize, "the disk needs at least one cylinder");
+        return false;
+    }
+    if (head < 0 || head >= cfg->cylinders)
+    {
+        snprintf(error, errorSize, "head %lld is off a disk of cylinders 0-%lld", head, cfg->cylinders - 1);
+        return false;
+    }
+    for (int i = 0; i < n; i++)
+        if (req[i] < 0 || req[i] >= cfg->cylinders)
+        {
+            snprintf(error, errorSize, "request %d (cylinder %lld) is off a disk of cylinders 0-%lld", i + 1, req[i],
+                     cfg->cylinders - 1);
+            return false;
+        }
+    return true;
+}
+
+// ==========================================
+//      SORTED REQUEST INDEX
+// ==========================================
+
+#define RADIX_BITS 11 // two passes cover a million cylinders
+#define RADIX_MASK ((1 << RADIX_BITS) - 1)
+
+void sortByCylinder(const long long req[], int n, int sorted[])
+{
+    unsigned long long any = 0, all = ~0ULL;
+    for (int i = 0; i < n; i++)
+    {
+        sorted[i] = i;
+        any |= (unsigned long long)req[i];
+        all &= (unsigned long long)req[i];
+    }
+    unsigned long long varying = any & ~all;
+    if (varying == 0)
+        return;
+
+    // LSD radix sort, one counting pass per 11-bit digit that differs between requests. Keys travel with
+    // their indices so every pass reads sequentially instead of gathering from req.
+    size_t m = (size_t)n;
+    unsigned long long *key = safeMalloc(2 * m * sizeof(unsigned long long)), *keyTo = key + m;
+    int *from = sorted, *to = safeMalloc(m * sizeof(int)), *spare = to;
+    for (size_t i = 0; i < m; i++)
+        key[i] = (unsigned long long)req[i];
+    for (int shift = 0; shift < 64; shift += RADIX_BITS)
+    {
+        if (((varying >> shift) & RADIX_MASK) == 0)
+            continue;
+        int count[RADIX_MASK + 2] = {0};
+        for (size_t i = 0; i < m; i++)
+            count[((key[i] >> shift) & RADIX_MASK) + 1]++;
+        for (int b = 0; b <= RADIX_MASK; b++)
+            count[b + 1] += count[b];
+        for (size_t i = 0; i < m; i++)
+        {
+            int slot = count[(key[i] >> shift) & RADIX_MASK]++;
+            keyTo[slot] = key[i];
+            to[slot] = from[i];
+        }
+        unsigned long long *k = key;
+        key = keyTo;
+        keyTo = k;
+        int *t = from;
+        from = to;
+        to = t;
+    }
+    if (from != sorted)
+        memcpy(sorted, from, m * sizeof(int));
+    free(key < keyTo ? key : keyTo);
+    free(spare);
+}
+
+// ==========================================
+//      POLICIES
+// ==========================================
+
+// Nearest unserved request; equal distances keep the arm moving the way it was going
+static void orderSSTF(long long head, bool up, const long long req[], int n, const int sorted[], int order[])
+{
+    int *prev = safeMalloc(n * sizeof(int));
+    int *next = safeMalloc(n * sizeof(int));
+    for (int i = 0; i < n; i++)
+    {
+        prev[i] = i - 1;
+        next[i] = (i + 1 < n) ? i + 1 : -1;
+    }
+    int lo = 0, hi = n;
+    while (lo < hi)
+    {
+        int mid = lo + (hi - lo) / 2;
+        if (req[sorted[mid]] < head)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    // The arm always sits on the last request served, so the only candidates are its unserved neighbours
+    int below = lo - 1, above = (lo < n) ? lo : -1;
+    long long pos = head;
+    for (int served = 0; served < n; served++)
+    {
+        int pick;
+        if (below < 0)
+            pick = above;
+        else if (above < 0)
+            pick = below;
+        else
+        {
+            long long down = pos - req[sorted[below]], rise = req[sorted[above]] - pos;
+            pick = (rise < down || (rise == down && up)) ? above : below;
+        }
+        long long target = req[sorted[pick]];
+        if (target != pos)
+            up = (target > pos);
+        pos = target;
+        order[served] = sorted[pick];
+
+        below = prev[pick];
+        above = next[pick];
+        if (below >= 0)
+            next[below] = above;
+        if (above >= 0)
+            prev[above] = below;
+    }
+    free(prev);
+    free(next);
+}
+
+// One sweep in the direction of travel, then the rest reversed (SCAN, LOOK) or from the far end (C-SCAN, C-LOOK)
+static void orderSweep(DiskPolicy policy, long long head, bool up, const long long req[], int n, const int sorted[],
+                       int order[])
+{
+    // Slot i of the sweep, counted in the direction of travel
+#define SWEEP_SLOT(i) (up ? sorted[(i)] : sorted[n - 1 - (i)])
+    int k = 0; // first slot at or beyond the head
+    int lo = 0, hi = n;
+    while (lo < hi)
+    {
+        int mid = lo + (hi - lo) / 2;
+        long long pos = req[SWEEP_SLOT(mid)];
+        if (up ? pos < head : pos > head)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    k = lo;
+
+    int served = 0;
+    for (int i = k; i < n; i++)
+        order[served++] = SWEEP_SLOT(i);
+    if (policy == DISK_SCAN || policy == DISK_LOOK)
+        for (int i = k - 1; i >= 0; i--)
+            order[served++] = SWEEP_SLOT(i);
+    else
+        for (int i = 0; i < k; i++)
+            order[served++] = SWEEP_SLOT(i);
+#undef SWEEP_SLOT
+}
+
+/**
+ * Cylinders the arm passes through serving `order`, edges included: SCAN
+ * runs to the edge before it turns, C-SCAN to the edge and then returns
+ * to the other one. Returns the total movement. `path` may be NULL,
+ * otherwise it needs room for n + 2 stops; `travel` may be NULL,
+ * otherwise it gets the movement before each request.
+ */
+static long long walkHead(DiskPolicy policy, long long head, const DiskConfig *cfg, const long long req[],
+                          const int order[], int n, long long path[], int *stops, long long travel[])
+{
+    long long pos = head, seek = 0, edge = cfg->up ? cfg->cylinders - 1 : 0;
+    bool turned = false;
+    int count = 0;
+    for (int i = 0; i < n; i++)
+    {
+        long long target = req[order[i]], before = seek;
+        bool backwards = cfg->up ? target < pos : target > pos;
+        if (!turned && backwards && (policy == DISK_SCAN || policy == DISK_CSCAN))
+        {
+            turned = true;
+            seek += llabs(edge - pos);
+            pos = edge;
+            if (path != NULL)
+                path[count++] = pos;
+            if (policy == DISK_CSCAN)
+            {
+                long long other = cfg->up ? 0 : cfg->cylinders - 1;
+                seek += llabs(other - pos);
+                pos = other;
+                if (path != NULL)
+                    path[count++] = pos;
+            }
+        }
+        seek += llabs(target - pos);
+        pos = target;
+        if (path != NULL)
+            path[count++] = pos;
+        if (travel != NULL)
+            travel[i] = seek - before;
+    }
+    if (stops != NULL)
+        *stops = count;
+    return seek;
+}
+
+long long scheduleDisk(DiskPolicy policy, long long head, const DiskConfig *cfg, const long long req[], int n,
+                       int order[], long long travel[])
+{
+    if (policy == DISK_FCFS)
+        for (int i = 0; i < n; i++)
+            order[i] = i;
+    else
+    {
+        int *sorted = safeMalloc((n > 0 ? n : 1) * sizeof(int));
+        sortByCylinder(req, n, sorted);
+        if (policy == DISK_SSTF)
+            orderSSTF(head, cfg->up, req, n, sorted, order);
+        else
+            orderSweep(policy, head, cfg->up, req, n, sorted, order);
+        free(sorted);
+    }
+    return walkHead(policy, head, cfg, req, order, n, NULL, NULL, travel);
+}
+
+// ==========================================
+//      INTERACTIVE FRONT END
+// ==========================================
+
+// Simulated milliseconds for the default model of `kind` to serve `order`
+static double deviceMillis(DeviceKind kind, const DiskConfig *cfg, const long long req[], const int order[],
+                           const long long travel[], int n)
+{
+    DeviceConfig device;
+    defaultDeviceConfig(&device, kind);
+    char error[160];
+    return timeDiskOrder(&device, cfg, req, order, travel, n, error, sizeof(error)) / 1e3;
+}
+
+// Every policy side by side, timed; short lists also show each service order
+static void compareDiskPolicies(long long head, const DiskConfig *cfg, const long long req[], int n)
+{
+    long long seek[DISK_POLICY_COUNT], elapsed[DISK_POLICY_COUNT], best = LLONG_MAX;
+    double hdd[DISK_POLICY_COUNT], ssd[DISK_POLICY_COUNT], bestHdd = INFINITY, bestSsd = INFINITY;
+    int *order = safeMalloc((size_t)DISK_POLICY_COUNT * (n > 0 ? n : 1) * sizeof(int));
+    long long *travel = safeMalloc((n > 0 ? n : 1) * sizeof(long long));
+    for (int p = 0; p < DISK_POLICY_COUNT; p++)
+    {
+        long long start = monotonicNanos();
+        seek[p] = scheduleDisk((DiskPolicy)(p + 1), head, cfg, req, n, order + (size_t)p * n, travel);
+        elapsed[p] = monotonicNanos() - start;
+        hdd[p] = deviceMillis(DEVICE_HDD, cfg, req, order + (size_t)p * n, travel, n);
+        ssd[p] = deviceMillis(DEVICE_SSD, cfg, req, order + (size_t)p * n, travel, n);
+        if (seek[p] < best)
+            best = seek[p];
+        if (hdd[p] < bestHdd)
+            bestHdd = hdd[p];
+        if (ssd[p] < bestSsd)
+            bestSsd = ssd[p];
+    }
+
+    printHeader("DISK POLICY COMPARISON");
+    printf(CYAN "| %-7s | %-16s | %-10s | %-11s | %-11s | %-10s | %-10s |\n" RESET, "Policy", "Total Seek", "Avg Seek",
+           "HDD ms", "SSD ms", "Wall ms", "Mreq/s");
+    printLine(98);
+    for (int p = 0; p < DISK_POLICY_COUNT; p++)
+        printf("| %-7s | %s%-16lld" RESET " | %-10.2f | %s%-11.2f" RESET " | %s%-11.2f" RESET " | %-10.2f | %-10.2f |\n",
+               diskPolicyName((DiskPolicy)(p + 1)), seek[p] == best ? GREEN : "", seek[p],
+               n ? (double)seek[p] / n : 0.0, hdd[p] == bestHdd ? GREEN : "", hdd[p], ssd[p] == bestSsd ? GREEN : "",
+               ssd[p], elapsed[p] / 1e6, elapsed[p] ? 1e3 * n / elapsed[p] : 0.0);
+    printLine(98);
+
+    if (n <= MAX_REQ)
+        for (int p = 0; p < DISK_POLICY_COUNT; p++)
+        {
+            printf(YELLOW "%-7s" RESET " %lld", diskPolicyName((DiskPolicy)(p + 1)), head);
+            for (int i = 0; i < n; i++)
+                printf(" -> %lld", req[order[(size_t)p * n + i]]);
+            printf("\n");
+        }
+    printf("%d requests from cylinder %lld on a %lld-cylinder disk, head moving %s.\n", n, head, cfg->cylinders,
+           cfg->up ? "up" : "down");
+    printf("HDD/SSD ms = simulated time on the default device models, every request queued at once.\n");
+    free(order);
+    free(travel);
+}
+
+static void animateDiskPolicy(DiskPolicy policy, long long head, const DiskConfig *cfg, const long long req[], int n)
+{
+    int *order = safeMalloc((n > 0 ? n : 1) * sizeof(int));
+    long long *path = safeMalloc((n + 2) * sizeof(long long));
+    long long *travel = safeMalloc((n > 0 ? n : 1) * sizeof(long long));
+    scheduleDisk(policy, head, cfg, req, n, order, travel);
+    int stops;
+    long long seek = walkHead(policy, head, cfg, req, order, n, path, &stops, NULL);
+
+    printf("\n" YELLOW "Simulating Disk Arm Movement (%s)..." RESET "\n", diskPolicyName(policy));
+    SLEEP_MS(800);
+
+    printf(CYAN "%lld" RESET, head);
+    long long curr = head;
+    for (int i = 0, served = 0; i < stops; i++)
+    {
+        SLEEP_MS(1000); // Wait 1 second between each move
+        long long move = llabs(path[i] - curr);
+        curr = path[i];
+        // Stops that are not the next request are the arm running to an edge
+        bool request = (served < n && req[order[served]] == curr);
+        if (request)
+            served++;
+        printf(" --(" RED "%lld" RESET ")--> %s%lld" RESET, move, request ? CYAN : MAGENTA, curr);
+        fflush(stdout);
+    }
+
+    SLEEP_MS(500);
+    printf("\n\n" GREEN "Calculation: Sum of all head displacements = %lld units." RESET, seek);
+    printf("\nSimulated time: %.2f ms on the default HDD, %.2f ms on the default SSD.",
+           deviceMillis(DEVICE_HDD, cfg, req, order, travel, n), deviceMillis(DEVICE_SSD, cfg, req, order, travel, n));
+    free(order);
+    free(path);
+    free(travel);
+}
+
 void runDiskScheduler()
 {
-    int head, n, i, seek = 0;
-    int req[MAX_REQ];
-    printHeader("DISK SCHEDULING (FCFS/VISUALIZER)");
+    int n, i;
+    DiskConfig cfg;
+    defaultDiskConfig(&cfg);
+    printHeader("DISK SCHEDULING VISUALIZER");
+    printf("Requests (1. Type a list known up front  2. Generate timed arrivals  3. Replay a block trace): ");
+    int source = getSafeInt();
+    if (source == 2)
+    {
+        runTimedDiskScheduler();
+        return;
+    }
+    if (source == 3)
+    {
+        runBlockTraceReplay();
+        return;
+    }
 
     printf("Enter current head position: ");
-    head = getSafeInt();
+    long long head = getSafeInt();
     printf("Enter number of requests: ");
     n = getSafeInt();
+    if (n < 0)
+        n = 0;
+    long long *req = safeMalloc((n > 0 ? n : 1) * sizeof(long long));
     printf("Enter the requests: ");
     for (i = 0; i < n; i++)
-        scanf("%d", &req[i]);
-    clearBuffer();
-
-    printf("\n" YELLOW "Simulating Disk Arm Movement..." RESET "\n");
-    SLEEP_MS(800);
+        req[i] = getSafeInt();
+    printf("Disk size in cylinders (e.g. 200): ");
+    cfg.cylinders = getSafeInt();
+    printf("Head moving toward (1=Higher cylinders, 0=Cylinder 0): ");
+    cfg.up = getSafeInt() != 0;
 
-    printf(CYAN "%d" RESET, head);
-    int curr = head;
-
-    for (i = 0; i < n; i++)
+    char error[160];
+    if (!checkDiskRequests(head, &cfg, req, n, error, sizeof(error)))
     {
-        SLEEP_MS(1000); // Wait 1 second between each move
-        int move = abs(req[i] - curr);
-        seek += move;
-        curr = req[i];
-        printf(" --(" RED "%d" RESET ")--> " CYAN "%d" RESET, move, curr);
-        fflush(stdout);
+        printf(RED "Invalid input: %s.\n" RESET, error);
+        free(req);
+        waitForStudent();
+        return;
     }
 
-    SLEEP_MS(500);
-    printf("\n\n" GREEN "Calculation: Sum of all head displacements = %d units." RESET, seek);
+    // Long request lists skip the animation and compare every policy
+    int choice = DISK_POLICY_COUNT + 1;
+    if (n <= MAX_REQ)
+    {
+        printf("Policy (1.FCFS 2.SSTF 3.SCAN 4.C-SCAN 5.LOOK 6.C-LOOK 7.Compare All): ");
+        choice = getSafeInt();
+    }
+    if (choice >= DISK_FCFS && choice <= DISK_POLICY_COUNT)
+        animateDiskPolicy((DiskPolicy)choice, head, &cfg, req, n);
+    else
+        compareDiskPolicies(head, &cfg, req, n);
+    free(req);
     waitForStudent();
-}
\ No newline at end of file
+}
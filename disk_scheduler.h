@@ -3,11 +3,66 @@
 
 #include "utils.h"
 
+// --- Structures ---
+typedef enum
+{
+    DISK_FCFS = 1,
+    DISK_SSTF = 2,
+    DISK_SCAN = 3,
+    DISK_CSCAN = 4,
+    DISK_LOOK = 5,
+    DISK_CLOOK = 6,
+    DISK_DEADLINE = 7, // timed simulation only (disk_timed.h)
+    DISK_BUDGET = 8    // timed simulation only
+} DiskPolicy;
+
+#define DISK_POLICY_COUNT 6       // policies for a request list known up front
+#define DISK_TIMED_POLICY_COUNT 8 // policies for requests arriving over time
+
+/**
+ * The disk the head moves over. SCAN and C-SCAN run to the edge
+ * (cylinder 0 or cylinders - 1) before turning; `up` is the initial
+ * direction of travel, toward higher cylinders.
+ */
+typedef struct
+{
+    long long cylinders;
+    bool up;
+} DiskConfig;
+
 // --- Function Prototypes ---
+void defaultDiskConfig(DiskConfig *cfg);
+const char *diskPolicyName(DiskPolicy policy);
+
+/**
+ * Checks that the head and every request lie on the disk. Returns false
+ * with `error` filled otherwise.
+ */
+bool checkDiskRequests(long long head, const DiskConfig *cfg, const long long req[], int n, char *error,
+                       size_t errorSize);
+
+/**
+ * Fills sorted[0..n-1] with the indices of req ordered by cylinder, ties
+ * in index order (a stable radix sort, O(n) per significant byte).
+ */
+void sortByCylinder(const long long req[], int n, int sorted[]);
+
+/**
+ * Services req[0..n-1] from `head` under `policy`, writing request
+ * indices in service order to order[0..n-1], and returns the total head
+ * movement. travel[i], unless travel is NULL, gets the movement before
+ * order[i], including any run to an edge. Every policy but FCFS works on one sorted copy of the
+ * requests: SSTF keeps its unserved neighbours linked, so the nearest
+ * request is found in O(1) after an O(log n) start; the SCAN family is one
+ * pass over the sorted array. Requests must pass checkDiskRequests.
+ */
+long long scheduleDisk(DiskPolicy policy, long long head, const DiskConfig *cfg, const long long req[], int n,
+                       int order[], long long travel[]);
+
 /**
- * Simulates the First-Come, First-Served (FCFS) Disk Scheduling algorithm.
- * Includes a step-by-step visualizer of head movement and seek time.
+ * Simulates the disk scheduling policies. Short request lists animate the
+ * arm of one policy; long lists, or Compare All, report every policy.
  */
 void runDiskScheduler();
 
-#endif
\ No newline at end of file
+#endif
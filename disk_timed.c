@@ -0,0 +1,1146 @@
+#include "disk_timed.h"
+#include "free_index.h"
+
+// ==========================================
+//      CONFIGURATION & WORKLOAD
+// ==========================================
+
+void defaultTimedDiskConfig(TimedDiskConfig *cfg, DeviceKind device)
+{
+    defaultDiskConfig(&cfg->disk);
+    defaultDeviceConfig(&cfg->device, device);
+    cfg->readExpireUs = 500000; // mq-deadline's defaults: 500 ms for reads, 5 s for writes
+    cfg->writeExpireUs = 5000000;
+    cfg->fifoBatch = 16;
+    cfg->writesStarved = 2;
+    cfg->budget = 16;
+    defaultIoStagingConfig(&cfg->staging);
+}
+
+void defaultIoStagingConfig(IoStagingConfig *cfg)
+{
+    cfg->plugUs = 0;
+    cfg->plugLimit = 32;   // Linux flushes a plug at 32 requests
+    cfg->mergeLimit = 128; // 512 KiB, the common max_sectors_kb
+}
+
+void defaultIoWorkloadConfig(IoWorkloadConfig *cfg)
+{
+    cfg->count = 100000;
+    cfg->seed = 42;
+    cfg->meanInterarrivalUs = 8000; // close to FCFS's mean service time on the default disk
+    cfg->processes = 8;
+    cfg->writeFraction = 0.3;
+    cfg->readDeadlineUs = 200000;
+}
+
+void generateIoWorkload(const IoWorkloadConfig *cfg, long long cylinders, int sectorsPerCylinder, IoRequest out[])
+{
+    Rng rng;
+    rngSeed(&rng, cfg->seed);
+    int processes = (cfg->processes > 0) ? cfg->processes : 1;
+    // Each process's position as a block number: cylinder * sectorsPerCylinder + sector
+    long long blocks = cylinders * sectorsPerCylinder;
+    long long *cursor = safeMalloc(processes * sizeof(long long));
+    for (int p = 0; p < processes; p++)
+        cursor[p] = (long long)(rngNext(&rng) % (uint64_t)blocks);
+
+    double clock = 0;
+    for (long long i = 0; i < cfg->count; i++)
+    {
+        IoRequest *r = &out[i];
+        clock += rngExponential(&rng, cfg->meanInterarrivalUs);
+        int p = (int)(rngNext(&rng) % (uint64_t)processes);
+        if (p % 2 == 0)
+            cursor[p] = (cursor[p] + 1) % blocks;
+        else
+            cursor[p] = (long long)(rngNext(&rng) % (uint64_t)blocks);
+        r->arrival = (long long)clock;
+        r->cylinder = cursor[p] / sectorsPerCylinder;
+        r->sector = (int)(cursor[p] % sectorsPerCylinder);
+        r->process = p;
+        r->length = 1;
+        r->op = (rngUniform(&rng) <= cfg->writeFraction) ? IO_WRITE : IO_READ;
+        r->deadline = (r->op == IO_READ) ? cfg->readDeadlineUs : 0;
+    }
+    free(cursor);
+}
+
+// ==========================================
+//      LATENCY HISTOGRAM
+// ==========================================
+
+static int latencyBucket(long long us)
+{
+    if (us < (1 << LATENCY_SUB_BITS))
+        return (us < 0) ? 0 : (int)us;
+    int msb = highestSetBit((uint64_t)us);
+    int sub = (int)((us >> (msb - LATENCY_SUB_BITS)) & ((1 << LATENCY_SUB_BITS) - 1));
+    return ((msb - LATENCY_SUB_BITS + 1) << LATENCY_SUB_BITS) + sub;
+}
+
+void recordLatency(LatencyHistogram *h, long long us)
+{
+    h->counts[latencyBucket(us)]++;
+    h->total++;
+    h->sum += (double)us;
+    if (us > h->max)
+        h->max = us;
+}
+
+long long latencyPercentile(const LatencyHistogram *h, double p)
+{
+    if (h->total == 0)
+        return 0;
+    long long rank = (long long)ceil(p * h->total), seen = 0;
+    if (rank < 1)
+        rank = 1;
+    for (int b = 0; b < LATENCY_BUCKETS; b++)
+    {
+        seen += h->counts[b];
+        if (seen < rank)
+            continue;
+        if (b < (1 << LATENCY_SUB_BITS))
+            return b;
+        int msb = (b >> LATENCY_SUB_BITS) + LATENCY_SUB_BITS - 1;
+        unsigned long long width = 1ULL << (msb - LATENCY_SUB_BITS);
+        unsigned long long high = ((1ULL << LATENCY_SUB_BITS) + (b & ((1 << LATENCY_SUB_BITS) - 1))) * width + width - 1;
+        return (high < (unsigned long long)h->max) ? (long long)high : h->max;
+    }
+    return h->max;
+}
+
+// ==========================================
+//      EVENT HEAP & REQUEST WINDOW
+// ==========================================
+
+static void eventPush(IoEventHeap *h, long long time, long long index)
+{
+    if (h->count == h->capacity)
+    {
+        h->capacity = h->capacity ? 2 * h->capacity : 64;
+        IoEvent *grown = realloc(h->items, h->capacity * sizeof(IoEvent));
+        if (grown == NULL)
+        {
+            printf(RED "\nFatal: out of memory in event heap\n" RESET);
+            exit(EXIT_FAILURE);
+        }
+        h->items = grown;
+    }
+    long long c = h->count++;
+    while (c > 0 && h->items[(c - 1) / 2].time > time)
+    {
+        h->items[c] = h->items[(c - 1) / 2];
+        c = (c - 1) / 2;
+    }
+    h->items[c].time = time;
+    h->items[c].index = index;
+}
+
+static void eventPop(IoEventHeap *h)
+{
+    IoEvent last = h->items[--h->count];
+    long long c = 0;
+    while (2 * c + 1 < h->count)
+    {
+        long long child = 2 * c + 1;
+        if (child + 1 < h->count && h->items[child + 1].time < h->items[child].time)
+            child++;
+        if (h->items[child].time >= last.time)
+            break;
+        h->items[c] = h->items[child];
+        c = child;
+    }
+    if (h->count > 0)
+        h->items[c] = last;
+}
+
+static const IoRequest *ioAt(const IoWindow *w, long long i)
+{
+    return &w->slots[i & w->mask];
+}
+
+static void allocWindow(IoWindow *w, long long capacity)
+{
+    w->slots = safeMalloc((size_t)capacity * sizeof(IoRequest));
+    w->completed = calloc((size_t)capacity, sizeof(bool));
+    w->next = safeMalloc((size_t)capacity * sizeof(long long));
+    if (w->completed == NULL)
+    {
+        printf(RED "\nFatal: out of memory in request window\n" RESET);
+        exit(EXIT_FAILURE);
+    }
+    w->mask = capacity - 1;
+}
+
+// Appends the next request, doubling the window when every slot is still needed
+static void windowAdmit(IoWindow *w, const IoRequest *r)
+{
+    if (w->admitted - w->oldest > w->mask)
+    {
+        IoWindow grown;
+        allocWindow(&grown, 2 * (w->mask + 1));
+        for (long long i = w->oldest; i < w->admitted; i++)
+        {
+            grown.slots[i & grown.mask] = w->slots[i & w->mask];
+            grown.completed[i & grown.mask] = w->completed[i & w->mask];
+            grown.next[i & grown.mask] = w->next[i & w->mask];
+        }
+        free(w->slots);
+        free(w->completed);
+        free(w->next);
+        w->slots = grown.slots;
+        w->completed = grown.completed;
+        w->next = grown.next;
+        w->mask = grown.mask;
+    }
+    w->slots[w->admitted & w->mask] = *r;
+    w->completed[w->admitted & w->mask] = false;
+    w->next[w->admitted & w->mask] = -1;
+    w->admitted++;
+}
+
+static void windowComplete(IoWindow *w, long long i)
+{
+    w->completed[i & w->mask] = true;
+    while (w->oldest < w->admitted && w->completed[w->oldest & w->mask])
+        w->oldest++;
+}
+
+// ==========================================
+//      SCHEDULERS
+// ==========================================
+
+// Pending requests in cylinder order: key = cylinder, tie = request index
+static int sortedAtOrAbove(const FreeTree *t, long long cylinder)
+{
+    return freeTreeLowerBound(t, cylinder, LLONG_MIN);
+}
+
+static int sortedAtOrBelow(const FreeTree *t, long long cylinder)
+{
+    return freeTreePredecessor(t, cylinder, LLONG_MAX);
+}
+
+static bool sortedContains(const FreeTree *t, long long cylinder, long long i)
+{
+    int node = freeTreeLowerBound(t, cylinder, i);
+    return node >= 0 && t->nodes[node].key == cylinder && t->nodes[node].tie == i;
+}
+
+// Takes the request in `node` out of the tree and returns its index
+static long long takeSorted(FreeTree *t, int node)
+{
+    long long cylinder = t->nodes[node].key;
+    long long i = t->nodes[node].tie;
+    freeTreeErase(t, cylinder, i);
+    return i;
+}
+
+// --- FCFS ---
+// Indices in the order they were added; with staging that skips the requests merged away
+typedef struct
+{
+    const IoWindow *w;
+    long long *ring;
+    long long mask, first, count;
+} FifoIo;
+
+static void fifoAdd(void *self, long long i)
+{
+    FifoIo *f = self;
+    if (f->count > f->mask)
+    {
+        long long *grown = safeMalloc((size_t)(2 * (f->mask + 1)) * sizeof(long long));
+        for (long long k = 0; k < f->count; k++)
+            grown[k] = f->ring[(f->first + k) & f->mask];
+        free(f->ring);
+        f->ring = grown;
+        f->mask = 2 * f->mask + 1;
+        f->first = 0;
+    }
+    f->ring[(f->first + f->count++) & f->mask] = i;
+}
+
+static long long fifoPick(void *self, long long now, long long head, long long *travel)
+{
+    (void)now;
+    FifoIo *f = self;
+    long long i = f->ring[f->first++ & f->mask];
+    f->count--;
+    *travel = llabs(ioAt(f->w, i)->cylinder - head);
+    return i;
+}
+
+static void fifoDestroy(void *self)
+{
+    FifoIo *f = self;
+    free(f->ring);
+    free(f);
+}
+
+static const IoSchedulerOps fifoOps = {fifoAdd, fifoPick, fifoDestroy};
+
+// --- SSTF and the SCAN family ---
+typedef struct
+{
+    const IoWindow *w;
+    const TimedDiskConfig *cfg;
+    DiskPolicy policy;
+    FreeTree queue;
+    bool up;
+} ElevatorIo;
+
+static void elevatorAdd(void *self, long long i)
+{
+    ElevatorIo *e = self;
+    freeTreeInsert(&e->queue, ioAt(e->w, i)->cylinder, i, 0);
+}
+
+static long long elevatorPick(void *self, long long now, long long head, long long *travel)
+{
+    (void)now;
+    ElevatorIo *e = self;
+    long long last = e->cfg->disk.cylinders - 1;
+    int node;
+    *travel = -1; // the plain distance unless the arm runs to an edge first
+
+    if (e->policy == DISK_SSTF)
+    {
+        int above = sortedAtOrAbove(&e->queue, head), below = sortedAtOrBelow(&e->queue, head);
+        if (above < 0)
+            node = below;
+        else if (below < 0)
+            node = above;
+        else
+        {
+            long long rise = e->queue.nodes[above].key - head, down = head - e->queue.nodes[below].key;
+            node = (rise < down || (rise == down && e->up)) ? above : below;
+        }
+        long long target = e->queue.nodes[node].key;
+        if (target != head)
+            e->up = (target > head);
+    }
+    else if (e->policy == DISK_SCAN || e->policy == DISK_LOOK)
+    {
+        node = e->up ? sortedAtOrAbove(&e->queue, head) : sortedAtOrBelow(&e->queue, head);
+        if (node < 0)
+        {
+            long long edge = e->up ? last : 0;
+            e->up = !e->up;
+            node = e->up ? sortedAtOrAbove(&e->queue, head) : sortedAtOrBelow(&e->queue, head);
+            if (e->policy == DISK_SCAN)
+                *travel = llabs(edge - head) + llabs(e->queue.nodes[node].key - edge);
+        }
+    }
+    else
+    {
+        // C-SCAN and C-LOOK only ever serve in the configured direction
+        bool up = e->cfg->disk.up;
+        node = up ? sortedAtOrAbove(&e->queue, head) : sortedAtOrBelow(&e->queue, head);
+        if (node < 0)
+        {
+            node = up ? sortedAtOrAbove(&e->queue, LLONG_MIN) : sortedAtOrBelow(&e->queue, LLONG_MAX);
+            if (e->policy == DISK_CSCAN)
+            {
+                long long edge = up ? last : 0, other = up ? 0 : last;
+                *travel = llabs(edge - head) + last + llabs(e->queue.nodes[node].key - other);
+            }
+        }
+    }
+
+    if (*travel < 0)
+        *travel = llabs(e->queue.nodes[node].key - head);
+    return takeSorted(&e->queue, node);
+}
+
+static void elevatorDestroy(void *self)
+{
+    ElevatorIo *e = self;
+    freeFreeTree(&e->queue);
+    free(e);
+}
+
+static const IoSchedulerOps elevatorOps = {elevatorAdd, elevatorPick, elevatorDestroy};
+
+// --- Deadline ---
+typedef struct
+{
+    const IoWindow *w;
+    const TimedDiskConfig *cfg;
+    FreeTree sorted[2];     // by direction: IO_READ, IO_WRITE
+    IoEventHeap expiry[2];  // served requests are dropped lazily when they reach the top
+    int dir, batching, starved;
+} DeadlineIo;
+
+static long long expiresAt(const DeadlineIo *d, const IoRequest *r)
+{
+    if (r->deadline > 0)
+        return r->arrival + r->deadline;
+    return r->arrival + (r->op == IO_READ ? d->cfg->readExpireUs : d->cfg->writeExpireUs);
+}
+
+static void deadlineAdd(void *self, long long i)
+{
+    DeadlineIo *d = self;
+    const IoRequest *r = ioAt(d->w, i);
+    freeTreeInsert(&d->sorted[r->op], r->cylinder, i, 0);
+    eventPush(&d->expiry[r->op], expiresAt(d, r), i);
+}
+
+static long long deadlinePick(void *self, long long now, long long head, long long *travel)
+{
+    DeadlineIo *d = self;
+    long long i = -1;
+
+    // Keep the current batch going in ascending order while it lasts
+    if (d->batching < d->cfg->fifoBatch)
+    {
+        int node = sortedAtOrAbove(&d->sorted[d->dir], head);
+        if (node >= 0)
+            i = d->sorted[d->dir].nodes[node].tie;
+    }
+    if (i < 0)
+    {
+        bool reads = d->sorted[IO_READ].count > 0, writes = d->sorted[IO_WRITE].count > 0;
+        if (reads && (!writes || d->starved < d->cfg->writesStarved))
+        {
+            d->dir = IO_READ;
+            if (writes)
+                d->starved++;
+        }
+        else
+        {
+            d->dir = IO_WRITE;
+            d->starved = 0;
+        }
+
+        // A request no longer in the sorted tree was served already. Its slot may hold a
+        // later request by now, but never one with the same index.
+        IoEventHeap *h = &d->expiry[d->dir];
+        while (!sortedContains(&d->sorted[d->dir], ioAt(d->w, h->items[0].index)->cylinder, h->items[0].index))
+            eventPop(h);
+        long long oldest = h->items[0].index;
+        int node = sortedAtOrAbove(&d->sorted[d->dir], head);
+        // An expired request, or the end of the sweep, restarts the batch at the most urgent request
+        if (h->items[0].time <= now || node < 0)
+            i = oldest;
+        else
+            i = d->sorted[d->dir].nodes[node].tie;
+        d->batching = 0;
+    }
+
+    d->batching++;
+    long long cylinder = ioAt(d->w, i)->cylinder;
+    freeTreeErase(&d->sorted[d->dir], cylinder, i);
+    *travel = llabs(cylinder - head);
+    return i;
+}
+
+static void deadlineDestroy(void *self)
+{
+    DeadlineIo *d = self;
+    for (int dir = IO_READ; dir <= IO_WRITE; dir++)
+    {
+        freeFreeTree(&d->sorted[dir]);
+        free(d->expiry[dir].items);
+    }
+    free(d);
+}
+
+static const IoSchedulerOps deadlineOps = {deadlineAdd, deadlinePick, deadlineDestroy};
+
+// --- Budget-fair queueing ---
+typedef struct
+{
+    FreeTree queue;
+    int next; // link in the round-robin ring
+    bool queued;
+} ProcessQueue;
+
+typedef struct
+{
+    const IoWindow *w;
+    const TimedDiskConfig *cfg;
+    PageMap slotOf; // process id -> slot in procs
+    ProcessQueue *procs;
+    int procCount, procCapacity;
+    int ringHead, ringTail; // processes with requests waiting for a turn
+    int current;
+    long long budgetLeft;
+} BudgetIo;
+
+static void budgetEnqueue(BudgetIo *b, int slot)
+{
+    b->procs[slot].queued = true;
+    b->procs[slot].next = -1;
+    if (b->ringTail >= 0)
+        b->procs[b->ringTail].next = slot;
+    else
+        b->ringHead = slot;
+    b->ringTail = slot;
+}
+
+static void budgetAdd(void *self, long long i)
+{
+    BudgetIo *b = self;
+    const IoRequest *r = ioAt(b->w, i);
+    int slot = pageMapGet(&b->slotOf, r->process);
+    if (slot < 0)
+    {
+        if (b->procCount == b->procCapacity)
+        {
+            b->procCapacity = b->procCapacity ? 2 * b->procCapacity : 16;
+            ProcessQueue *grown = realloc(b->procs, b->procCapacity * sizeof(ProcessQueue));
+            if (grown == NULL)
+            {
+                printf(RED "\nFatal: out of memory in budget scheduler\n" RESET);
+                exit(EXIT_FAILURE);
+            }
+            b->procs = grown;
+        }
+        slot = b->procCount++;
+        initFreeTree(&b->procs[slot].queue);
+        b->procs[slot].queued = false;
+        pageMapPut(&b->slotOf, r->process, slot);
+    }
+    freeTreeInsert(&b->procs[slot].queue, r->cylinder, i, 0);
+    if (!b->procs[slot].queued && slot != b->current)
+        budgetEnqueue(b, slot);
+}
+
+static long long budgetPick(void *self, long long now, long long head, long long *travel)
+{
+    (void)now;
+    BudgetIo *b = self;
+    if (b->current < 0 || b->budgetLeft <= 0 || b->procs[b->current].queue.count == 0)
+    {
+        // A process that used up its budget with work left goes to the back of the line
+        if (b->current >= 0 && b->procs[b->current].queue.count > 0)
+            budgetEnqueue(b, b->current);
+        b->current = b->ringHead;
+        b->ringHead = b->procs[b->current].next;
+        if (b->ringHead < 0)
+            b->ringTail = -1;
+        b->procs[b->current].queued = false;
+        b->budgetLeft = b->cfg->budget;
+    }
+
+    // Within its turn a process is served in C-LOOK order
+    FreeTree *q = &b->procs[b->current].queue;
+    int node = sortedAtOrAbove(q, head);
+    if (node < 0)
+        node = sortedAtOrAbove(q, LLONG_MIN);
+    *travel = llabs(q->nodes[node].key - head);
+    long long i = takeSorted(q, node);
+    b->budgetLeft -= ioAt(b->w, i)->length;
+    return i;
+}
+
+static void budgetDestroy(void *self)
+{
+    BudgetIo *b = self;
+    for (int s = 0; s < b->procCount; s++)
+        freeFreeTree(&b->procs[s].queue);
+    free(b->procs);
+    freePageMap(&b->slotOf);
+    free(b);
+}
+
+static const IoSchedulerOps budgetOps = {budgetAdd, budgetPick, budgetDestroy};
+
+static const IoSchedulerOps *createIoScheduler(DiskPolicy policy, const TimedDiskConfig *cfg, const IoWindow *w,
+                                               void **self)
+{
+    if (policy == DISK_FCFS)
+    {
+        FifoIo *f = safeMalloc(sizeof(FifoIo));
+        f->w = w;
+        f->ring = safeMalloc(1024 * sizeof(long long));
+        f->mask = 1023;
+        f->first = f->count = 0;
+        *self = f;
+        return &fifoOps;
+    }
+    if (policy == DISK_DEADLINE)
+    {
+        DeadlineIo *d = safeMalloc(sizeof(DeadlineIo));
+        d->w = w;
+        d->cfg = cfg;
+        for (int dir = IO_READ; dir <= IO_WRITE; dir++)
+        {
+            initFreeTree(&d->sorted[dir]);
+            d->expiry[dir].items = NULL;
+            d->expiry[dir].count = d->expiry[dir].capacity = 0;
+        }
+        d->dir = IO_READ;
+        d->batching = cfg->fifoBatch; // no batch in progress
+        d->starved = 0;
+        *self = d;
+        return &deadlineOps;
+    }
+    if (policy == DISK_BUDGET)
+    {
+        BudgetIo *b = safeMalloc(sizeof(BudgetIo));
+        b->w = w;
+        b->cfg = cfg;
+        initPageMap(&b->slotOf, 64);
+        b->procs = NULL;
+        b->procCount = b->procCapacity = 0;
+        b->ringHead = b->ringTail = b->current = -1;
+        b->budgetLeft = 0;
+        *self = b;
+        return &budgetOps;
+    }
+    ElevatorIo *e = safeMalloc(sizeof(ElevatorIo));
+    e->w = w;
+    e->cfg = cfg;
+    e->policy = policy;
+    e->up = cfg->disk.up;
+    initFreeTree(&e->queue);
+    *self = e;
+    return &elevatorOps;
+}
+
+// ==========================================
+//      REQUEST STAGING
+// ==========================================
+
+static long long blockOf(const TimedDiskSim *sim, const IoRequest *r)
+{
+    return r->cylinder * sectorsPerCylinder(&sim->cfg.device) + r->sector;
+}
+
+// The staged request r could merge with through `key`, or -1
+static int mergeTarget(const TimedDiskSim *sim, const PageMap *index, long long key, const IoRequest *r)
+{
+    int u = pageMapGet(index, key);
+    if (u < 0)
+        return -1;
+    const StagedIo *unit = &sim->staging.units[u];
+    const IoRequest *first = ioAt(&sim->window, unit->first);
+    if (first->op != r->op || first->process != r->process || unit->length + r->length > sim->cfg.staging.mergeLimit)
+        return -1;
+    return u;
+}
+
+// Two staged requests can end (or start) on the same block; only the owner's entry goes
+static void unmapUnit(PageMap *index, long long key, int u)
+{
+    if (pageMapGet(index, key) == u)
+        pageMapErase(index, key);
+}
+
+// Moves src's members and blocks into dst, which keeps the earlier first member
+static void joinUnits(TimedDiskSim *sim, int dst, int src)
+{
+    IoStaging *s = &sim->staging;
+    StagedIo *d = &s->units[dst], *from = &s->units[src];
+    IoWindow *w = &sim->window;
+    if (from->first < d->first)
+    {
+        w->next[from->last & w->mask] = d->first;
+        d->first = from->first;
+    }
+    else
+    {
+        w->next[d->last & w->mask] = from->first;
+        d->last = from->last;
+    }
+    if (from->start < d->start)
+        d->start = from->start;
+    d->length += from->length;
+    from->length = 0;
+    s->live--;
+}
+
+// Hands every staged request to the policy in one batch
+static void unplugRequests(TimedDiskSim *sim)
+{
+    IoStaging *s = &sim->staging;
+    int blocks = sectorsPerCylinder(&sim->cfg.device);
+    for (int u = 0; u < s->count; u++)
+    {
+        StagedIo *unit = &s->units[u];
+        if (unit->length == 0)
+            continue;
+        unmapUnit(&s->byStart, unit->start, u);
+        unmapUnit(&s->byEnd, unit->start + unit->length, u);
+        IoRequest *r = &sim->window.slots[unit->first & sim->window.mask];
+        r->cylinder = unit->start / blocks;
+        r->sector = (int)(unit->start % blocks);
+        r->length = unit->length;
+        sim->ops->add(sim->scheduler, unit->first);
+        sim->pending++;
+    }
+    sim->result.batches++;
+    if (s->live > sim->result.largestBatch)
+        sim->result.largestBatch = s->live;
+    s->count = s->live = 0;
+}
+
+// Puts request i in the plug, merging it with a staged neighbour where it can
+static void stageRequest(TimedDiskSim *sim, long long i)
+{
+    IoStaging *s = &sim->staging;
+    const IoRequest *r = ioAt(&sim->window, i);
+    long long start = blockOf(sim, r), end = start + r->length;
+    if (s->live == 0)
+        s->releaseAt = sim->now + sim->cfg.staging.plugUs;
+
+    int back = mergeTarget(sim, &s->byEnd, start, r); // r carries on where it ends
+    int front = mergeTarget(sim, &s->byStart, end, r); // r runs up to where it starts
+    int u = back;
+    if (back >= 0)
+    {
+        unmapUnit(&s->byEnd, start, back);
+        sim->window.next[s->units[back].last & sim->window.mask] = i;
+        s->units[back].last = i;
+        s->units[back].length += r->length;
+        // r may have closed the gap to the next staged request as well
+        if (front >= 0 && s->units[back].length + s->units[front].length <= sim->cfg.staging.mergeLimit)
+        {
+            unmapUnit(&s->byStart, end, front);
+            unmapUnit(&s->byEnd, s->units[front].start + s->units[front].length, front);
+            joinUnits(sim, back, front);
+            u = back;
+        }
+    }
+    else if (front >= 0)
+    {
+        unmapUnit(&s->byStart, end, front);
+        sim->window.next[s->units[front].last & sim->window.mask] = i;
+        s->units[front].last = i;
+        s->units[front].start = start;
+        s->units[front].length += r->length;
+        u = front;
+    }
+    else
+    {
+        if (s->count == s->capacity)
+        {
+            s->capacity = s->capacity ? 2 * s->capacity : 64;
+            StagedIo *grown = realloc(s->units, s->capacity * sizeof(StagedIo));
+            if (grown == NULL)
+            {
+                printf(RED "\nFatal: out of memory in request staging\n" RESET);
+                exit(EXIT_FAILURE);
+            }
+            s->units = grown;
+        }
+        u = s->count++;
+        s->units[u].first = s->units[u].last = i;
+        s->units[u].start = start;
+        s->units[u].length = r->length;
+        s->live++;
+    }
+    pageMapPut(&s->byStart, s->units[u].start, u);
+    pageMapPut(&s->byEnd, s->units[u].start + s->units[u].length, u);
+    if (s->live >= sim->cfg.staging.plugLimit)
+        unplugRequests(sim);
+}
+
+// ==========================================
+//      SIMULATION
+// ==========================================
+
+static bool checkTimedRequest(const TimedDiskSim *sim, const IoRequest *r, char *error, size_t errorSize)
+{
+    long long index = sim->window.admitted + 1;
+    if (r->cylinder < 0 || r->cylinder >= sim->cfg.disk.cylinders)
+        snprintf(error, errorSize, "request %lld (cylinder %lld) is off a disk of %lld cylinders", index, r->cylinder,
+                 sim->cfg.disk.cylinders);
+    else if (r->sector < 0 || r->sector >= sectorsPerCylinder(&sim->cfg.device))
+        snprintf(error, errorSize, "request %lld (sector %d) is off a cylinder of %d sectors", index, r->sector,
+                 sectorsPerCylinder(&sim->cfg.device));
+    else if (sim->outstanding == 0 && (r->arrival < 0 || r->arrival < sim->lastArrival))
+        snprintf(error, errorSize, "request %lld arrives before the one listed ahead of it", index);
+    else if (r->deadline < 0 || r->length < 1 || (r->op != IO_READ && r->op != IO_WRITE))
+        snprintf(error, errorSize, "request %lld needs a read/write op, length >= 1 and deadline >= 0", index);
+    else
+        return true;
+    return false;
+}
+
+bool createTimedDiskSim(TimedDiskSim *sim, DiskPolicy policy, const TimedDiskConfig *cfg, long long head,
+                        int outstanding, char *error, size_t errorSize)
+{
+    if (policy < DISK_FCFS || policy > DISK_TIMED_POLICY_COUNT)
+        snprintf(error, errorSize, "unknown disk policy %d", (int)policy);
+    else if (cfg->fifoBatch < 1 || cfg->writesStarved < 0 || cfg->budget < 1)
+        snprintf(error, errorSize, "batch and budget must be at least 1");
+    else if (cfg->disk.cylinders < 1 || head < 0 || head >= cfg->disk.cylinders)
+        snprintf(error, errorSize, "head %lld is off a disk of %lld cylinders", head, cfg->disk.cylinders);
+    else if (outstanding < 0)
+        snprintf(error, errorSize, "outstanding request limit must not be negative");
+    else if (cfg->staging.plugUs < 0 || cfg->staging.plugLimit < 1 || cfg->staging.mergeLimit < 1)
+        snprintf(error, errorSize, "the plug window must not be negative, its request and merge limits at least 1");
+    else if (createDiskDevice(&cfg->device, cfg->disk.cylinders, &sim->device, error, errorSize))
+    {
+        sim->cfg = *cfg;
+        allocWindow(&sim->window, 1024);
+        sim->window.oldest = sim->window.admitted = 0;
+        sim->ops = createIoScheduler(policy, &sim->cfg, &sim->window, &sim->scheduler);
+        sim->inFlight.items = NULL;
+        sim->inFlight.count = sim->inFlight.capacity = 0;
+        sim->staging.units = NULL;
+        sim->staging.count = sim->staging.capacity = sim->staging.live = 0;
+        initPageMap(&sim->staging.byStart, 2 * cfg->staging.plugLimit);
+        initPageMap(&sim->staging.byEnd, 2 * cfg->staging.plugLimit);
+        sim->staging.releaseAt = 0;
+        sim->now = sim->pending = sim->lastArrival = 0;
+        sim->head = head;
+        sim->outstanding = outstanding;
+        initPageMap(&sim->processSlot, 64);
+        sim->processSum = NULL;
+        sim->processCount = NULL;
+        sim->processes = sim->processCapacity = 0;
+        memset(&sim->result, 0, sizeof(sim->result));
+        sim->result.policy = policy;
+        return true;
+    }
+    return false;
+}
+
+// Hands the device every request it has room for at the current time
+static void dispatchRequests(TimedDiskSim *sim)
+{
+    while (sim->pending > 0 && sim->inFlight.count < sim->device.queueDepth)
+    {
+        long long travel;
+        long long i = sim->ops->pick(sim->scheduler, sim->now, sim->head, &travel);
+        const IoRequest *r = ioAt(&sim->window, i);
+        sim->pending--;
+        sim->result.dispatched++;
+        eventPush(&sim->inFlight, sim->device.ops->submit(sim->device.self, r, travel, sim->now), i);
+        sim->result.seek += travel;
+        sim->head = r->cylinder;
+    }
+}
+
+// Accounts for request i, finished at the current time
+static void retireRequest(TimedDiskSim *sim, long long i)
+{
+    TimedDiskResult *out = &sim->result;
+    const IoRequest *r = ioAt(&sim->window, i);
+    long long latency = sim->now - r->arrival;
+    recordLatency(&out->latency, latency);
+    if (r->deadline > 0)
+    {
+        out->withDeadline++;
+        if (latency > r->deadline)
+            out->missed++;
+    }
+    int slot = pageMapGet(&sim->processSlot, r->process);
+    if (slot < 0)
+    {
+        if (sim->processes == sim->processCapacity)
+        {
+            sim->processCapacity = sim->processCapacity ? 2 * sim->processCapacity : 16;
+            double *sums = realloc(sim->processSum, sim->processCapacity * sizeof(double));
+            long long *counts = realloc(sim->processCount, sim->processCapacity * sizeof(long long));
+            if (sums == NULL || counts == NULL)
+            {
+                printf(RED "\nFatal: out of memory in timed disk simulation\n" RESET);
+                exit(EXIT_FAILURE);
+            }
+            sim->processSum = sums;
+            sim->processCount = counts;
+        }
+        slot = sim->processes++;
+        sim->processSum[slot] = 0;
+        sim->processCount[slot] = 0;
+        pageMapPut(&sim->processSlot, r->process, slot);
+    }
+    sim->processSum[slot] += (double)latency;
+    sim->processCount[slot]++;
+    out->requests++;
+    windowComplete(&sim->window, i);
+}
+
+// Advances the clock to the earliest completion and accounts for it, merged requests and all
+static void completeRequest(TimedDiskSim *sim)
+{
+    sim->now = sim->inFlight.items[0].time;
+    long long i = sim->inFlight.items[0].index;
+    eventPop(&sim->inFlight);
+    while (i >= 0)
+    {
+        long long next = sim->window.next[i & sim->window.mask];
+        retireRequest(sim, i);
+        i = next;
+    }
+}
+
+// When the next completion is due, or the open plug releases, whichever is first
+static long long nextEventTime(const TimedDiskSim *sim)
+{
+    long long t = (sim->inFlight.count > 0) ? sim->inFlight.items[0].time : LLONG_MAX;
+    if (sim->staging.live > 0 && sim->staging.releaseAt < t)
+        t = sim->staging.releaseAt;
+    return t;
+}
+
+// Moves the clock to nextEventTime(); a completion goes before a release at the same moment
+static void handleEvent(TimedDiskSim *sim)
+{
+    if (sim->inFlight.count > 0 && sim->inFlight.items[0].time == nextEventTime(sim))
+        completeRequest(sim);
+    else
+    {
+        sim->now = sim->staging.releaseAt;
+        unplugRequests(sim);
+    }
+}
+
+bool feedTimedDisk(TimedDiskSim *sim, const IoRequest req[], int n, char *error, size_t errorSize)
+{
+    long long startNs = monotonicNanos();
+    bool ok = true;
+    for (int k = 0; k < n && ok; k++)
+    {
+        IoRequest r = req[k];
+        if (!(ok = checkTimedRequest(sim, &r, error, errorSize)))
+            break;
+        if (sim->outstanding > 0)
+        {
+            // Closed loop: the request goes out as soon as one of the earlier ones is done
+            while (sim->window.admitted - sim->result.requests >= sim->outstanding)
+            {
+                dispatchRequests(sim);
+                handleEvent(sim);
+            }
+            r.arrival = sim->now;
+        }
+        else if (r.arrival > sim->now)
+        {
+            // Serve what is queued until the request arrives; a completion at the very moment
+            // it arrives is accounted for first, and the request joins the queue before the next pick
+            dispatchRequests(sim);
+            while (nextEventTime(sim) < r.arrival)
+            {
+                handleEvent(sim);
+                dispatchRequests(sim);
+            }
+            if (nextEventTime(sim) == r.arrival)
+                handleEvent(sim);
+            sim->now = r.arrival;
+        }
+        sim->lastArrival = r.arrival;
+        long long i = sim->window.admitted;
+        windowAdmit(&sim->window, &r);
+        if (sim->cfg.staging.plugUs > 0)
+            stageRequest(sim, i);
+        else
+        {
+            sim->ops->add(sim->scheduler, i);
+            sim->pending++;
+        }
+        if (sim->window.admitted - sim->result.requests > sim->result.peakQueued)
+            sim->result.peakQueued = sim->window.admitted - sim->result.requests;
+    }
+    sim->result.elapsedNs += monotonicNanos() - startNs;
+    return ok;
+}
+
+void finishTimedDisk(TimedDiskSim *sim, TimedDiskResult *out)
+{
+    long long startNs = monotonicNanos();
+    dispatchRequests(sim);
+    while (nextEventTime(sim) != LLONG_MAX)
+    {
+        handleEvent(sim);
+        dispatchRequests(sim);
+    }
+    TimedDiskResult *r = &sim->result;
+    r->makespanUs = sim->now;
+    r->worstProcessMeanUs = 0;
+    for (int s = 0; s < sim->processes; s++)
+        if (sim->processSum[s] / sim->processCount[s] > r->worstProcessMeanUs)
+            r->worstProcessMeanUs = sim->processSum[s] / sim->processCount[s];
+    r->elapsedNs += monotonicNanos() - startNs;
+    *out = *r;
+}
+
+void freeTimedDiskSim(TimedDiskSim *sim)
+{
+    sim->ops->destroy(sim->scheduler);
+    destroyDiskDevice(&sim->device);
+    free(sim->window.slots);
+    free(sim->window.completed);
+    free(sim->window.next);
+    free(sim->inFlight.items);
+    free(sim->staging.units);
+    freePageMap(&sim->staging.byStart);
+    freePageMap(&sim->staging.byEnd);
+    freePageMap(&sim->processSlot);
+    free(sim->processSum);
+    free(sim->processCount);
+}
+
+bool simulateTimedDisk(DiskPolicy policy, const TimedDiskConfig *cfg, long long head, const IoRequest req[], int n,
+                       TimedDiskResult *out, char *error, size_t errorSize)
+{
+    TimedDiskSim sim;
+    if (!createTimedDiskSim(&sim, policy, cfg, head, 0, error, errorSize))
+        return false;
+    bool ok = feedTimedDisk(&sim, req, n, error, errorSize);
+    if (ok)
+        finishTimedDisk(&sim, out);
+    freeTimedDiskSim(&sim);
+    return ok;
+}
+
+long long timeDiskOrder(const DeviceConfig *device, const DiskConfig *disk, const long long req[], const int order[],
+                        const long long travel[], int n, char *error, size_t errorSize)
+{
+    DiskDevice d;
+    if (!createDiskDevice(device, disk->cylinders, &d, error, errorSize))
+        return -1;
+    IoEventHeap inFlight = {NULL, 0, 0}; // the next request goes out when the earliest one finishes
+    IoRequest r = {0, 0, 0, 0, 0, 1, IO_READ};
+    long long now = 0, makespan = 0;
+    for (int i = 0; i < n; i++)
+    {
+        if (inFlight.count == d.queueDepth)
+        {
+            now = inFlight.items[0].time;
+            eventPop(&inFlight);
+        }
+        Rng rng;
+        rngSeed(&rng, STATIC_SECTOR_SEED + (uint64_t)order[i]);
+        r.cylinder = req[order[i]];
+        r.sector = (int)(rngNext(&rng) % (uint64_t)sectorsPerCylinder(device));
+        long long done = d.ops->submit(d.self, &r, travel[i], now);
+        eventPush(&inFlight, done, order[i]);
+        if (done > makespan)
+            makespan = done;
+    }
+    destroyDiskDevice(&d);
+    free(inFlight.items);
+    return makespan;
+}
+
+// ==========================================
+//      INTERACTIVE FRONT END
+// ==========================================
+
+void printTimedDiskResults(const char *device, const TimedDiskResult results[], int count)
+{
+    char title[64];
+    snprintf(title, sizeof(title), "TIMED DISK I/O RESULTS ON %s (ms)", device);
+    printHeader(title);
+    printf(CYAN "| %-8s | %-8s | %-8s | %-8s | %-8s | %-9s | %-8s | %-10s | %-8s |\n" RESET, "Policy", "Mean", "p50",
+           "p99", "p99.9", "Max", "Missed", "Worst Proc", "IOPS");
+    printLine(105);
+    long long bestTail = LLONG_MAX;
+    for (int r = 0; r < count; r++)
+        if (latencyPercentile(&results[r].latency, 0.999) < bestTail)
+            bestTail = latencyPercentile(&results[r].latency, 0.999);
+    for (int r = 0; r < count; r++)
+    {
+        const TimedDiskResult *t = &results[r];
+        const LatencyHistogram *h = &t->latency;
+        long long tail = latencyPercentile(h, 0.999);
+        printf("| %-8s | %-8.2f | %-8.2f | %-8.2f | %s%-8.2f" RESET " | %-9.2f | %7.2f%% | %-10.2f | %-8.1f |\n",
+               diskPolicyName(t->policy), h->total ? h->sum / h->total / 1e3 : 0.0,
+               latencyPercentile(h, 0.5) / 1e3, latencyPercentile(h, 0.99) / 1e3, tail == bestTail ? GREEN : "",
+               tail / 1e3, h->max / 1e3, t->withDeadline ? 100.0 * t->missed / t->withDeadline : 0.0,
+               t->worstProcessMeanUs / 1e3, t->makespanUs ? 1e6 * t->requests / t->makespanUs : 0.0);
+    }
+    printLine(105);
+}
+
+void printStagingResults(const char *device, long long plugUs, const TimedDiskResult unplugged[],
+                         const TimedDiskResult plugged[], int count)
+{
+    char title[80];
+    snprintf(title, sizeof(title), "REQUEST STAGING ON %s (%lld us plug)", device, plugUs);
+    printHeader(title);
+    printf(CYAN "| %-8s | %-8s | %-10s | %-10s | %-12s | %-12s | %-9s | %-9s |\n" RESET, "Policy", "Merged", "Dispatched",
+           "Batch Mean", "Seek Before", "Seek After", "IOPS Bfr", "IOPS Aft");
+    printLine(105);
+    for (int r = 0; r < count; r++)
+    {
+        const TimedDiskResult *b = &unplugged[r], *p = &plugged[r];
+        double before = b->makespanUs ? 1e6 * b->requests / b->makespanUs : 0.0;
+        double after = p->makespanUs ? 1e6 * p->requests / p->makespanUs : 0.0;
+        printf("| %-8s | %7.2f%% | %-10lld | %-10.2f | %-12lld | %s%-12lld" RESET " | %-9.1f | %s%-9.1f" RESET " |\n",
+               diskPolicyName(p->policy), p->requests ? 100.0 * (p->requests - p->dispatched) / p->requests : 0.0,
+               p->dispatched, p->batches ? (double)p->dispatched / p->batches : 0.0, b->seek,
+               p->seek < b->seek ? GREEN : "", p->seek, before, after > before ? GREEN : "", after);
+    }
+    printLine(105);
+}
+
+void runTimedDiskScheduler()
+{
+    TimedDiskConfig cfg;
+    IoWorkloadConfig w;
+    defaultTimedDiskConfig(&cfg, DEVICE_HDD);
+    defaultIoWorkloadConfig(&w);
+    printHeader("DISK SCHEDULING: TIMED ARRIVALS");
+
+    printf("Device (1. Linear seek model  2. HDD  3. SSD  4. All three): ");
+    int device = getSafeInt();
+    printf("Disk size in cylinders (e.g. 200): ");
+    cfg.disk.cylinders = getSafeInt();
+    printf("Number of requests: ");
+    w.count = getSafeInt();
+    printf("Mean gap between arrivals in microseconds (e.g. %.0f): ", w.meanInterarrivalUs);
+    w.meanInterarrivalUs = getSafeInt();
+    printf("Processes (even ones read sequentially, odd ones at random): ");
+    w.processes = getSafeInt();
+    printf("Percentage of writes: ");
+    w.writeFraction = getSafeInt() / 100.0;
+    printf("Read deadline in ms (0 = none): ");
+    w.readDeadlineUs = getSafeInt() * 1000LL;
+    printf("Plug window in microseconds, to merge and batch requests (0 = none): ");
+    long long plugUs = getSafeInt();
+
+    if (cfg.disk.cylinders < 1 || w.count < 1 || w.count > INT_MAX || w.meanInterarrivalUs <= 0 || w.processes < 1 ||
+        w.readDeadlineUs < 0 || plugUs < 0)
+    {
+        printf(RED "Need at least one cylinder, request and process, a positive gap and no negative deadline or plug.\n" RESET);
+        waitForStudent();
+        return;
+    }
+
+    IoRequest *req = safeMalloc((size_t)w.count * sizeof(IoRequest));
+    generateIoWorkload(&w, cfg.disk.cylinders, sectorsPerCylinder(&cfg.device), req);
+    TimedDiskResult results[DISK_TIMED_POLICY_COUNT], plugged[DISK_TIMED_POLICY_COUNT];
+    char error[160];
+    for (int kind = DEVICE_LINEAR; kind <= DEVICE_KIND_COUNT; kind++)
+    {
+        if (device >= DEVICE_LINEAR && device <= DEVICE_KIND_COUNT && kind != device)
+            continue;
+        defaultDeviceConfig(&cfg.device, (DeviceKind)kind);
+        for (int p = DISK_FCFS; p <= DISK_TIMED_POLICY_COUNT; p++)
+            simulateTimedDisk((DiskPolicy)p, &cfg, 0, req, (int)w.count, &results[p - 1], error, sizeof(error));
+        printTimedDiskResults(deviceKindName((DeviceKind)kind), results, DISK_TIMED_POLICY_COUNT);
+        if (plugUs > 0)
+        {
+            TimedDiskConfig plugCfg = cfg;
+            plugCfg.staging.plugUs = plugUs;
+            for (int p = DISK_FCFS; p <= DISK_TIMED_POLICY_COUNT; p++)
+                simulateTimedDisk((DiskPolicy)p, &plugCfg, 0, req, (int)w.count, &plugged[p - 1], error,
+                                  sizeof(error));
+            printStagingResults(deviceKindName((DeviceKind)kind), plugUs, results, plugged, DISK_TIMED_POLICY_COUNT);
+        }
+    }
+    free(req);
+
+    const DeviceConfig *d = &cfg.device;
+    defaultDeviceConfig(&cfg.device, DEVICE_HDD);
+    printf("Linear: %lld us settle + up to %lld us across the disk; %lld us per block transferred.\n", d->settleUs,
+           d->fullStrokeUs, d->transferUs);
+    printf("HDD: %d rpm, %d x %d blocks per cylinder, seeks of %lld us to %lld us growing with sqrt(distance).\n",
+           d->rpm, d->heads, d->sectorsPerTrack, d->trackToTrackUs, d->fullSeekUs);
+    printf("SSD: %d channels x %d dies, queue depth %d; read %lld us, program %lld us, erase %lld us per %d pages.\n",
+           d->channels, d->diesPerChannel, d->queueDepth, d->readUs, d->programUs, d->eraseUs, d->pagesPerBlock);
+    printf("Missed = reads served after their deadline. Worst Proc = mean latency of the slowest process.\n");
+    if (plugUs > 0)
+        printf("Merged = requests joined onto a neighbouring one (same process and direction, up to %d blocks).\n",
+               cfg.staging.mergeLimit);
+    waitForStudent();
+}
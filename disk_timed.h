@@ -0,0 +1,218 @@
+#ifndef DISK_TIMED_H
+#define DISK_TIMED_H
+
+#include "disk_device.h"
+#include "disk_scheduler.h"
+#include "page_replacement.h"
+#include "workload_gen.h"
+
+// --- Constants ---
+#define STATIC_SECTOR_SEED 0x5EC7025EEDULL // places timeDiskOrder's requests around the track
+#define LATENCY_SUB_BITS 4 // 16 buckets per power of two: percentiles within 6.25%
+#define LATENCY_BUCKETS (64 << LATENCY_SUB_BITS)
+
+// --- Structures ---
+/**
+ * Staging in front of the policies, after the Linux block layer's plug.
+ * With plugUs > 0 an arriving request opens a plug, or joins the one
+ * already open, instead of going straight to the policy. While the plug is
+ * open, a request that starts where a staged one from the same process and
+ * direction ends is merged onto its back, and one that ends where such a
+ * request starts onto its front, up to mergeLimit blocks in all. The plug
+ * hands everything it holds to the policy in one batch plugUs after it
+ * opened, or as soon as it holds plugLimit requests after merging.
+ */
+typedef struct
+{
+    long long plugUs; // 0 = no staging: requests reach the policy as they arrive
+    int plugLimit;
+    int mergeLimit; // blocks; 1 = batch without merging
+} IoStagingConfig;
+
+/**
+ * Service times come from the device model (disk_device.h). The deadline policy
+ * follows Linux mq-deadline: sorted batches of up to fifoBatch requests in
+ * one direction (reads or writes), reads preferred until writes have been
+ * passed over writesStarved times, and an expired request restarting the
+ * sweep from itself. The budget policy gives each process in turn up to
+ * `budget` blocks, served in C-LOOK order within the process.
+ */
+typedef struct
+{
+    DiskConfig disk;
+    DeviceConfig device;
+    IoStagingConfig staging;
+    long long readExpireUs, writeExpireUs; // deadline policy, for requests without their own deadline
+    int fifoBatch;
+    int writesStarved;
+    int budget;
+} TimedDiskConfig;
+
+// Log-linear latency histogram: exact below 16 us, then 16 buckets per power of two
+typedef struct
+{
+    long long counts[LATENCY_BUCKETS];
+    long long total, max;
+    double sum;
+} LatencyHistogram;
+
+typedef struct
+{
+    DiskPolicy policy;
+    long long requests, seek;
+    long long makespanUs; // simulated time until the last completion
+    LatencyHistogram latency;
+    long long withDeadline, missed;
+    double worstProcessMeanUs; // mean latency of the worst-treated process
+    long long peakQueued;      // most requests queued or in flight at once
+    long long dispatched;      // requests the device saw once merging is done
+    long long batches, largestBatch; // plug releases, and the most requests one handed over
+    long long elapsedNs;       // wall time of the simulation itself
+} TimedDiskResult;
+
+// Synthetic timed workload: Poisson arrivals spread over `processes`
+typedef struct
+{
+    long long count;
+    uint64_t seed;
+    double meanInterarrivalUs;
+    int processes;            // even-numbered processes read block after block, odd ones jump at random
+    double writeFraction;
+    long long readDeadlineUs; // attached to every read; 0 = none
+} IoWorkloadConfig;
+
+/**
+ * What every timed policy provides. Requests are named by arrival index.
+ * `add` queues an arrived request; `pick` removes and returns the next one
+ * to serve with the arm at `head`, and sets *travel to the cylinders the
+ * arm covers to get there (more than the plain distance when it first
+ * runs to an edge).
+ */
+typedef struct
+{
+    void (*add)(void *self, long long i);
+    long long (*pick)(void *self, long long now, long long head, long long *travel);
+    void (*destroy)(void *self);
+} IoSchedulerOps;
+
+/**
+ * The requests a simulation still needs, by arrival index: request i sits
+ * in slots[i & mask] from arrival until it and every earlier request have
+ * completed. A merged request is served under the index of its earliest
+ * member, whose slot is rewritten to cover them all; next[] chains the
+ * others behind it. The window doubles when the backlog outgrows it, so memory
+ * follows the backlog, not the length of the workload.
+ */
+typedef struct
+{
+    IoRequest *slots;
+    bool *completed;
+    long long *next; // the request merged in after this one, or -1
+    long long mask;
+    long long oldest, admitted;
+} IoWindow;
+
+// Min-heap of (time, request): expiry times for the deadline policy, completions for the device
+typedef struct
+{
+    long long time, index;
+} IoEvent;
+
+typedef struct
+{
+    IoEvent *items;
+    long long count, capacity;
+} IoEventHeap;
+
+// A plugged request and whatever has merged into it, as a range of blocks
+typedef struct
+{
+    long long first, last; // earliest and latest member in the next[] chain
+    long long start;       // first block: cylinder * sectorsPerCylinder + sector
+    int length;            // 0 once merged into another staged request
+} StagedIo;
+
+typedef struct
+{
+    StagedIo *units;
+    int count, capacity, live;
+    PageMap byStart, byEnd; // block where a staged request starts / ends -> units[] index
+    long long releaseAt;
+} IoStaging;
+
+/**
+ * One policy on one device, fed requests in arrival order a chunk at a
+ * time. With `outstanding` > 0 arrival times are ignored: each request
+ * arrives as soon as fewer than `outstanding` are queued or in flight (a
+ * closed loop, as fast as the device allows). The simulation points into
+ * itself, so it must not be copied once created.
+ */
+typedef struct
+{
+    TimedDiskConfig cfg;
+    DiskDevice device;
+    const IoSchedulerOps *ops;
+    void *scheduler;
+    IoWindow window;
+    IoEventHeap inFlight;
+    IoStaging staging;
+    long long now, head, pending, lastArrival;
+    int outstanding;
+    PageMap processSlot; // process id -> index in processSum/processCount
+    double *processSum;
+    long long *processCount;
+    int processes, processCapacity;
+    TimedDiskResult result;
+} TimedDiskSim;
+
+// --- Function Prototypes ---
+void defaultTimedDiskConfig(TimedDiskConfig *cfg, DeviceKind device);
+void defaultIoStagingConfig(IoStagingConfig *cfg);
+void defaultIoWorkloadConfig(IoWorkloadConfig *cfg);
+void generateIoWorkload(const IoWorkloadConfig *cfg, long long cylinders, int sectorsPerCylinder, IoRequest out[]);
+
+void recordLatency(LatencyHistogram *h, long long us);
+long long latencyPercentile(const LatencyHistogram *h, double p); // upper bound of the p-quantile's bucket
+
+bool createTimedDiskSim(TimedDiskSim *sim, DiskPolicy policy, const TimedDiskConfig *cfg, long long head,
+                        int outstanding, char *error, size_t errorSize);
+
+// Serves req[0..n-1], the next requests in arrival order; false with `error` filled on a bad request
+bool feedTimedDisk(TimedDiskSim *sim, const IoRequest req[], int n, char *error, size_t errorSize);
+
+// Serves everything still queued and fills `out`
+void finishTimedDisk(TimedDiskSim *sim, TimedDiskResult *out);
+void freeTimedDiskSim(TimedDiskSim *sim);
+
+/**
+ * Runs req[0..n-1] (in arrival order, on the disk of cfg) through one
+ * policy with the arm starting at `head`. Dispatch is work-conserving:
+ * whenever the device has room for another request in flight (one for a
+ * disk arm, the queue depth for an SSD), the policy picks among the
+ * requests that have arrived by then. Returns false with `error` filled
+ * on invalid input.
+ */
+bool simulateTimedDisk(DiskPolicy policy, const TimedDiskConfig *cfg, long long head, const IoRequest req[], int n,
+                       TimedDiskResult *out, char *error, size_t errorSize);
+
+/**
+ * Simulated microseconds until `device` finishes a static request list
+ * (disk_scheduler.h) served in `order`, every request queued at time 0.
+ * travel[i] is the movement before order[i], edge runs included. Each
+ * request is a one-block read of a sector picked by a fixed hash of its
+ * index in req[], so every policy meets the same rotational positions.
+ * Returns -1 with `error` filled if the device cannot be built.
+ */
+long long timeDiskOrder(const DeviceConfig *device, const DiskConfig *disk, const long long req[], const int order[],
+                        const long long travel[], int n, char *error, size_t errorSize);
+
+void printTimedDiskResults(const char *device, const TimedDiskResult results[], int count);
+
+// Merge rate and batch sizes under the plug, with seek and IOPS beside those of the same runs unstaged
+void printStagingResults(const char *device, long long plugUs, const TimedDiskResult unplugged[],
+                         const TimedDiskResult plugged[], int count);
+
+// Interactive front end: generates a timed workload and compares every policy
+void runTimedDiskScheduler();
+
+#endif
@@ -0,0 +1,262 @@
+#include "dynamic_partition.h"
+#include "compaction.h"
+
+// ==========================================
+//      DYNAMIC PARTITIONS (BOUNDARY TAGS)
+// ==========================================
+
+#define TAG_ALLOCATED 1ULL
+
+static uint64_t readTag(const PartitionHeap *h, long long at)
+{
+    uint64_t tag;
+    memcpy(&tag, h->base + at, sizeof(tag));
+    return tag;
+}
+
+// Writes the header and footer of the block [at, at + size)
+static void writeBlock(PartitionHeap *h, long long at, long long size, bool allocated)
+{
+    uint64_t tag = (uint64_t)size | (allocated ? TAG_ALLOCATED : 0);
+    memcpy(h->base + at, &tag, sizeof(tag));
+    memcpy(h->base + at + size - HEAP_TAG_BYTES, &tag, sizeof(tag));
+}
+
+static long long tagSize(uint64_t tag)
+{
+    return (long long)(tag & ~(uint64_t)(HEAP_ALIGN - 1));
+}
+
+// Whole block needed for `request` payload bytes: aligned, tagged, never below the minimum
+long long heapBlockSizeFor(long long request)
+{
+    long long payload = (request + HEAP_ALIGN - 1) / HEAP_ALIGN * HEAP_ALIGN;
+    long long block = payload + 2 * HEAP_TAG_BYTES;
+    return (block < HEAP_MIN_BLOCK) ? HEAP_MIN_BLOCK : block;
+}
+
+bool initPartitionHeap(PartitionHeap *h, long long arenaSize, FitStrategy strategy)
+{
+    arenaSize -= arenaSize % HEAP_ALIGN;
+    if (arenaSize < HEAP_MIN_BLOCK)
+        return false;
+    // calloc: untouched parts of a large arena never become resident
+    h->base = calloc((size_t)arenaSize, 1);
+    if (h->base == NULL)
+        return false;
+    h->size = arenaSize;
+    h->strategy = strategy;
+    h->freeBytes = arenaSize;
+    memset(&h->stats, 0, sizeof(h->stats));
+    initFitIndex(&h->holes);
+    writeBlock(h, 0, arenaSize, false);
+    fitInsertHole(&h->holes, 0, arenaSize);
+    return true;
+}
+
+void freePartitionHeap(PartitionHeap *h)
+{
+    free(h->base);
+    h->base = NULL;
+    freeFitIndex(&h->holes);
+}
+
+long long partitionAlloc(PartitionHeap *h, long long size)
+{
+    long long need = heapBlockSizeFor(size);
+    long long holeSize = 0;
+    long long at = (size < 0 || need > h->size) ? -1 : fitFindHole(&h->holes, h->strategy, need, &holeSize);
+    if (at == -1)
+    {
+        h->stats.failures++;
+        return -1;
+    }
+
+    fitRemoveHole(&h->holes, at, holeSize);
+    if (holeSize - need >= HEAP_MIN_BLOCK)
+    {
+        // Split: the tail of the hole stays free
+        writeBlock(h, at + need, holeSize - need, false);
+        fitInsertHole(&h->holes, at + need, holeSize - need);
+    }
+    else
+        need = holeSize; // too small to stand alone: hand out the whole hole
+    writeBlock(h, at, need, true);
+
+    h->freeBytes -= need;
+    h->stats.allocs++;
+    h->stats.blockBytes += need;
+    if (h->stats.blockBytes > h->stats.peakBlockBytes)
+        h->stats.peakBlockBytes = h->stats.blockBytes;
+    return at + HEAP_TAG_BYTES;
+}
+
+bool partitionFree(PartitionHeap *h, long long offset)
+{
+    long long at = offset - HEAP_TAG_BYTES;
+    if (at < 0 || at % HEAP_ALIGN != 0 || at + HEAP_MIN_BLOCK > h->size)
+        return false;
+    uint64_t tag = readTag(h, at);
+    long long size = tagSize(tag);
+    if (!(tag & TAG_ALLOCATED) || size < HEAP_MIN_BLOCK || at + size > h->size ||
+        readTag(h, at + size - HEAP_TAG_BYTES) != tag)
+        return false; // not the start of a live block
+
+    h->freeBytes += size;
+    h->stats.frees++;
+    h->stats.blockBytes -= size;
+
+    // Coalesce: the footer just below and the header just above say whether the neighbours are free
+    long long start = at, total = size;
+    if (at > 0)
+    {
+        uint64_t below = readTag(h, at - HEAP_TAG_BYTES);
+        if (!(below & TAG_ALLOCATED))
+        {
+            start = at - tagSize(below);
+            total += tagSize(below);
+            fitRemoveHole(&h->holes, start, tagSize(below));
+        }
+    }
+    if (at + size < h->size)
+    {
+        uint64_t above = readTag(h, at + size);
+        if (!(above & TAG_ALLOCATED))
+        {
+            total += tagSize(above);
+            fitRemoveHole(&h->holes, at + size, tagSize(above));
+        }
+    }
+    writeBlock(h, start, total, false);
+    fitInsertHole(&h->holes, start, total);
+    return true;
+}
+
+long long heapLargestHole(const PartitionHeap *h)
+{
+    long long largest = freeTreeMaxSize(&h->holes.byAddr);
+    return (largest < 0) ? 0 : largest;
+}
+
+int heapHoleCount(const PartitionHeap *h)
+{
+    return h->holes.byAddr.count;
+}
+
+void heapMemoryMap(const PartitionHeap *h, char *out, int width)
+{
+    memset(out, '.', (size_t)width);
+    out[width] = '\0';
+    for (long long at = 0; at < h->size;)
+    {
+        uint64_t tag = readTag(h, at);
+        long long size = tagSize(tag);
+        if (tag & TAG_ALLOCATED)
+        {
+            int first = (int)(at * width / h->size);
+            int last = (int)((at + size - 1) * width / h->size);
+            for (int c = first; c <= last; c++)
+                out[c] = '#';
+        }
+        at += size;
+    }
+}
+
+int heapLiveBlocks(const PartitionHeap *h, HeapBlock **out)
+{
+    int count = 0, capacity = 64;
+    HeapBlock *blocks = safeMalloc(capacity * sizeof(HeapBlock));
+    for (long long at = 0; at < h->size;)
+    {
+        uint64_t tag = readTag(h, at);
+        if (tag & TAG_ALLOCATED)
+        {
+            if (count == capacity)
+            {
+                capacity *= 2;
+                HeapBlock *grown = realloc(blocks, capacity * sizeof(HeapBlock));
+                if (grown == NULL)
+                {
+                    printf(RED "\nFatal: out of memory listing live blocks\n" RESET);
+                    exit(EXIT_FAILURE);
+                }
+                blocks = grown;
+            }
+            blocks[count].offset = at;
+            blocks[count].size = tagSize(tag);
+            count++;
+        }
+        at += tagSize(tag);
+    }
+    *out = blocks;
+    return count;
+}
+
+void heapRelocate(PartitionHeap *h, const Relocation moves[], int count, const HeapBlock layout[], int n)
+{
+    // A block's tags travel with it, so moved blocks arrive already tagged
+    for (int i = 0; i < count; i++)
+        memmove(h->base + moves[i].to, h->base + moves[i].from, (size_t)moves[i].bytes);
+
+    freeFitIndex(&h->holes);
+    initFitIndex(&h->holes);
+    long long cursor = 0;
+    for (int i = 0; i <= n; i++)
+    {
+        long long next = (i < n) ? layout[i].offset : h->size;
+        if (next > cursor)
+        {
+            writeBlock(h, cursor, next - cursor, false);
+            fitInsertHole(&h->holes, cursor, next - cursor);
+        }
+        if (i < n)
+            cursor = layout[i].offset + layout[i].size;
+    }
+}
+
+void partitionStats(const PartitionHeap *h, AllocatorStats *out)
+{
+    *out = h->stats;
+    out->freeBytes = h->freeBytes;
+    out->largestFree = heapLargestHole(h);
+    out->freeRegions = heapHoleCount(h);
+    out->metadataBytes = (long long)(freeTreeBytes(&h->holes.byAddr) + freeTreeBytes(&h->holes.bySize));
+}
+
+// ==========================================
+//      ALLOCATOR INTERFACE
+// ==========================================
+
+static long long opsAlloc(void *self, long long size)
+{
+    return partitionAlloc(self, size);
+}
+
+static bool opsRelease(void *self, long long offset)
+{
+    return partitionFree(self, offset);
+}
+
+static void opsStats(const void *self, AllocatorStats *out)
+{
+    partitionStats(self, out);
+}
+
+static void opsMemoryMap(const void *self, char *out, int width)
+{
+    heapMemoryMap(self, out, width);
+}
+
+static void opsDestroy(void *self)
+{
+    freePartitionHeap(self);
+    free(self);
+}
+
+static bool opsCompact(void *self, CompactionPolicy policy, long long size, Relocation **moves, int *count)
+{
+    return partitionCompact(self, policy, size, moves, count);
+}
+
+const AllocatorOps partitionOps = {"Partition", opsAlloc, opsRelease, opsStats, opsMemoryMap, opsDestroy,
+                                   opsCompact};
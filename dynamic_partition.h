@@ -0,0 +1,62 @@
+#ifndef DYNAMIC_PARTITION_H
+#define DYNAMIC_PARTITION_H
+
+#include "allocator.h"
+#include "free_index.h"
+
+// --- Constants ---
+#define HEAP_ALIGN 8
+#define HEAP_TAG_BYTES 8                        // one header word, one footer word per block
+#define HEAP_MIN_BLOCK (2 * HEAP_TAG_BYTES + 16) // smaller leftovers are not split off
+
+// --- Structures ---
+// A block as laid out in an arena, tags included
+typedef struct
+{
+    long long offset;
+    long long size;
+} HeapBlock;
+
+/**
+ * Variable-partition heap over a simulated arena. Every block carries a
+ * boundary tag (size | allocated bit) at both ends, so freeing can find and
+ * merge both neighbours in O(1); free holes are also kept in a FitIndex so
+ * best/first/worst fit placement is O(log holes).
+ */
+typedef struct
+{
+    unsigned char *base;
+    long long size;
+    FitStrategy strategy;
+    FitIndex holes;
+    long long freeBytes;
+    AllocatorStats stats; // counters only; the rest is filled in by partitionStats
+} PartitionHeap;
+
+// Allocator interface for a PartitionHeap (self = PartitionHeap *)
+extern const AllocatorOps partitionOps;
+
+// --- Heap ---
+bool initPartitionHeap(PartitionHeap *h, long long arenaSize, FitStrategy strategy);
+void freePartitionHeap(PartitionHeap *h);
+long long partitionAlloc(PartitionHeap *h, long long size); // payload offset, or -1
+bool partitionFree(PartitionHeap *h, long long offset);
+long long heapLargestHole(const PartitionHeap *h);
+int heapHoleCount(const PartitionHeap *h);
+void partitionStats(const PartitionHeap *h, AllocatorStats *out);
+long long heapBlockSizeFor(long long request); // whole block (tags, alignment) a request takes
+
+// Live blocks in address order, as a new array the caller frees (walks the tags)
+int heapLiveBlocks(const PartitionHeap *h, HeapBlock **out);
+
+/**
+ * Copies blocks to their new places (block offsets, applied in the given
+ * order) and rebuilds the free holes around `layout`, the live blocks'
+ * final positions in address order.
+ */
+void heapRelocate(PartitionHeap *h, const Relocation moves[], int count, const HeapBlock layout[], int n);
+
+// Draws the arena as `width` cells: '#' allocated, '.' free (walks the tags)
+void heapMemoryMap(const PartitionHeap *h, char *out, int width);
+
+#endif
@@ -0,0 +1,270 @@
+#include "free_index.h"
+
+// ==========================================
+//      FREE-BLOCK SEARCH TREE (TREAP)
+// ==========================================
+
+void initFreeTree(FreeTree *t)
+{
+    t->nodes = NULL;
+    t->capacity = 0;
+    t->used = 0;
+    t->freeList = -1;
+    t->root = -1;
+    t->count = 0;
+    t->seed = 2463534242u;
+}
+
+void freeFreeTree(FreeTree *t)
+{
+    free(t->nodes);
+    initFreeTree(t);
+}
+
+size_t freeTreeBytes(const FreeTree *t)
+{
+    return (size_t)t->capacity * sizeof(FreeNode);
+}
+
+static bool lessThan(const FreeNode *node, long long key, long long tie)
+{
+    return node->key < key || (node->key == key && node->tie < tie);
+}
+
+static long long subtreeMax(const FreeTree *t, int node)
+{
+    return (node == -1) ? LLONG_MIN : t->nodes[node].maxSize;
+}
+
+static void update(FreeTree *t, int node)
+{
+    FreeNode *nd = &t->nodes[node];
+    long long best = nd->size;
+    long long l = subtreeMax(t, nd->left), r = subtreeMax(t, nd->right);
+    if (l > best)
+        best = l;
+    if (r > best)
+        best = r;
+    nd->maxSize = best;
+}
+
+// Splits `node` into keys < (key, tie) and keys >= (key, tie)
+static void split(FreeTree *t, int node, long long key, long long tie, int *lo, int *hi)
+{
+    if (node == -1)
+    {
+        *lo = *hi = -1;
+        return;
+    }
+    if (lessThan(&t->nodes[node], key, tie))
+    {
+        split(t, t->nodes[node].right, key, tie, &t->nodes[node].right, hi);
+        *lo = node;
+    }
+    else
+    {
+        split(t, t->nodes[node].left, key, tie, lo, &t->nodes[node].left);
+        *hi = node;
+    }
+    update(t, node);
+}
+
+// Joins two treaps where every key in `lo` is below every key in `hi`
+static int merge(FreeTree *t, int lo, int hi)
+{
+    if (lo == -1)
+        return hi;
+    if (hi == -1)
+        return lo;
+    if (t->nodes[lo].prio > t->nodes[hi].prio)
+    {
+        t->nodes[lo].right = merge(t, t->nodes[lo].right, hi);
+        update(t, lo);
+        return lo;
+    }
+    t->nodes[hi].left = merge(t, lo, t->nodes[hi].left);
+    update(t, hi);
+    return hi;
+}
+
+static int newNode(FreeTree *t)
+{
+    if (t->freeList != -1)
+    {
+        int node = t->freeList;
+        t->freeList = t->nodes[node].left;
+        return node;
+    }
+    if (t->used == t->capacity)
+    {
+        int cap = t->capacity ? t->capacity * 2 : 64;
+        FreeNode *grown = realloc(t->nodes, cap * sizeof(FreeNode));
+        if (grown == NULL)
+        {
+            printf(RED "\nFatal: out of memory in free-block index\n" RESET);
+            exit(EXIT_FAILURE);
+        }
+        t->nodes = grown;
+        t->capacity = cap;
+    }
+    return t->used++;
+}
+
+void freeTreeInsert(FreeTree *t, long long key, long long tie, long long size)
+{
+    int node = newNode(t);
+    // xorshift32: cheap priorities, deterministic across runs
+    t->seed ^= t->seed << 13;
+    t->seed ^= t->seed >> 17;
+    t->seed ^= t->seed << 5;
+
+    FreeNode *nd = &t->nodes[node];
+    nd->key = key;
+    nd->tie = tie;
+    nd->size = nd->maxSize = size;
+    nd->prio = t->seed;
+    nd->left = nd->right = -1;
+
+    int lo, hi;
+    split(t, t->root, key, tie, &lo, &hi);
+    t->root = merge(t, merge(t, lo, node), hi);
+    t->count++;
+}
+
+static int eraseAt(FreeTree *t, int node, long long key, long long tie, bool *found)
+{
+    if (node == -1)
+        return -1;
+    FreeNode *nd = &t->nodes[node];
+    if (nd->key == key && nd->tie == tie)
+    {
+        int joined = merge(t, nd->left, nd->right);
+        nd->left = t->freeList;
+        t->freeList = node;
+        *found = true;
+        return joined;
+    }
+    if (lessThan(nd, key, tie))
+        nd->right = eraseAt(t, nd->right, key, tie, found);
+    else
+        nd->left = eraseAt(t, nd->left, key, tie, found);
+    update(t, node);
+    return node;
+}
+
+bool freeTreeErase(FreeTree *t, long long key, long long tie)
+{
+    bool found = false;
+    t->root = eraseAt(t, t->root, key, tie, &found);
+    if (found)
+        t->count--;
+    return found;
+}
+
+int freeTreeLowerBound(const FreeTree *t, long long key, long long tie)
+{
+    int node = t->root, best = -1;
+    while (node != -1)
+    {
+        if (lessThan(&t->nodes[node], key, tie))
+            node = t->nodes[node].right;
+        else
+        {
+            best = node;
+            node = t->nodes[node].left;
+        }
+    }
+    return best;
+}
+
+int freeTreePredecessor(const FreeTree *t, long long key, long long tie)
+{
+    int node = t->root, best = -1;
+    while (node != -1)
+    {
+        if (lessThan(&t->nodes[node], key, tie))
+        {
+            best = node;
+            node = t->nodes[node].right;
+        }
+        else
+            node = t->nodes[node].left;
+    }
+    return best;
+}
+
+// Leftmost node (in key order) whose size is at least minSize
+int freeTreeFirstFit(const FreeTree *t, long long minSize)
+{
+    int node = t->root;
+    if (subtreeMax(t, node) < minSize)
+        return -1;
+    while (1)
+    {
+        const FreeNode *nd = &t->nodes[node];
+        if (subtreeMax(t, nd->left) >= minSize)
+            node = nd->left;
+        else if (nd->size >= minSize)
+            return node;
+        else
+            node = nd->right;
+    }
+}
+
+long long freeTreeMaxSize(const FreeTree *t)
+{
+    return subtreeMax(t, t->root);
+}
+
+// ==========================================
+//      FIT INDEX
+// ==========================================
+
+void initFitIndex(FitIndex *ix)
+{
+    initFreeTree(&ix->byAddr);
+    initFreeTree(&ix->bySize);
+}
+
+void freeFitIndex(FitIndex *ix)
+{
+    freeFreeTree(&ix->byAddr);
+    freeFreeTree(&ix->bySize);
+}
+
+void fitInsertHole(FitIndex *ix, long long addr, long long size)
+{
+    freeTreeInsert(&ix->byAddr, addr, 0, size);
+    freeTreeInsert(&ix->bySize, size, addr, size);
+}
+
+void fitRemoveHole(FitIndex *ix, long long addr, long long size)
+{
+    freeTreeErase(&ix->byAddr, addr, 0);
+    freeTreeErase(&ix->bySize, size, addr);
+}
+
+long long fitFindHole(const FitIndex *ix, FitStrategy strategy, long long request, long long *size)
+{
+    int node = -1;
+    const FreeTree *tree = &ix->byAddr;
+    if (strategy == FIT_FIRST)
+        node = freeTreeFirstFit(tree, request);
+    else if (strategy == FIT_WORST)
+    {
+        // The largest hole overall; the leftmost one among equals
+        long long largest = freeTreeMaxSize(tree);
+        if (largest >= request)
+            node = freeTreeFirstFit(tree, largest);
+    }
+    else if (strategy == FIT_BEST)
+    {
+        tree = &ix->bySize;
+        node = freeTreeLowerBound(tree, request, LLONG_MIN);
+    }
+    if (node == -1)
+        return -1;
+    if (size != NULL)
+        *size = tree->nodes[node].size;
+    return (strategy == FIT_BEST) ? tree->nodes[node].tie : tree->nodes[node].key;
+}
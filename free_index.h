@@ -0,0 +1,73 @@
+#ifndef FREE_INDEX_H
+#define FREE_INDEX_H
+
+#include "utils.h"
+
+// --- Structures ---
+typedef struct
+{
+    long long key, tie; // ordering: key first, then tie
+    long long size;
+    long long maxSize;  // largest size in this subtree
+    unsigned prio;
+    int left, right;
+} FreeNode;
+
+/**
+ * Balanced (treap) search tree over free blocks, ordered by (key, tie) and
+ * augmented with the subtree's largest block size. Keyed by address it
+ * answers "leftmost block of at least N"; keyed by (size, address) it
+ * answers "smallest block of at least N". Nodes live in one growable array
+ * and are addressed by index, so the tree has no per-node allocations.
+ */
+typedef struct
+{
+    FreeNode *nodes;
+    int capacity;
+    int used;
+    int freeList; // recycled node indices, chained through `left`
+    int root;
+    int count;
+    unsigned seed;
+} FreeTree;
+
+// Allocation strategies; the values match the menu numbering
+typedef enum
+{
+    FIT_BEST = 1,
+    FIT_FIRST = 2,
+    FIT_WORST = 3
+} FitStrategy;
+
+// Free holes indexed twice: by address (first/worst fit) and by size (best fit)
+typedef struct
+{
+    FreeTree byAddr;
+    FreeTree bySize;
+} FitIndex;
+
+// --- Free Tree ---
+void initFreeTree(FreeTree *t);
+void freeFreeTree(FreeTree *t);
+void freeTreeInsert(FreeTree *t, long long key, long long tie, long long size);
+bool freeTreeErase(FreeTree *t, long long key, long long tie);
+int freeTreeLowerBound(const FreeTree *t, long long key, long long tie); // node index or -1
+int freeTreePredecessor(const FreeTree *t, long long key, long long tie); // last node below (key, tie), or -1
+int freeTreeFirstFit(const FreeTree *t, long long minSize);              // node index or -1
+long long freeTreeMaxSize(const FreeTree *t);                            // LLONG_MIN when empty
+size_t freeTreeBytes(const FreeTree *t);
+
+// --- Fit Index ---
+void initFitIndex(FitIndex *ix);
+void freeFitIndex(FitIndex *ix);
+void fitInsertHole(FitIndex *ix, long long addr, long long size);
+void fitRemoveHole(FitIndex *ix, long long addr, long long size);
+
+/**
+ * Picks a hole of at least `request` units, O(log holes). Ties go to the
+ * lowest address, matching a linear scan in address order.
+ * Returns the hole's address (and its size in *size), or -1 if none fits.
+ */
+long long fitFindHole(const FitIndex *ix, FitStrategy strategy, long long request, long long *size);
+
+#endif
@@ -11,24 +11,38 @@
 #include "race_condition.h"
 #include "reader_writer.h"
 #include "dining_philosophers.h"
+#include "batch_mode.h"
+#include "priority_scheduling.h"
+#include "scheduler_compare.h"
+#include "smp_scheduling.h"
+#include "workload_gen.h"
 
-int main()
+int main(int argc, char *argv[])
 {
+    // Any command-line flags select the non-interactive batch mode
+    if (argc > 1)
+        return runBatchMode(argc, argv);
+
+    // Opt-in: redraw only the dashboard lines that changed between frames
+    if (getenv("OSSIM_DIFF_REDRAW") != NULL)
+        setIncrementalRedraw(true);
+
     int choice;
     while (1)
     {
-        system(CLEAR_SCREEN);
+        beginFrame();
         printHeader("ULTIMATE OS SIMULATOR");
 
-        printf(YELLOW "1." RESET " CPU Scheduling (FCFS, SJF, SRTF, RR)\n");
-        printf(YELLOW "2." RESET " Memory Allocation (Best, First, Worst Fit)\n");
-        printf(YELLOW "3." RESET " Deadlock Avoidance (Banker's Algorithm)\n");
-        printf(YELLOW "4." RESET " Disk Scheduling Visualizer (FCFS)\n");
-        printf(YELLOW "5." RESET " Page Replacement (FIFO Virtual Memory)\n");
-        printf(YELLOW "6." RESET " Race Condition Demo (Concurrency Error)\n");
-        printf(YELLOW "7." RESET " Process Sync (Reader-Writer Problem)\n");
-        printf(YELLOW "8." RESET " Deadlock Simulation (Dining Philosophers)\n");
-        printf(YELLOW "9." RESET " Exit Simulator\n");
+        outPuts(YELLOW "1." RESET " CPU Scheduling (FCFS, SJF, SRTF, RR, Priority, MLFQ)\n");
+        outPuts(YELLOW "2." RESET " Memory Allocation (Best, First, Worst Fit)\n");
+        outPuts(YELLOW "3." RESET " Deadlock Avoidance (Banker's Algorithm)\n");
+        outPuts(YELLOW "4." RESET " Disk Scheduling (FCFS, SSTF, SCAN, C-SCAN, LOOK, C-LOOK)\n");
+        outPuts(YELLOW "5." RESET " Page Replacement (FIFO, LRU, LFU, Clock, OPT, ARC, 2Q, CLOCK-Pro)\n");
+        outPuts(YELLOW "6." RESET " Race Condition Demo (Concurrency Error)\n");
+        outPuts(YELLOW "7." RESET " Process Sync (Reader-Writer Problem)\n");
+        outPuts(YELLOW "8." RESET " Deadlock Simulation (Dining Philosophers)\n");
+        outPuts(YELLOW "9." RESET " Exit Simulator\n");
+        endFrame();
 
         printf(CYAN "\nSelect Module: " RESET);
         choice = getSafeInt();
@@ -44,19 +58,43 @@ int main()
         case 1:
         {
             // --- CPU Scheduling Sub-Menu ---
-            int n;
-            Process original[100], working[100];
+            int n = 0;
+            Process *original = NULL;
             printHeader("CPU SCHEDULING SETUP");
-            printf("Enter number of processes: ");
-            n = getSafeInt();
-            for (int i = 0; i < n; i++)
+            printf("1. Enter processes manually\n2. Generate synthetic workload\n3. Load workload file\nSource: ");
+            int source = getSafeInt();
+
+            if (source == 2)
+                original = promptGeneratedWorkload(&n);
+            else if (source == 3)
+                original = promptLoadWorkload(&n);
+            else
             {
-                original[i].id = i + 1;
-                printf("P%d (Burst, Arrival, Priority): ", i + 1);
-                original[i].bt = getSafeInt();
-                original[i].at = getSafeInt();
-                original[i].pr = getSafeInt();
+                printf("Enter number of processes: ");
+                n = getSafeInt();
+                if (n > 0)
+                    original = safeMalloc(n * sizeof(Process));
+                for (int i = 0; i < n; i++)
+                {
+                    original[i].id = i + 1;
+                    printf("P%d (Burst, Arrival, Priority): ", i + 1);
+                    original[i].bt = getSafeInt();
+                    original[i].at = getSafeInt();
+                    original[i].pr = getSafeInt();
+                }
             }
+            if (original == NULL || n <= 0)
+            {
+                free(original);
+                waitForInput();
+                break;
+            }
+            // Order by arrival once; every algorithm below reuses it
+            sortByArrival(original, n);
+
+            Process *working = safeMalloc(n * sizeof(Process));
+            SchedTrace trace;
+            initTrace(&trace);
 
             while (1)
             {
@@ -66,11 +104,12 @@ int main()
                 int algo, mode = 1;
 
                 printf("\n" BLUE "Select Algorithm:" RESET "\n");
-                printf("1. FCFS\n2. SJF\n3. SRTF\n4. Round Robin\n5. Back\n");
+                printf("1. FCFS\n2. SJF\n3. SRTF\n4. Round Robin\n5. Priority (preemptive, aging)\n6. MLFQ\n"
+                       "7. Multi-core (SMP)\n8. Compare All (parallel)\n9. Back\n");
                 printf("Selection: ");
                 algo = getSafeInt();
 
-                if (algo == 5)
+                if (algo == 9)
                     break;
 
                 if (algo == 3)
@@ -80,26 +119,56 @@ int main()
                 }
 
                 if (mode == 2 && algo == 3)
-                    runInteractiveSRTF(working, n);
+                    runInteractiveSRTF(working, n, &trace);
                 else
                 {
                     if (algo == 1)
-                        runFCFS(working, n);
+                        runFCFS(working, n, &trace);
                     else if (algo == 2)
-                        runSJF(working, n);
+                        runSJF(working, n, &trace);
                     else if (algo == 3)
-                        runStandardSRTF(working, n);
+                        runStandardSRTF(working, n, &trace);
                     else if (algo == 4)
                     {
                         printf("Enter Time Quantum: ");
                         int q = getSafeInt();
-                        runRoundRobin(working, n, q);
+                        if (q <= 0)
+                            printf(RED "Quantum must be positive.\n" RESET);
+                        else
+                            runRoundRobin(working, n, q, &trace);
+                    }
+                    else if (algo == 5)
+                    {
+                        printf("Enter Aging Interval (0 = off): ");
+                        int aging = getSafeInt();
+                        runPriority(working, n, aging, &trace);
+                    }
+                    else if (algo == 6)
+                    {
+                        MLFQConfig cfg;
+                        printf("Enter Number of Queues (1-%d): ", PRIO_LEVELS);
+                        cfg.levels = getSafeInt();
+                        printf("Enter Top Queue Quantum: ");
+                        cfg.baseQuantum = getSafeInt();
+                        printf("Enter Boost Interval (0 = off): ");
+                        cfg.boostInterval = getSafeInt();
+                        if (cfg.baseQuantum <= 0)
+                            printf(RED "Quantum must be positive.\n" RESET);
+                        else
+                            runMLFQ(working, n, &cfg, &trace);
                     }
+                    else if (algo == 7)
+                        runSMPSimulation(working, n);
+                    else if (algo == 8)
+                        runSchedulerComparison(original, n);
                 }
                 printf(GREEN "\nRun another algorithm with same data? (1=Yes, 0=No): " RESET);
                 if (!getSafeInt())
                     break;
             }
+            freeTrace(&trace);
+            free(working);
+            free(original);
             break;
         }
         case 2:
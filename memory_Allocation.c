@@ -5,44 +5,342 @@
 
 void displayMemoryAnalysis(int processes, int processSize[], int allocation[], int blockSize[])
 {
-    int totalInternalFrag = 0, unallocatedCount = 0;
+    holdOutput();
+    long long totalInternalFrag = 0;
+    int unallocatedCount = 0;
     printHeader("MEMORY ANALYSIS");
-    printf(CYAN "| %-10s | %-12s | %-10s | %-15s |\n" RESET, "Process", "Size", "Block", "Internal Frag");
+    outPrintf(CYAN "| %-10s | %-12s | %-10s | %-15s |\n" RESET, "Process", "Size", "Block", "Internal Frag");
     printLine(60);
 
     for (int i = 0; i < processes; i++)
     {
-        printf("| P%-8d | %-12d | ", i + 1, processSize[i]);
+        outPrintf("| P%-8d | %-12d | ", i + 1, processSize[i]);
         if (allocation[i] != -1)
         {
             int frag = blockSize[allocation[i]] - processSize[i];
             totalInternalFrag += frag;
-            printf("%-10d | " GREEN "%-15d" RESET " |\n", allocation[i] + 1, frag);
+            outPrintf("%-10d | " GREEN "%-15d" RESET " |\n", allocation[i] + 1, frag);
         }
         else
         {
             unallocatedCount++;
-            printf(RED "%-10s" RESET " | %-15s |\n", "N/A", "N/A");
+            outPrintf(RED "%-10s" RESET " | %-15s |\n", "N/A", "N/A");
         }
     }
     printLine(60);
-    printf(YELLOW "Total Internal Fragmentation: %d KB\n", totalInternalFrag);
-    printf("Unallocated Processes: %d\n" RESET, unallocatedCount);
+    outPrintf(YELLOW "Total Internal Fragmentation: %lld KB\n", totalInternalFrag);
+    outPrintf("Unallocated Processes: %d\n" RESET, unallocatedCount);
+    releaseOutput();
+}
+
+// Would merging the free space have placed the processes that did not fit?
+void displayCompactionWhatIf(int blocks, int bSize[], int processes, int pSize[], int allocation[])
+{
+    holdOutput();
+    printHeader("COMPACTION WHAT-IF");
+    outPrintf(CYAN "| %-9s | %-8s | %-12s | %-11s | %-12s | %-14s |\n" RESET, "Policy", "Rescued", "Still Failed",
+              "Compactions", "Bytes Moved", "Bytes/Rescued");
+    printLine(84);
+    for (int policy = COMPACT_SLIDING; policy <= COMPACT_MIN_MOVE; policy++)
+    {
+        CompactionReport rep;
+        fixedCompactionWhatIf(blocks, bSize, processes, pSize, allocation, (CompactionPolicy)policy, &rep);
+        outPrintf("| %-9s | " GREEN "%-8d" RESET " | %-12d | %-11d | %-12lld | %-14.1f |\n", compactionName(rep.policy),
+                  rep.rescued, rep.stillFailed, rep.compactions, rep.bytesMoved,
+                  rep.rescued ? (double)rep.bytesMoved / rep.rescued : 0.0);
+    }
+    printLine(84);
+    outPuts(YELLOW "Partitions are dissolved into one memory; each unplaced process is tried in order and\n"
+                    "memory is compacted only when no gap fits it.\n" RESET);
+    releaseOutput();
+}
+
+// Failed allocations compact the heap and retry: what it rescues and what it costs
+void compareCompaction(const HeapEvent events[], int count, long long arenaSize)
+{
+    holdOutput();
+    printHeader("COMPACTION STUDY");
+    outPrintf(CYAN "| %-9s | %-9s | %-7s | %-8s | %-11s | %-12s | %-8s | %-10s |\n" RESET, "Engine", "Policy", "Failed",
+              "Rescued", "Compactions", "Bytes Moved", "Load", "Time (us)");
+    printLine(96);
+    for (int e = ENGINE_BEST_FIT; e <= ENGINE_WORST_FIT; e++)
+        for (int policy = COMPACT_NONE; policy <= COMPACT_MIN_MOVE; policy++)
+        {
+            Allocator allocator;
+            if (!createAllocator((AllocatorEngine)e, arenaSize, &allocator))
+            {
+                outPrintf("| %-9s | " RED "%-78s" RESET " |\n", engineName((AllocatorEngine)e), "arena too small");
+                break;
+            }
+            HeapReplay replay;
+            initHeapReplay(&replay, allocator);
+            replay.compaction = (CompactionPolicy)policy;
+            for (int i = 0; i < count; i++)
+                applyHeapEvent(&replay, &events[i], NULL);
+
+            AllocatorStats st;
+            allocator.ops->stats(allocator.self, &st);
+            outPrintf("| %-9s | %-9s | %-7lld | %-8lld | %-11lld | %-12lld | ", engineName((AllocatorEngine)e),
+                      compactionName((CompactionPolicy)policy), st.failures, replay.rescued, replay.compactions,
+                      replay.bytesMoved);
+            if (replay.compactions > 0)
+                outPrintf("%7.1f%% | %-10.1f |\n", 100.0 * replay.loadAtCompaction / replay.compactions,
+                          replay.compactionNs / 1000.0);
+            else
+                outPrintf("%-8s | %-10s |\n", "-", "-");
+            freeHeapReplay(&replay);
+            destroyAllocator(&allocator);
+        }
+    printLine(96);
+    outPuts(YELLOW "Load = average share of the arena in use when compaction ran. Buddy and slab blocks\n"
+                    "cannot move, so only the fit strategies compact.\n" RESET);
+    releaseOutput();
+}
+
+// Timeline of a dynamic-partition run plus the state it ended in
+void displayHeapAnalysis(const HeapSample samples[], int count, const Allocator *allocator, const HeapReplay *replay)
+{
+    holdOutput();
+    printHeader("DYNAMIC PARTITION ANALYSIS");
+    outPrintf(CYAN "| %-6s | %-6s | %-9s | %-10s | %-10s | %-10s | %-6s | %-9s | %-9s |\n" RESET, "Event", "Op",
+              "Offset", "Allocated", "Free", "Largest", "Holes", "Ext Frag", "Latency");
+    printLine(102);
+    for (int i = 0; i < count; i++)
+    {
+        const HeapSample *s = &samples[i];
+        outPrintf("| %-6lld | %-6s | ", s->event, (s->op == HEAP_ALLOC) ? "alloc" : "free");
+        if (s->ok)
+            outPrintf(GREEN "%-9lld" RESET, s->offset);
+        else
+            outPrintf(RED "%-9s" RESET, "FAILED");
+        outPrintf(" | %-10lld | %-10lld | %-10lld | %-6lld | %8.2f%% | %7lldns |\n", s->blockBytes, s->freeBytes,
+                  s->largestHole, s->holes, s->externalFrag, s->latencyNs);
+    }
+    printLine(102);
+
+    char map[65];
+    allocator->ops->memoryMap(allocator->self, map, 64);
+    outPrintf("\nMemory map (" GREEN "#" RESET " allocated, . free):\n  [%s]\n", map);
+
+    AllocatorStats st;
+    allocator->ops->stats(allocator->self, &st);
+    outPrintf(YELLOW "\nPeak allocated: %lld bytes, allocator metadata: %lld bytes\n", st.peakBlockBytes,
+              st.metadataBytes);
+    outPrintf("Allocations: %lld, Frees: %lld, Failed requests: %lld\n", st.allocs, st.frees, st.failures);
+    outPrintf("Internal Fragmentation (headers, padding, rounding): %lld bytes\n",
+              st.blockBytes - replay->requestedBytes);
+    outPrintf("External Fragmentation: %.2f%% of free memory outside the largest free region (%lld bytes)\n",
+              externalFragmentation(&st), st.largestFree);
+    outPrintf("Average operation latency: %.1f ns (max %lld ns)\n" RESET,
+              replay->events ? (double)replay->totalLatencyNs / replay->events : 0.0, replay->maxLatencyNs);
+    releaseOutput();
+}
+
+// Replays the same events through every engine and compares the end state
+void compareAllocators(const HeapEvent events[], int count, long long arenaSize)
+{
+    holdOutput();
+    printHeader("ALLOCATOR COMPARISON");
+    outPrintf(CYAN "| %-10s | %-8s | %-12s | %-12s | %-9s | %-12s | %-10s |\n" RESET, "Engine", "Failed",
+              "Peak Bytes", "Internal", "Ext Frag", "Ops/sec", "Metadata");
+    printLine(96);
+    for (int e = ENGINE_BEST_FIT; e <= ENGINE_SLAB; e++)
+    {
+        Allocator allocator;
+        if (!createAllocator((AllocatorEngine)e, arenaSize, &allocator))
+        {
+            outPrintf("| %-10s | " RED "%-78s" RESET " |\n", engineName((AllocatorEngine)e), "arena too small");
+            continue;
+        }
+        HeapReplay replay;
+        initHeapReplay(&replay, allocator);
+        for (int i = 0; i < count; i++)
+            applyHeapEvent(&replay, &events[i], NULL);
+
+        AllocatorStats st;
+        allocator.ops->stats(allocator.self, &st);
+        double opsPerSec = replay.totalLatencyNs > 0 ? replay.events * 1e9 / replay.totalLatencyNs : 0.0;
+        outPrintf("| %-10s | %-8lld | %-12lld | %-12lld | %8.2f%% | %-12.0f | %-10lld |\n",
+                  engineName((AllocatorEngine)e), st.failures, st.peakBlockBytes, st.blockBytes - replay.requestedBytes,
+                  externalFragmentation(&st), opsPerSec, st.metadataBytes);
+        freeHeapReplay(&replay);
+        destroyAllocator(&allocator);
+    }
+    printLine(96);
+    outPuts(YELLOW "Internal = live bytes held beyond what was requested; Ext Frag = free memory outside the\n"
+                    "largest free region, both at the end of the stream.\n" RESET);
+    releaseOutput();
+}
+
+void displayTraceBenchmark(const TraceBenchResult results[], int count)
+{
+    holdOutput();
+    printHeader("ALLOCATION TRACE BENCHMARK");
+    outPrintf(CYAN "| %-13s | %-9s | %-8s | %-12s | %-12s | %-17s | %-10s |\n" RESET, "Engine", "ns/op", "Failed",
+              "Peak Bytes", "Internal", "Ext Frag avg/max", "Metadata");
+    printLine(104);
+    for (int i = 0; i < count; i++)
+    {
+        const TraceBenchResult *r = &results[i];
+        outPrintf("| %-13s | %-9.1f | %-8lld | %-12lld | %-12lld | ", r->name,
+                  r->events ? (double)r->elapsedNs / r->events : 0.0, r->failures, r->peakBytes, r->peakInternal);
+        if (r->meanExternalFrag < 0)
+            outPrintf("%-17s | ", "n/a");
+        else
+            outPrintf("%6.2f%% / %6.2f%% | ", r->meanExternalFrag, r->maxExternalFrag);
+        if (r->peakMetadataBytes < 0)
+            outPrintf("%-10s |\n", "n/a");
+        else
+            outPrintf("%-10lld |\n", r->peakMetadataBytes);
+    }
+    printLine(104);
+    outPrintf(YELLOW "Internal and Metadata are peaks; Ext Frag is sampled every %d events. The system malloc\n"
+                     "has no simulated arena, so it never fails for lack of space.\n" RESET,
+              TRACE_SAMPLE_EVERY);
+    releaseOutput();
+}
+
+// Streams an allocation trace file through every engine and the system malloc
+static void runTraceBenchmark()
+{
+    char path[256];
+    readPath("Trace file (text 'a ID SIZE' / 'f ID', or binary): ", path, sizeof(path));
+    printf("Arena size in MiB for the simulated engines: ");
+    long long arenaSize = (long long)getSafeInt() << 20;
+
+    TraceBenchResult results[BENCH_COUNT];
+    char error[160];
+    printf(YELLOW "Replaying...\n" RESET);
+    int count = benchmarkTrace(path, arenaSize, (1u << ENGINE_COUNT) - 1, true, results, error, sizeof(error));
+    if (count < 0)
+    {
+        printf(RED "Benchmark failed: %s\n" RESET, error);
+        return;
+    }
+    printf(GREEN "Replayed %lld events.\n" RESET, count ? results[0].events : 0);
+    displayTraceBenchmark(results, count);
+}
+
+// Places each process in a free block using the chosen strategy
+// (1 = Best Fit, 2 = First Fit, 3 = Worst Fit); -1 means it did not fit.
+// Free blocks sit in a FitIndex (address = block number), so every
+// placement is O(log blocks) instead of a scan over all of them.
+void allocateMemory(int type, int blocks, int bSize[], int processes, int pSize[], int allocation[])
+{
+    for (int i = 0; i < processes; i++)
+        allocation[i] = -1;
+    if (type < FIT_BEST || type > FIT_WORST)
+        return;
+
+    FitIndex index;
+    initFitIndex(&index);
+    for (int j = 0; j < blocks; j++)
+        fitInsertHole(&index, j, bSize[j]);
+
+    for (int i = 0; i < processes; i++)
+    {
+        int idx = (int)fitFindHole(&index, (FitStrategy)type, pSize[i], NULL);
+        if (idx != -1)
+        {
+            allocation[i] = idx;
+            fitRemoveHole(&index, idx, bSize[idx]);
+        }
+    }
+    freeFitIndex(&index);
+}
+
+// Variable partitions: an allocate/free stream replayed against each engine
+static void runDynamicPartitions()
+{
+    printf("Enter arena size in bytes: ");
+    long long arenaSize = getSafeInt();
+    printf("Enter number of events: ");
+    int count = getSafeInt();
+    if (count < 0)
+        count = 0;
+    HeapEvent *events = safeMalloc(count * sizeof(HeapEvent));
+    printf("Enter events as '1 id size' (allocate) or '2 id' (free):\n");
+    for (int i = 0; i < count; i++)
+    {
+        printf("  Event %d: ", i + 1);
+        events[i].op = getSafeInt();
+        events[i].id = getSafeInt();
+        events[i].size = (events[i].op == HEAP_ALLOC) ? getSafeInt() : 0;
+    }
+
+    HeapSample *samples = safeMalloc(count * sizeof(HeapSample));
+    while (1)
+    {
+        printf("\n" BLUE "Choose Allocator:\n" RESET);
+        printf("1. Best Fit\n2. First Fit\n3. Worst Fit\n4. Buddy System\n5. Slab Allocator\n"
+               "6. Compare All\n7. Compaction Study\n8. Back\nSelection: ");
+        int type = getSafeInt();
+        if (type == 8)
+            break;
+        if (type == 6)
+        {
+            compareAllocators(events, count, arenaSize);
+            continue;
+        }
+        if (type == 7)
+        {
+            compareCompaction(events, count, arenaSize);
+            continue;
+        }
+        if (type < ENGINE_BEST_FIT || type > ENGINE_SLAB)
+            continue;
+
+        Allocator allocator;
+        if (!createAllocator((AllocatorEngine)type, arenaSize, &allocator))
+        {
+            printf(RED "Arena too small for this allocator.\n" RESET);
+            continue;
+        }
+        HeapReplay replay;
+        initHeapReplay(&replay, allocator);
+        for (int i = 0; i < count; i++)
+            applyHeapEvent(&replay, &events[i], &samples[i]);
+        displayHeapAnalysis(samples, count, &allocator, &replay);
+        freeHeapReplay(&replay);
+        destroyAllocator(&allocator);
+    }
+    free(samples);
+    free(events);
 }
 
 void runMemoryAllocation()
 {
     int blocks, processes, type;
-    int bSize[100], pSize[100];
+
+    printf("1. Fixed partitions (place each process once)\n2. Dynamic partitions (allocate/free events)\n"
+           "3. Allocation trace file (benchmark every allocator)\nMode: ");
+    int mode = getSafeInt();
+    if (mode == 2)
+    {
+        runDynamicPartitions();
+        return;
+    }
+    if (mode == 3)
+    {
+        runTraceBenchmark();
+        return;
+    }
 
     printf("Enter number of memory blocks: ");
     blocks = getSafeInt();
+    if (blocks < 0)
+        blocks = 0;
+    int *bSize = safeMalloc(blocks * sizeof(int));
     printf("Enter sizes of blocks (separated by space or enter): ");
     for (int i = 0; i < blocks; i++)
         bSize[i] = getSafeInt();
 
     printf("Enter number of processes: ");
     processes = getSafeInt();
+    if (processes < 0)
+        processes = 0;
+    int *pSize = safeMalloc(processes * sizeof(int));
+    int *allocation = safeMalloc(processes * sizeof(int));
     printf("Enter sizes of processes: ");
     for (int i = 0; i < processes; i++)
         pSize[i] = getSafeInt();
@@ -55,42 +353,15 @@ void runMemoryAllocation()
         if (type == 4)
             break;
 
-        int allocation[processes], occupied[blocks];
-        for (int i = 0; i < processes; i++)
-            allocation[i] = -1;
-        for (int i = 0; i < blocks; i++)
-            occupied[i] = 0;
-
-        for (int i = 0; i < processes; i++)
-        {
-            int idx = -1;
-            for (int j = 0; j < blocks; j++)
-            {
-                if (!occupied[j] && bSize[j] >= pSize[i])
-                {
-                    if (type == 1)
-                    {
-                        if (idx == -1 || bSize[j] < bSize[idx])
-                            idx = j;
-                    }
-                    else if (type == 2)
-                    {
-                        idx = j;
-                        break;
-                    }
-                    else if (type == 3)
-                    {
-                        if (idx == -1 || bSize[j] > bSize[idx])
-                            idx = j;
-                    }
-                }
-            }
-            if (idx != -1)
-            {
-                allocation[i] = idx;
-                occupied[idx] = 1;
-            }
-        }
+        allocateMemory(type, blocks, bSize, processes, pSize, allocation);
         displayMemoryAnalysis(processes, pSize, allocation, bSize);
+        bool anyFailed = false;
+        for (int i = 0; i < processes; i++)
+            anyFailed = anyFailed || allocation[i] == -1;
+        if (anyFailed && type >= FIT_BEST && type <= FIT_WORST)
+            displayCompactionWhatIf(blocks, bSize, processes, pSize, allocation);
     }
+    free(allocation);
+    free(bSize);
+    free(pSize);
 }
\ No newline at end of file
@@ -2,9 +2,20 @@
 #define MEMORY_ALLOCATION_H
 
 #include "utils.h"
+#include "free_index.h"
+#include "allocator.h"
+#include "dynamic_partition.h"
+#include "alloc_trace.h"
+#include "compaction.h"
 
 // --- Function Prototypes ---
 void displayMemoryAnalysis(int processes, int processSize[], int allocation[], int blockSize[]);
+void displayHeapAnalysis(const HeapSample samples[], int count, const Allocator *allocator, const HeapReplay *replay);
+void compareAllocators(const HeapEvent events[], int count, long long arenaSize);
+void displayCompactionWhatIf(int blocks, int bSize[], int processes, int pSize[], int allocation[]);
+void compareCompaction(const HeapEvent events[], int count, long long arenaSize);
+void displayTraceBenchmark(const TraceBenchResult results[], int count);
+void allocateMemory(int type, int blocks, int bSize[], int processes, int pSize[], int allocation[]);
 void runMemoryAllocation();
 
 #endif
\ No newline at end of file
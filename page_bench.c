@@ -0,0 +1,172 @@
+#include "page_bench.h"
+
+// ==========================================
+//      SYNTHETIC PATTERNS
+// ==========================================
+
+#define SCAN_BASE (1LL << 40) // scan pages start here, far from every other pattern's pages
+#define PHASES 8
+#define ZIPF_MAX_PAGES (1 << 24)
+
+const char *pagePatternName(PagePattern pattern)
+{
+    static const char *names[] = {"loop", "scan", "zipf", "phase"};
+    return (pattern >= PATTERN_LOOP && pattern < PATTERN_COUNT) ? names[pattern] : "unknown";
+}
+
+void generatePagePattern(PagePattern pattern, long long count, int frames, uint64_t seed, long long out[])
+{
+    Rng rng;
+    rngSeed(&rng, seed);
+    long long c = (frames > 0) ? frames : 1;
+
+    if (pattern == PATTERN_LOOP)
+    {
+        long long span = (3 * c / 2 > c) ? 3 * c / 2 : c + 1;
+        for (long long i = 0; i < count; i++)
+            out[i] = i % span;
+    }
+    else if (pattern == PATTERN_SCAN)
+    {
+        long long hot = (c / 2 > 0) ? c / 2 : 1, nextScan = SCAN_BASE;
+        long long i = 0;
+        while (i < count)
+        {
+            for (long long k = 0; k < 4 * c && i < count; k++)
+                out[i++] = (long long)(rngNext(&rng) % (uint64_t)hot);
+            for (long long k = 0; k < 2 * c && i < count; k++)
+                out[i++] = nextScan++; // touched once, never again
+        }
+    }
+    else if (pattern == PATTERN_ZIPF)
+    {
+        ZipfSampler z;
+        initZipf(&z, (10 * c < ZIPF_MAX_PAGES) ? (int)(10 * c) : ZIPF_MAX_PAGES, 1.0);
+        for (long long i = 0; i < count; i++)
+            out[i] = sampleZipf(&z, &rng);
+        freeZipf(&z);
+    }
+    else
+    {
+        long long set = (3 * c / 4 > 0) ? 3 * c / 4 : 1;
+        long long phaseLength = (count / PHASES > 0) ? count / PHASES : 1;
+        for (long long i = 0; i < count; i++)
+            out[i] = (i / phaseLength) * set + (long long)(rngNext(&rng) % (uint64_t)set);
+    }
+}
+
+// ==========================================
+//      BENCHMARK
+// ==========================================
+
+PageBenchRow *runPageBenchmark(int frames, long long refs, uint64_t seed, const char *tracePath, long long pageSize,
+                               bool instructions, int *rowCount, char *error, size_t errorSize)
+{
+    if (frames < 1 || refs < 1)
+    {
+        snprintf(error, errorSize, "need at least one frame and one reference");
+        return NULL;
+    }
+    PageBenchRow *rows = safeMalloc((PATTERN_COUNT + 1) * PAGE_POLICY_COUNT * sizeof(PageBenchRow));
+    int count = 0;
+
+    long long *p = safeMalloc((size_t)refs * sizeof(long long));
+    for (int pattern = 0; pattern < PATTERN_COUNT; pattern++)
+    {
+        generatePagePattern((PagePattern)pattern, refs, frames, seed, p);
+        for (int policy = PAGE_FIFO; policy <= PAGE_POLICY_COUNT; policy++)
+        {
+            PageReplacer r;
+            if (!createPageReplacer((PagePolicy)policy, frames, p, refs, &r))
+                continue;
+            long long evicted, start = monotonicNanos();
+            for (long long i = 0; i < refs; i++)
+                pageAccess(&r, p[i], &evicted);
+            PageBenchRow *row = &rows[count++];
+            row->elapsedNs = monotonicNanos() - start;
+            snprintf(row->workload, sizeof(row->workload), "%s", pagePatternName((PagePattern)pattern));
+            row->policy = (PagePolicy)policy;
+            row->refs = refs;
+            row->faults = r.faults;
+            row->metadataBytes = r.ops->metadataBytes(r.self);
+            destroyPageReplacer(&r);
+        }
+    }
+    free(p);
+
+    if (tracePath != NULL)
+    {
+        PageTraceResult results[PAGE_POLICY_COUNT];
+        int n = replayPageTrace(tracePath, pageSize, instructions, frames, ~0u, results, error, errorSize);
+        if (n < 0)
+        {
+            free(rows);
+            return NULL;
+        }
+        for (int i = 0; i < n; i++)
+        {
+            PageBenchRow *row = &rows[count++];
+            snprintf(row->workload, sizeof(row->workload), "trace");
+            row->policy = results[i].policy;
+            row->refs = results[i].refs;
+            row->faults = results[i].faults;
+            row->elapsedNs = results[i].elapsedNs;
+            row->metadataBytes = results[i].metadataBytes;
+        }
+    }
+    *rowCount = count;
+    return rows;
+}
+
+void printPageBenchmark(const PageBenchRow rows[], int count, int frames)
+{
+    printHeader("PAGE REPLACEMENT BENCHMARK");
+    printf(CYAN "| %-8s | %-9s | %-9s | %-9s | %-11s |\n" RESET, "Workload", "Policy", "Hit Ratio", "ns/ref",
+           "Bytes/frame");
+    printLine(62);
+    for (int i = 0; i < count; i++)
+    {
+        const PageBenchRow *r = &rows[i];
+        // Best hit ratio within the workload, Optimal aside, in green
+        bool best = (r->policy != PAGE_OPT);
+        for (int j = 0; j < count && best; j++)
+            if (strcmp(rows[j].workload, r->workload) == 0 && rows[j].policy != PAGE_OPT &&
+                rows[j].faults < r->faults)
+                best = false;
+        printf("| %-8s | %-9s | %s%8.2f%%" RESET " | %-9.1f | %-11.1f |\n", r->workload, pagePolicyName(r->policy),
+               best ? GREEN : "", r->refs ? 100.0 * (r->refs - r->faults) / r->refs : 0.0,
+               r->refs ? (double)r->elapsedNs / r->refs : 0.0, (double)r->metadataBytes / frames);
+        if (i + 1 < count && strcmp(rows[i + 1].workload, r->workload) != 0)
+            printLine(62);
+    }
+    printLine(62);
+}
+
+void runPageBenchmarkMenu(int frames)
+{
+    printf("References per pattern: ");
+    long long refs = getSafeInt();
+    printf("Also replay a trace file? (1=Yes, 0=No): ");
+    char path[256];
+    const char *tracePath = NULL;
+    long long pageSize = DEFAULT_PAGE_SIZE;
+    if (getSafeInt() == 1)
+    {
+        readPath("Trace file: ", path, sizeof(path));
+        printf("Page size in bytes (power of two, e.g. 4096): ");
+        pageSize = getSafeInt();
+        tracePath = path;
+    }
+
+    int count;
+    char error[160];
+    PageBenchRow *rows = runPageBenchmark(frames, refs, 42, tracePath, pageSize, true, &count, error, sizeof(error));
+    if (rows == NULL)
+    {
+        printf(RED "Cannot run the benchmark: %s\n" RESET, error);
+        return;
+    }
+    printPageBenchmark(rows, count, frames);
+    printf("Patterns: loop over 1.5x the frames, hot set with one-off scans, Zipf, and 8 working-set phases.\n");
+    free(rows);
+}
@@ -0,0 +1,51 @@
+#ifndef PAGE_BENCH_H
+#define PAGE_BENCH_H
+
+#include "page_trace.h"
+#include "workload_gen.h"
+
+// --- Structures ---
+/**
+ * Synthetic reference patterns, sized relative to the frame count c:
+ *   loop  - cycles over 1.5c pages, where LRU and FIFO never hit;
+ *   scan  - a hot set of c/2 pages interrupted by one-off scans of 2c new pages;
+ *   zipf  - Zipf(1.0) popularity over 10c pages;
+ *   phase - eight phases, each hammering a new working set of 3c/4 pages.
+ */
+typedef enum
+{
+    PATTERN_LOOP,
+    PATTERN_SCAN,
+    PATTERN_ZIPF,
+    PATTERN_PHASE,
+    PATTERN_COUNT
+} PagePattern;
+
+typedef struct
+{
+    char workload[24];
+    PagePolicy policy;
+    long long refs, faults;
+    long long elapsedNs;
+    size_t metadataBytes;
+} PageBenchRow;
+
+// --- Function Prototypes ---
+const char *pagePatternName(PagePattern pattern);
+void generatePagePattern(PagePattern pattern, long long count, int frames, uint64_t seed, long long out[]);
+
+/**
+ * Replays every pattern (`refs` references each) and, if `tracePath` is
+ * set, that trace through every policy with `frames` frames. The trace is
+ * streamed, so it has no Optimal row. Returns a new array of *rowCount
+ * rows grouped by workload, or NULL with `error` filled.
+ */
+PageBenchRow *runPageBenchmark(int frames, long long refs, uint64_t seed, const char *tracePath, long long pageSize,
+                               bool instructions, int *rowCount, char *error, size_t errorSize);
+
+void printPageBenchmark(const PageBenchRow rows[], int count, int frames);
+
+// Interactive front end: asks for the reference count and an optional trace
+void runPageBenchmarkMenu(int frames);
+
+#endif
@@ -1,62 +1,873 @@
 #include "page_replacement.h"
+#include "adaptive_replacement.h"
+#include "stack_distance.h"
+#include "page_trace.h"
+#include "page_bench.h"
+#include "virtual_memory.h"
 // ==========================================
 //      MODULE 5: PAGE REPLACEMENT
 // ==========================================
 
-void runPageReplacement()
+// ==========================================
+//      PAGE MAP
+// ==========================================
+
+static uint64_t hashPage(long long key)
 {
-    int f_size, p_count, i, j, faults = 0, top = 0;
-    int f[MAX_FRAMES], p[MAX_REQ];
+    uint64_t x = (uint64_t)key;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
 
-    printHeader("VIRTUAL MEMORY: FIFO PAGE REPLACEMENT");
-    printf("Frame Count: ");
-    f_size = getSafeInt();
-    printf("Sequence Size: ");
-    p_count = getSafeInt();
-    printf("Sequence: ");
-    for (i = 0; i < p_count; i++)
-        scanf("%d", &p[i]);
-    clearBuffer();
+static void allocPageBuckets(PageMap *m, long long buckets)
+{
+    m->keys = safeMalloc((size_t)buckets * sizeof(long long));
+    m->values = safeMalloc((size_t)buckets * sizeof(int));
+    for (long long i = 0; i < buckets; i++)
+        m->values[i] = -1;
+    m->mask = buckets - 1;
+}
+
+void initPageMap(PageMap *m, long long expected)
+{
+    long long buckets = 16;
+    while (buckets < 2 * expected)
+        buckets *= 2;
+    allocPageBuckets(m, buckets);
+    m->count = 0;
+}
 
-    for (i = 0; i < f_size; i++)
-        f[i] = -1; // Initialize frames as empty
+void freePageMap(PageMap *m)
+{
+    free(m->keys);
+    free(m->values);
+    m->keys = NULL;
+    m->values = NULL;
+}
+
+static long long pageBucket(const PageMap *m, long long key)
+{
+    long long b = (long long)(hashPage(key) & (uint64_t)m->mask);
+    while (m->values[b] != -1 && m->keys[b] != key)
+        b = (b + 1) & m->mask;
+    return b;
+}
 
-    printf("\nRef | Frame Contents\t\tStatus\n----|-------------------------");
-    for (i = 0; i < p_count; i++)
+int pageMapGet(const PageMap *m, long long key)
+{
+    return m->values[pageBucket(m, key)];
+}
+
+void pageMapPut(PageMap *m, long long key, int value)
+{
+    long long b = pageBucket(m, key);
+    if (m->values[b] == -1)
     {
-        SLEEP_MS(1200); // Delay for student to predict if it's a Hit or Miss
-        bool hit = false;
-        for (j = 0; j < f_size; j++)
-            if (f[j] == p[i])
-                hit = true;
+        if (2 * (m->count + 1) > m->mask + 1)
+        {
+            long long *keys = m->keys;
+            int *values = m->values;
+            long long buckets = m->mask + 1;
+            allocPageBuckets(m, 2 * buckets);
+            for (long long i = 0; i < buckets; i++)
+                if (values[i] != -1)
+                {
+                    long long nb = pageBucket(m, keys[i]);
+                    m->keys[nb] = keys[i];
+                    m->values[nb] = values[i];
+                }
+            free(keys);
+            free(values);
+            b = pageBucket(m, key);
+        }
+        m->count++;
+    }
+    m->keys[b] = key;
+    m->values[b] = value;
+}
 
-        printf("\n %d  | ", p[i]);
-        if (!hit)
+void pageMapErase(PageMap *m, long long key)
+{
+    long long gap = pageBucket(m, key);
+    if (m->values[gap] == -1)
+        return;
+    m->values[gap] = -1;
+    m->count--;
+    // Backward-shift deletion: later entries of the probe run move into the gap
+    for (long long j = (gap + 1) & m->mask; m->values[j] != -1; j = (j + 1) & m->mask)
+    {
+        long long home = (long long)(hashPage(m->keys[j]) & (uint64_t)m->mask);
+        bool movable = (gap <= j) ? (home <= gap || home > j) : (home <= gap && home > j);
+        if (movable)
         {
-            f[top] = p[i];
-            top = (top + 1) % f_size;
-            faults++;
-            for (j = 0; j < f_size; j++)
-            {
-                if (f[j] != -1)
-                    printf("[%d] ", f[j]);
-                else
-                    printf("[ ] ");
-            }
-            printf("\t" RED "MISS (Page Fault)" RESET);
+            m->keys[gap] = m->keys[j];
+            m->values[gap] = m->values[j];
+            m->values[j] = -1;
+            gap = j;
+        }
+    }
+}
+
+// ==========================================
+//      FRAME TABLE (SHARED BY ALL POLICIES)
+// ==========================================
+
+typedef struct
+{
+    int capacity, used;
+    long long *page; // page held by each frame
+    PageMap where;   // page -> frame
+} FrameTable;
+
+static void initFrameTable(FrameTable *t, int frames)
+{
+    t->capacity = frames;
+    t->used = 0;
+    t->page = safeMalloc((size_t)frames * sizeof(long long));
+    initPageMap(&t->where, frames);
+}
+
+static void freeFrameTable(FrameTable *t)
+{
+    free(t->page);
+    freePageMap(&t->where);
+}
+
+// Puts `page` into frame f, reporting the page it replaces (or -1)
+static void loadFrame(FrameTable *t, int f, long long page, long long *evicted)
+{
+    *evicted = -1;
+    if (f < t->used)
+    {
+        *evicted = t->page[f];
+        pageMapErase(&t->where, t->page[f]);
+    }
+    else
+        t->used++;
+    t->page[f] = page;
+    pageMapPut(&t->where, page, f);
+}
+
+static long long tableFramePage(const FrameTable *t, int frame)
+{
+    return (frame < t->used) ? t->page[frame] : -1;
+}
+
+static size_t tableBytes(const FrameTable *t)
+{
+    return (size_t)(t->where.mask + 1) * (sizeof(long long) + sizeof(int));
+}
+
+// ==========================================
+//      FIFO
+// ==========================================
+
+typedef struct
+{
+    FrameTable t;
+    int hand; // oldest frame once all are full
+} FifoState;
+
+static bool fifoAccess(void *self, long long page, long long *evicted)
+{
+    FifoState *s = self;
+    *evicted = -1;
+    if (pageMapGet(&s->t.where, page) != -1)
+        return true;
+    if (s->t.used < s->t.capacity)
+        loadFrame(&s->t, s->t.used, page, evicted);
+    else
+    {
+        loadFrame(&s->t, s->hand, page, evicted);
+        s->hand = (s->hand + 1) % s->t.capacity;
+    }
+    return false;
+}
+
+static long long fifoFramePage(const void *self, int frame)
+{
+    return tableFramePage(&((const FifoState *)self)->t, frame);
+}
+
+static size_t fifoMetadata(const void *self)
+{
+    return tableBytes(&((const FifoState *)self)->t) + sizeof(FifoState);
+}
+
+static void fifoDestroy(void *self)
+{
+    freeFrameTable(&((FifoState *)self)->t);
+    free(self);
+}
+
+static const PageReplacerOps fifoOps = {"FIFO", fifoAccess, fifoFramePage, fifoMetadata, fifoDestroy};
+
+// ==========================================
+//      LRU (HASH + INTRUSIVE LIST)
+// ==========================================
+
+typedef struct
+{
+    FrameTable t;
+    int *prev, *next; // recency list threaded through the frames
+    int head, tail;   // head = most recently used
+} LruState;
+
+static void lruUnlink(LruState *s, int f)
+{
+    if (s->prev[f] != -1)
+        s->next[s->prev[f]] = s->next[f];
+    else
+        s->head = s->next[f];
+    if (s->next[f] != -1)
+        s->prev[s->next[f]] = s->prev[f];
+    else
+        s->tail = s->prev[f];
+}
+
+static void lruPushFront(LruState *s, int f)
+{
+    s->prev[f] = -1;
+    s->next[f] = s->head;
+    if (s->head != -1)
+        s->prev[s->head] = f;
+    s->head = f;
+    if (s->tail == -1)
+        s->tail = f;
+}
+
+static bool lruAccess(void *self, long long page, long long *evicted)
+{
+    LruState *s = self;
+    *evicted = -1;
+    int f = pageMapGet(&s->t.where, page);
+    if (f != -1)
+    {
+        lruUnlink(s, f);
+        lruPushFront(s, f);
+        return true;
+    }
+    if (s->t.used < s->t.capacity)
+        f = s->t.used;
+    else
+    {
+        f = s->tail;
+        lruUnlink(s, f);
+    }
+    loadFrame(&s->t, f, page, evicted);
+    lruPushFront(s, f);
+    return false;
+}
+
+static long long lruFramePage(const void *self, int frame)
+{
+    return tableFramePage(&((const LruState *)self)->t, frame);
+}
+
+static size_t lruMetadata(const void *self)
+{
+    const LruState *s = self;
+    return tableBytes(&s->t) + 2 * (size_t)s->t.capacity * sizeof(int) + sizeof(LruState);
+}
+
+static void lruDestroy(void *self)
+{
+    LruState *s = self;
+    freeFrameTable(&s->t);
+    free(s->prev);
+    free(s->next);
+    free(s);
+}
+
+static const PageReplacerOps lruOps = {"LRU", lruAccess, lruFramePage, lruMetadata, lruDestroy};
+
+// ==========================================
+//      LFU (FREQUENCY BUCKETS)
+// ==========================================
+
+// All frames referenced `freq` times, most recent first
+typedef struct
+{
+    long long freq;
+    int head, tail;
+    int prev, next; // bucket list in increasing frequency
+} FreqBucket;
+
+typedef struct
+{
+    FrameTable t;
+    int *prev, *next; // frame list inside its bucket
+    int *bucketOf;
+    FreqBucket *buckets; // pool: at most one bucket per frame is ever live
+    int *spare;
+    int spareCount;
+    int lowest; // bucket with the smallest frequency, -1 if none
+} LfuState;
+
+static int newBucket(LfuState *s, long long freq, int after)
+{
+    int b = s->spare[--s->spareCount];
+    FreqBucket *bk = &s->buckets[b];
+    bk->freq = freq;
+    bk->head = bk->tail = -1;
+    bk->prev = after;
+    bk->next = (after == -1) ? s->lowest : s->buckets[after].next;
+    if (bk->next != -1)
+        s->buckets[bk->next].prev = b;
+    if (after == -1)
+        s->lowest = b;
+    else
+        s->buckets[after].next = b;
+    return b;
+}
+
+static void dropBucketIfEmpty(LfuState *s, int b)
+{
+    FreqBucket *bk = &s->buckets[b];
+    if (bk->head != -1)
+        return;
+    if (bk->prev != -1)
+        s->buckets[bk->prev].next = bk->next;
+    else
+        s->lowest = bk->next;
+    if (bk->next != -1)
+        s->buckets[bk->next].prev = bk->prev;
+    s->spare[s->spareCount++] = b;
+}
+
+static void lfuUnlink(LfuState *s, int f)
+{
+    FreqBucket *bk = &s->buckets[s->bucketOf[f]];
+    if (s->prev[f] != -1)
+        s->next[s->prev[f]] = s->next[f];
+    else
+        bk->head = s->next[f];
+    if (s->next[f] != -1)
+        s->prev[s->next[f]] = s->prev[f];
+    else
+        bk->tail = s->prev[f];
+}
+
+static void lfuPush(LfuState *s, int f, int b)
+{
+    FreqBucket *bk = &s->buckets[b];
+    s->bucketOf[f] = b;
+    s->prev[f] = -1;
+    s->next[f] = bk->head;
+    if (bk->head != -1)
+        s->prev[bk->head] = f;
+    bk->head = f;
+    if (bk->tail == -1)
+        bk->tail = f;
+}
+
+static bool lfuAccess(void *self, long long page, long long *evicted)
+{
+    LfuState *s = self;
+    *evicted = -1;
+    int f = pageMapGet(&s->t.where, page);
+    if (f != -1)
+    {
+        // Move up one bucket, creating it if the next one is not freq + 1
+        int b = s->bucketOf[f];
+        int up = s->buckets[b].next;
+        if (up == -1 || s->buckets[up].freq != s->buckets[b].freq + 1)
+            up = newBucket(s, s->buckets[b].freq + 1, b);
+        lfuUnlink(s, f);
+        lfuPush(s, f, up);
+        dropBucketIfEmpty(s, b);
+        return true;
+    }
+
+    if (s->t.used < s->t.capacity)
+        f = s->t.used;
+    else
+    {
+        // Least frequently used; among equals, the least recently used
+        int b = s->lowest;
+        f = s->buckets[b].tail;
+        lfuUnlink(s, f);
+        dropBucketIfEmpty(s, b);
+    }
+    loadFrame(&s->t, f, page, evicted);
+    int one = (s->lowest != -1 && s->buckets[s->lowest].freq == 1) ? s->lowest : newBucket(s, 1, -1);
+    lfuPush(s, f, one);
+    return false;
+}
+
+static long long lfuFramePage(const void *self, int frame)
+{
+    return tableFramePage(&((const LfuState *)self)->t, frame);
+}
+
+static size_t lfuMetadata(const void *self)
+{
+    const LfuState *s = self;
+    size_t perFrame = 4 * sizeof(int) + sizeof(FreqBucket);
+    return tableBytes(&s->t) + (size_t)(s->t.capacity + 1) * perFrame + sizeof(LfuState);
+}
+
+static void lfuDestroy(void *self)
+{
+    LfuState *s = self;
+    freeFrameTable(&s->t);
+    free(s->prev);
+    free(s->next);
+    free(s->bucketOf);
+    free(s->buckets);
+    free(s->spare);
+    free(s);
+}
+
+static const PageReplacerOps lfuOps = {"LFU", lfuAccess, lfuFramePage, lfuMetadata, lfuDestroy};
+
+// ==========================================
+//      CLOCK (SECOND CHANCE)
+// ==========================================
+
+typedef struct
+{
+    FrameTable t;
+    unsigned char *referenced;
+    int hand;
+} ClockState;
+
+static bool clockAccess(void *self, long long page, long long *evicted)
+{
+    ClockState *s = self;
+    *evicted = -1;
+    int f = pageMapGet(&s->t.where, page);
+    if (f != -1)
+    {
+        s->referenced[f] = 1;
+        return true;
+    }
+    if (s->t.used < s->t.capacity)
+        f = s->t.used;
+    else
+    {
+        // Sweep: referenced frames lose their bit and get a second chance
+        while (s->referenced[s->hand])
+        {
+            s->referenced[s->hand] = 0;
+            s->hand = (s->hand + 1) % s->t.capacity;
         }
+        f = s->hand;
+        s->hand = (s->hand + 1) % s->t.capacity;
+    }
+    loadFrame(&s->t, f, page, evicted);
+    s->referenced[f] = 1;
+    return false;
+}
+
+static long long clockFramePage(const void *self, int frame)
+{
+    return tableFramePage(&((const ClockState *)self)->t, frame);
+}
+
+static size_t clockMetadata(const void *self)
+{
+    const ClockState *s = self;
+    return tableBytes(&s->t) + (size_t)s->t.capacity + sizeof(ClockState);
+}
+
+static void clockDestroy(void *self)
+{
+    ClockState *s = self;
+    freeFrameTable(&s->t);
+    free(s->referenced);
+    free(s);
+}
+
+static const PageReplacerOps clockOps = {"Clock", clockAccess, clockFramePage, clockMetadata, clockDestroy};
+
+// ==========================================
+//      OPTIMAL (BELADY)
+// ==========================================
+
+/**
+ * Each frame is keyed by the position of its page's next reference (known
+ * in advance); an indexed max-heap yields the frame used furthest in the
+ * future in O(log frames).
+ */
+typedef struct
+{
+    FrameTable t;
+    long long *nextUse; // per reference: position of the next reference to the same page
+    long long count, cursor;
+    long long *key; // per frame
+    int *heap, *pos;
+} OptState;
+
+static void optSwap(OptState *s, int i, int j)
+{
+    int a = s->heap[i], b = s->heap[j];
+    s->heap[i] = b;
+    s->heap[j] = a;
+    s->pos[b] = i;
+    s->pos[a] = j;
+}
+
+static void optSiftUp(OptState *s, int i)
+{
+    while (i > 0 && s->key[s->heap[(i - 1) / 2]] < s->key[s->heap[i]])
+    {
+        optSwap(s, i, (i - 1) / 2);
+        i = (i - 1) / 2;
+    }
+}
+
+static void optSiftDown(OptState *s, int i)
+{
+    int n = s->t.used;
+    while (1)
+    {
+        int big = i, l = 2 * i + 1, r = 2 * i + 2;
+        if (l < n && s->key[s->heap[l]] > s->key[s->heap[big]])
+            big = l;
+        if (r < n && s->key[s->heap[r]] > s->key[s->heap[big]])
+            big = r;
+        if (big == i)
+            return;
+        optSwap(s, i, big);
+        i = big;
+    }
+}
+
+static bool optAccess(void *self, long long page, long long *evicted)
+{
+    OptState *s = self;
+    *evicted = -1;
+    // Past the known string nothing is known about the future: treat it as never used again
+    long long next = (s->cursor < s->count) ? s->nextUse[s->cursor] : LLONG_MAX;
+    s->cursor++;
+
+    int f = pageMapGet(&s->t.where, page);
+    if (f != -1)
+    {
+        long long old = s->key[f];
+        s->key[f] = next;
+        if (next > old)
+            optSiftUp(s, s->pos[f]);
         else
+            optSiftDown(s, s->pos[f]);
+        return true;
+    }
+    if (s->t.used < s->t.capacity)
+    {
+        f = s->t.used;
+        loadFrame(&s->t, f, page, evicted);
+        s->key[f] = next;
+        s->heap[f] = f;
+        s->pos[f] = f;
+        optSiftUp(s, f);
+        return false;
+    }
+    f = s->heap[0]; // used furthest in the future
+    loadFrame(&s->t, f, page, evicted);
+    s->key[f] = next;
+    optSiftDown(s, 0);
+    return false;
+}
+
+static long long optFramePage(const void *self, int frame)
+{
+    return tableFramePage(&((const OptState *)self)->t, frame);
+}
+
+static size_t optMetadata(const void *self)
+{
+    const OptState *s = self;
+    return tableBytes(&s->t) + (size_t)s->count * sizeof(long long) +
+           (size_t)s->t.capacity * (sizeof(long long) + 2 * sizeof(int)) + sizeof(OptState);
+}
+
+static void optDestroy(void *self)
+{
+    OptState *s = self;
+    freeFrameTable(&s->t);
+    free(s->nextUse);
+    free(s->key);
+    free(s->heap);
+    free(s->pos);
+    free(s);
+}
+
+static const PageReplacerOps optOps = {"OPT", optAccess, optFramePage, optMetadata, optDestroy};
+
+// ==========================================
+//      REPLACER FRONT END
+// ==========================================
+
+const char *pagePolicyName(PagePolicy policy)
+{
+    static const char *names[] = {"FIFO", "LRU", "LFU", "Clock", "OPT", "ARC", "2Q", "CLOCK-Pro"};
+    return (policy >= PAGE_FIFO && policy <= PAGE_POLICY_COUNT) ? names[policy - 1] : "Unknown";
+}
+
+bool createPageReplacer(PagePolicy policy, int frames, const long long refs[], long long count, PageReplacer *out)
+{
+    if (frames < 1 || (policy == PAGE_OPT && refs == NULL && count > 0))
+        return false;
+    out->frames = frames;
+    out->hits = out->faults = 0;
+
+    if (policy == PAGE_FIFO)
+    {
+        FifoState *s = safeMalloc(sizeof(FifoState));
+        initFrameTable(&s->t, frames);
+        s->hand = 0;
+        out->ops = &fifoOps;
+        out->self = s;
+    }
+    else if (policy == PAGE_LRU)
+    {
+        LruState *s = safeMalloc(sizeof(LruState));
+        initFrameTable(&s->t, frames);
+        s->prev = safeMalloc((size_t)frames * sizeof(int));
+        s->next = safeMalloc((size_t)frames * sizeof(int));
+        s->head = s->tail = -1;
+        out->ops = &lruOps;
+        out->self = s;
+    }
+    else if (policy == PAGE_LFU)
+    {
+        LfuState *s = safeMalloc(sizeof(LfuState));
+        initFrameTable(&s->t, frames);
+        s->prev = safeMalloc((size_t)frames * sizeof(int));
+        s->next = safeMalloc((size_t)frames * sizeof(int));
+        s->bucketOf = safeMalloc((size_t)frames * sizeof(int));
+        // One bucket per frame, plus one for a fresh page while its old bucket is still live
+        s->buckets = safeMalloc(((size_t)frames + 1) * sizeof(FreqBucket));
+        s->spare = safeMalloc(((size_t)frames + 1) * sizeof(int));
+        s->spareCount = frames + 1;
+        for (int i = 0; i <= frames; i++)
+            s->spare[i] = frames - i;
+        s->lowest = -1;
+        out->ops = &lfuOps;
+        out->self = s;
+    }
+    else if (policy == PAGE_CLOCK)
+    {
+        ClockState *s = safeMalloc(sizeof(ClockState));
+        initFrameTable(&s->t, frames);
+        s->referenced = calloc((size_t)frames, 1);
+        if (s->referenced == NULL)
+        {
+            printf(RED "\nFatal: out of memory for clock bits\n" RESET);
+            exit(EXIT_FAILURE);
+        }
+        s->hand = 0;
+        out->ops = &clockOps;
+        out->self = s;
+    }
+    else if (policy == PAGE_OPT)
+    {
+        OptState *s = safeMalloc(sizeof(OptState));
+        initFrameTable(&s->t, frames);
+        s->count = count;
+        s->cursor = 0;
+        s->nextUse = safeMalloc((size_t)(count > 0 ? count : 1) * sizeof(long long));
+        // One backward pass: the map holds each page's nearest later reference
+        PageMap seen;
+        long long *positions = safeMalloc((size_t)(count > 0 ? count : 1) * sizeof(long long));
+        initPageMap(&seen, 1024);
+        int distinct = 0;
+        for (long long i = count - 1; i >= 0; i--)
         {
-            for (j = 0; j < f_size; j++)
+            int slot = pageMapGet(&seen, refs[i]);
+            if (slot == -1)
             {
-                if (f[j] != -1)
-                    printf("[%d] ", f[j]);
-                else
-                    printf("[ ] ");
+                slot = distinct++;
+                pageMapPut(&seen, refs[i], slot);
+                s->nextUse[i] = LLONG_MAX;
             }
-            printf("\t" GREEN "HIT (Found in RAM)" RESET);
+            else
+                s->nextUse[i] = positions[slot];
+            positions[slot] = i;
         }
+        free(positions);
+        freePageMap(&seen);
+        s->key = safeMalloc((size_t)frames * sizeof(long long));
+        s->heap = safeMalloc((size_t)frames * sizeof(int));
+        s->pos = safeMalloc((size_t)frames * sizeof(int));
+        out->ops = &optOps;
+        out->self = s;
+    }
+    else if (policy == PAGE_ARC)
+    {
+        out->ops = &arcOps;
+        out->self = newArcState(frames);
+    }
+    else if (policy == PAGE_2Q)
+    {
+        out->ops = &twoQueueOps;
+        out->self = newTwoQueueState(frames);
+    }
+    else if (policy == PAGE_CLOCK_PRO)
+    {
+        out->ops = &clockProOps;
+        out->self = newClockProState(frames);
+    }
+    else
+        return false;
+    return true;
+}
+
+void destroyPageReplacer(PageReplacer *r)
+{
+    if (r->self != NULL)
+        r->ops->destroy(r->self);
+    r->self = NULL;
+}
+
+bool pageAccess(PageReplacer *r, long long page, long long *evicted)
+{
+    bool hit = r->ops->access(r->self, page, evicted);
+    if (hit)
+        r->hits++;
+    else
+        r->faults++;
+    return hit;
+}
+
+// Counts FIFO page faults for a reference string without any visualization
+int countFIFOFaults(int f_size, int p_count, const int p[])
+{
+    PageReplacer r;
+    if (!createPageReplacer(PAGE_FIFO, f_size, NULL, 0, &r))
+        return p_count;
+    long long evicted;
+    for (int i = 0; i < p_count; i++)
+        pageAccess(&r, p[i], &evicted);
+    destroyPageReplacer(&r);
+    return (int)r.faults;
+}
+
+// ==========================================
+//      INTERACTIVE MODULE
+// ==========================================
+
+// Replays the string once; with `show`, prints the frames after every reference
+static void simulatePolicy(PagePolicy policy, int f_size, int p_count, const long long p[], bool show)
+{
+    PageReplacer r;
+    if (!createPageReplacer(policy, f_size, p, p_count, &r))
+    {
+        printf(RED "Frame count must be at least 1.\n" RESET);
+        return;
+    }
+
+    if (show)
+        printf("\nRef | Frame Contents\t\tStatus\n----|-------------------------");
+    for (int i = 0; i < p_count; i++)
+    {
+        long long evicted;
+        if (show)
+            SLEEP_MS(1200); // Delay for student to predict if it's a Hit or Miss
+        bool hit = pageAccess(&r, p[i], &evicted);
+        if (!show)
+            continue;
+
+        printf("\n %lld  | ", p[i]);
+        for (int j = 0; j < f_size; j++)
+        {
+            long long page = r.ops->framePage(r.self, j);
+            if (page != -1)
+                printf("[%lld] ", page);
+            else
+                printf("[ ] ");
+        }
+        if (hit)
+            printf("\t" GREEN "HIT (Found in RAM)" RESET);
+        else
+            printf("\t" RED "MISS (Page Fault)" RESET);
         fflush(stdout);
     }
-    waitForStudent();
-}
\ No newline at end of file
+    printf(YELLOW "\n\n%s: %lld faults, %lld hits (hit ratio %.2f%%)\n" RESET, pagePolicyName(policy), r.faults,
+           r.hits, p_count ? 100.0 * r.hits / p_count : 0.0);
+    destroyPageReplacer(&r);
+}
+
+static void comparePolicies(int f_size, int p_count, const long long p[])
+{
+    printHeader("PAGE REPLACEMENT COMPARISON");
+    printf(CYAN "| %-9s | %-10s | %-10s | %-9s | %-9s | %-13s |\n" RESET, "Policy", "Faults", "Hits", "Hit Ratio",
+           "ns/ref", "Bytes/frame");
+    printLine(77);
+    for (int policy = PAGE_FIFO; policy <= PAGE_POLICY_COUNT; policy++)
+    {
+        PageReplacer r;
+        if (!createPageReplacer((PagePolicy)policy, f_size, p, p_count, &r))
+            continue;
+        long long evicted, start = monotonicNanos();
+        for (int i = 0; i < p_count; i++)
+            pageAccess(&r, p[i], &evicted);
+        long long elapsed = monotonicNanos() - start;
+        printf("| %-9s | %-10lld | %-10lld | %8.2f%% | %-9.1f | %-13.1f |\n", pagePolicyName((PagePolicy)policy),
+               r.faults, r.hits, p_count ? 100.0 * r.hits / p_count : 0.0,
+               p_count ? (double)elapsed / p_count : 0.0, (double)r.ops->metadataBytes(r.self) / f_size);
+        destroyPageReplacer(&r);
+    }
+    printLine(77);
+}
+
+void runPageReplacement()
+{
+    int f_size, p_count;
+
+    printHeader("VIRTUAL MEMORY: PAGE REPLACEMENT");
+    printf("Input (1. Type a reference string  2. Replay a trace file  3. Translate addresses): ");
+    int input = getSafeInt();
+    if (input == 2)
+    {
+        runPageTraceReplay();
+        return;
+    }
+    if (input == 3)
+    {
+        runVirtualMemory();
+        return;
+    }
+    printf("Frame Count: ");
+    f_size = getSafeInt();
+    printf("Sequence Size: ");
+    p_count = getSafeInt();
+    if (p_count < 0)
+        p_count = 0;
+    long long *p = safeMalloc((p_count > 0 ? p_count : 1) * sizeof(long long));
+    printf("Sequence: ");
+    for (int i = 0; i < p_count; i++)
+        p[i] = getSafeInt();
+    if (f_size < 1)
+    {
+        printf(RED "Frame count must be at least 1.\n" RESET);
+        free(p);
+        waitForStudent();
+        return;
+    }
+
+    // Frame-by-frame animation only while it stays readable
+    bool show = (f_size <= MAX_FRAMES && p_count <= MAX_REQ);
+    while (1)
+    {
+        printf("\n" BLUE "Choose Policy:\n" RESET);
+        printf("1. FIFO\n2. LRU\n3. LFU\n4. Clock (second chance)\n5. Optimal (Belady)\n6. ARC\n7. 2Q\n"
+               "8. CLOCK-Pro\n9. Compare All\n10. Fault Curves (1..%d frames)\n11. Benchmark Suite\n12. Back\n"
+               "Selection: ",
+               f_size);
+        int choice = getSafeInt();
+        if (choice == 12)
+            break;
+        if (choice == 11)
+            runPageBenchmarkMenu(f_size);
+        else if (choice == 10)
+            showFaultCurves(p, p_count, f_size);
+        else if (choice == 9)
+            comparePolicies(f_size, p_count, p);
+        else if (choice >= PAGE_FIFO && choice <= PAGE_POLICY_COUNT)
+            simulatePolicy((PagePolicy)choice, f_size, p_count, p, show);
+    }
+    free(p);
+}
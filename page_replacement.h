@@ -3,11 +3,83 @@
 
 #include "utils.h"
 
-// --- Function Prototypes ---
+// --- Structures ---
 /**
- * Simulates the First-In-First-Out (FIFO) Page Replacement algorithm.
+ * Open-addressing hash (linear probing, backward-shift deletion) from page
+ * numbers to small integers, usually the frame holding the page. Keeps hit
+ * detection O(1) however many frames there are.
+ */
+typedef struct
+{
+    long long *keys;
+    int *values; // -1 marks an empty bucket
+    long long mask;
+    long long count;
+} PageMap;
+
+typedef enum
+{
+    PAGE_FIFO = 1,
+    PAGE_LRU = 2,
+    PAGE_LFU = 3,
+    PAGE_CLOCK = 4,
+    PAGE_OPT = 5,
+    PAGE_ARC = 6,
+    PAGE_2Q = 7,
+    PAGE_CLOCK_PRO = 8
+} PagePolicy;
+
+#define PAGE_POLICY_COUNT 8
+
+/**
+ * What every replacement policy provides. `access` references one page and
+ * returns true on a hit; on a fault that evicts, *evicted receives the
+ * victim (otherwise -1).
+ */
+typedef struct
+{
+    const char *name;
+    bool (*access)(void *self, long long page, long long *evicted);
+    long long (*framePage)(const void *self, int frame); // page in a frame, -1 if empty
+    size_t (*metadataBytes)(const void *self);           // bookkeeping beyond the frames themselves
+    void (*destroy)(void *self);
+} PageReplacerOps;
+
+typedef struct
+{
+    const PageReplacerOps *ops;
+    void *self;
+    int frames;
+    long long hits, faults;
+} PageReplacer;
+
+// --- Page Map ---
+void initPageMap(PageMap *m, long long expected);
+void freePageMap(PageMap *m);
+int pageMapGet(const PageMap *m, long long key); // -1 if absent
+void pageMapPut(PageMap *m, long long key, int value);
+void pageMapErase(PageMap *m, long long key);
+
+// --- Replacers ---
+/**
+ * Builds a policy over `frames` frames (any number up to INT_MAX). Optimal
+ * needs the whole reference string up front and must then be fed exactly
+ * that string in order; the other policies ignore `refs`.
+ */
+bool createPageReplacer(PagePolicy policy, int frames, const long long refs[], long long count, PageReplacer *out);
+void destroyPageReplacer(PageReplacer *r);
+bool pageAccess(PageReplacer *r, long long page, long long *evicted); // counts hits and faults
+const char *pagePolicyName(PagePolicy policy);
+
+/**
+ * Returns the number of FIFO page faults for p[0..p_count-1] with f_size frames.
+ */
+int countFIFOFaults(int f_size, int p_count, const int p[]);
+
+/**
+ * Simulates page replacement with a chosen policy.
  * Visualizes the RAM frames as pages are loaded and swapped.
  */
 void runPageReplacement();
 
-#endif
\ No newline at end of file
+#endif
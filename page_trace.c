@@ -0,0 +1,436 @@
+#include "page_trace.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+// ==========================================
+//      ON-DISK FORMAT
+// ==========================================
+
+#define PAGE_TRACE_MAGIC "OSPT"
+#define PAGE_TRACE_VERSION 1u
+
+// Binary layout: header followed by one uint64_t address per reference (count 0 = not recorded)
+typedef struct
+{
+    char magic[4];
+    uint32_t version;
+    uint64_t count;
+} PageTraceHeader;
+
+// ==========================================
+//      READER
+// ==========================================
+
+static void refill(PageTrace *t)
+{
+    memmove(t->buf, t->buf + t->pos, t->len - t->pos);
+    t->len -= t->pos;
+    t->pos = 0;
+    size_t got = fread(t->buf + t->len, 1, PAGE_TRACE_BUFFER - t->len, t->fp);
+    if (got == 0)
+        t->eof = true;
+    t->len += got;
+}
+
+static void pageTraceError(PageTrace *t, const char *what)
+{
+    if (t->format == PAGE_TRACE_TEXT)
+        snprintf(t->error, sizeof(t->error), "line %lld: %s", t->line, what);
+    else
+        snprintf(t->error, sizeof(t->error), "record %lld: %s", t->refs + 1, what);
+}
+
+#ifndef _WIN32
+// Maps a binary trace file in whole; false leaves the buffered reader in charge
+static bool mapBinary(PageTrace *t)
+{
+    struct stat st;
+    int fd = fileno(t->fp);
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+        return false;
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED)
+        return false;
+    madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+    fclose(t->fp);
+    t->fp = NULL;
+
+    t->mapped = map;
+    t->mappedBytes = (size_t)st.st_size;
+    t->next = 0;
+    uint64_t records = (t->mappedBytes - sizeof(PageTraceHeader)) / sizeof(uint64_t);
+    if ((t->mappedBytes - sizeof(PageTraceHeader)) % sizeof(uint64_t) != 0)
+    {
+        snprintf(t->error, sizeof(t->error), "record %llu: truncated record", (unsigned long long)records + 1);
+        t->expected = (long long)records;
+    }
+    else if (t->expected != 0 && (uint64_t)t->expected != records)
+    {
+        snprintf(t->error, sizeof(t->error), "file holds %llu records, the header promises %lld",
+                 (unsigned long long)records, t->expected);
+        t->expected = (long long)records; // never read past the mapping
+    }
+    else
+        t->expected = (long long)records;
+    return true;
+}
+#endif
+
+bool openPageTrace(PageTrace *t, const char *path, long long pageSize, bool instructions)
+{
+    bool useStdin = (path == NULL || strcmp(path, "-") == 0);
+    t->fp = useStdin ? stdin : fopen(path, "rb");
+    if (t->fp == NULL)
+        return false;
+    t->buf = safeMalloc(PAGE_TRACE_BUFFER + 1); // + 1 for the terminator of a final unterminated line
+    t->len = t->pos = 0;
+    t->eof = false;
+    t->mapped = NULL;
+    t->mappedBytes = 0;
+    t->next = t->expected = 0;
+    t->instructions = instructions;
+    t->line = t->refs = 0;
+    t->error[0] = '\0';
+    t->format = PAGE_TRACE_TEXT;
+
+    t->pageShift = 0;
+    while (t->pageShift < 62 && (1LL << t->pageShift) < pageSize)
+        t->pageShift++;
+    if (pageSize < 1 || (1LL << t->pageShift) != pageSize)
+    {
+        snprintf(t->error, sizeof(t->error), "page size %lld is not a power of two", pageSize);
+        return true;
+    }
+
+    while (!t->eof && t->len < sizeof(PageTraceHeader))
+        refill(t);
+    if (t->len < 4 || memcmp(t->buf, PAGE_TRACE_MAGIC, 4) != 0)
+        return true;
+
+    t->format = PAGE_TRACE_BINARY;
+    PageTraceHeader header;
+    if (t->len < sizeof(header))
+    {
+        pageTraceError(t, "truncated header");
+        return true;
+    }
+    memcpy(&header, t->buf, sizeof(header));
+    t->pos = sizeof(header);
+    t->expected = (long long)header.count;
+    if (header.version != PAGE_TRACE_VERSION)
+        pageTraceError(t, "unsupported binary trace version");
+#ifndef _WIN32
+    else if (!useStdin)
+        mapBinary(t);
+#endif
+    return true;
+}
+
+void closePageTrace(PageTrace *t)
+{
+#ifndef _WIN32
+    if (t->mapped != NULL)
+        munmap((void *)t->mapped, t->mappedBytes);
+#endif
+    if (t->fp != NULL && t->fp != stdin)
+        fclose(t->fp);
+    free(t->buf);
+    t->fp = NULL;
+    t->buf = NULL;
+    t->mapped = NULL;
+}
+
+// Next line, NUL-terminated in place; NULL at the end of input
+static char *nextLine(PageTrace *t)
+{
+    while (1)
+    {
+        char *start = t->buf + t->pos;
+        char *newline = memchr(start, '\n', t->len - t->pos);
+        if (newline != NULL)
+        {
+            *newline = '\0';
+            t->pos = (size_t)(newline - t->buf) + 1;
+            t->line++;
+            return start;
+        }
+        if (t->eof)
+        {
+            if (t->pos == t->len)
+                return NULL;
+            t->buf[t->len] = '\0';
+            t->pos = t->len;
+            t->line++;
+            return start;
+        }
+        if (t->pos == 0 && t->len == PAGE_TRACE_BUFFER)
+        {
+            t->line++;
+            pageTraceError(t, "line too long");
+            return NULL;
+        }
+        refill(t);
+    }
+}
+
+static int hexDigit(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+// 1 = reference, 0 = line to skip, -1 = malformed
+static int parseLine(const char *p, bool instructions, uint64_t *address)
+{
+    while (*p == ' ' || *p == '\t')
+        p++;
+    if (*p == '\0' || *p == '\r' || *p == '#' || *p == '=')
+        return 0;
+
+    // Lackey: "I", "L", "S" or "M", then the address and ",size"
+    if ((*p == 'I' || *p == 'L' || *p == 'S' || *p == 'M') && (p[1] == ' ' || p[1] == '\t'))
+    {
+        bool fetch = (*p == 'I');
+        p++;
+        while (*p == ' ' || *p == '\t')
+            p++;
+        if (fetch && !instructions)
+            return 0;
+    }
+    if (p[0] == '0' && (p[1] == 'x' || p[1] == 'X'))
+        p += 2;
+
+    uint64_t value = 0;
+    int digits = 0;
+    for (int d = hexDigit(*p); d != -1; d = hexDigit(*++p))
+    {
+        if (++digits > 16)
+            return -1;
+        value = (value << 4) | (uint64_t)d;
+    }
+    if (digits == 0 || (*p != '\0' && *p != ',' && *p != ' ' && *p != '\t' && *p != '\r' && *p != '#'))
+        return -1;
+    *address = value;
+    return 1;
+}
+
+// Next address in the stream; false at the end or on error
+static bool nextAddress(PageTrace *t, uint64_t *address)
+{
+    if (t->error[0] != '\0')
+        return false;
+    if (t->format == PAGE_TRACE_TEXT)
+    {
+        char *line;
+        while ((line = nextLine(t)) != NULL)
+        {
+            int status = parseLine(line, t->instructions, address);
+            if (status == 1)
+                return true;
+            if (status == -1)
+            {
+                pageTraceError(t, "expected a hex address or a lackey record");
+                return false;
+            }
+        }
+        return false;
+    }
+
+    while (!t->eof && t->len - t->pos < sizeof(uint64_t))
+        refill(t);
+    if (t->len - t->pos < sizeof(uint64_t))
+    {
+        if (t->len != t->pos)
+            pageTraceError(t, "truncated record");
+        else if (t->expected != 0 && t->refs != t->expected)
+            pageTraceError(t, "fewer records than the header promises");
+        return false;
+    }
+    memcpy(address, t->buf + t->pos, sizeof(uint64_t));
+    t->pos += sizeof(uint64_t);
+    return true;
+}
+
+int readPageTrace(PageTrace *t, long long pages[], int max)
+{
+    int n = 0;
+    if (t->mapped != NULL)
+    {
+        if (t->error[0] != '\0')
+            return 0;
+        const uint64_t *addresses = (const uint64_t *)((const char *)t->mapped + sizeof(PageTraceHeader));
+        for (; n < max && t->next < t->expected; n++)
+            pages[n] = (long long)(addresses[t->next++] >> t->pageShift);
+        t->refs += n;
+        return n;
+    }
+    uint64_t address;
+    for (; n < max && nextAddress(t, &address); n++)
+    {
+        pages[n] = (long long)(address >> t->pageShift);
+        t->refs++;
+    }
+    return n;
+}
+
+bool convertPageTrace(const char *inPath, const char *outPath, bool instructions, long long *refs, char *error,
+                      size_t errorSize)
+{
+    PageTrace t;
+    if (!openPageTrace(&t, inPath, 1, instructions))
+    {
+        snprintf(error, errorSize, "cannot open %s", inPath ? inPath : "stdin");
+        return false;
+    }
+    FILE *fp = fopen(outPath, "wb");
+    if (fp == NULL)
+    {
+        closePageTrace(&t);
+        snprintf(error, errorSize, "cannot create %s", outPath);
+        return false;
+    }
+
+    PageTraceHeader header;
+    memcpy(header.magic, PAGE_TRACE_MAGIC, 4);
+    header.version = PAGE_TRACE_VERSION;
+    header.count = 0;
+    bool ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+
+    // With a page size of 1 the reader hands back the addresses themselves
+    long long *chunk = safeMalloc(PAGE_TRACE_CHUNK * sizeof(long long));
+    int n;
+    while (ok && (n = readPageTrace(&t, chunk, PAGE_TRACE_CHUNK)) > 0)
+        ok = fwrite(chunk, sizeof(long long), (size_t)n, fp) == (size_t)n;
+    free(chunk);
+
+    // Now that the count is known, patch it into the header
+    header.count = (uint64_t)t.refs;
+    ok = ok && fseek(fp, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, fp) == 1;
+    if (fclose(fp) != 0)
+        ok = false;
+
+    *refs = t.refs;
+    if (t.error[0] != '\0')
+        snprintf(error, errorSize, "%s", t.error);
+    else if (!ok)
+        snprintf(error, errorSize, "cannot write %s", outPath);
+    bool success = ok && t.error[0] == '\0';
+    closePageTrace(&t);
+    return success;
+}
+
+// ==========================================
+//      STREAMING REPLAY
+// ==========================================
+
+int replayPageTrace(const char *path, long long pageSize, bool instructions, int frames, unsigned policyMask,
+                    PageTraceResult results[], char *error, size_t errorSize)
+{
+    PageTrace t;
+    if (!openPageTrace(&t, path, pageSize, instructions))
+    {
+        snprintf(error, errorSize, "cannot open %s", path ? path : "stdin");
+        return -1;
+    }
+
+    PageReplacer replacers[PAGE_POLICY_COUNT];
+    int count = 0;
+    for (int policy = PAGE_FIFO; policy <= PAGE_POLICY_COUNT; policy++)
+    {
+        if (policy == PAGE_OPT || !(policyMask & (1u << (policy - 1))))
+            continue;
+        if (!createPageReplacer((PagePolicy)policy, frames, NULL, 0, &replacers[count]))
+        {
+            snprintf(error, errorSize, "frame count must be at least 1");
+            for (int i = 0; i < count; i++)
+                destroyPageReplacer(&replacers[i]);
+            closePageTrace(&t);
+            return -1;
+        }
+        results[count].policy = (PagePolicy)policy;
+        results[count].elapsedNs = 0;
+        count++;
+    }
+
+    long long *chunk = safeMalloc(PAGE_TRACE_CHUNK * sizeof(long long));
+    int n;
+    while ((n = readPageTrace(&t, chunk, PAGE_TRACE_CHUNK)) > 0)
+        for (int i = 0; i < count; i++)
+        {
+            long long evicted, start = monotonicNanos();
+            for (int k = 0; k < n; k++)
+                pageAccess(&replacers[i], chunk[k], &evicted);
+            results[i].elapsedNs += monotonicNanos() - start;
+        }
+    free(chunk);
+
+    for (int i = 0; i < count; i++)
+    {
+        results[i].refs = t.refs;
+        results[i].faults = replacers[i].faults;
+        results[i].metadataBytes = replacers[i].ops->metadataBytes(replacers[i].self);
+        destroyPageReplacer(&replacers[i]);
+    }
+    if (t.error[0] != '\0')
+    {
+        snprintf(error, errorSize, "%s", t.error);
+        count = -1;
+    }
+    closePageTrace(&t);
+    return count;
+}
+
+// ==========================================
+//      INTERACTIVE FRONT END
+// ==========================================
+
+void runPageTraceReplay()
+{
+    char path[256];
+    printHeader("PAGE TRACE REPLAY");
+    readPath("Trace file (lackey/addresses text, or binary): ", path, sizeof(path));
+    printf("Page size in bytes (power of two, e.g. 4096): ");
+    long long pageSize = getSafeInt();
+    printf("Frame count: ");
+    int frames = getSafeInt();
+    printf("Include instruction fetches? (1=Yes, 0=No): ");
+    bool instructions = getSafeInt() != 0;
+
+    PageTraceResult results[PAGE_POLICY_COUNT];
+    char error[160];
+    long long start = monotonicNanos();
+    int count = replayPageTrace(path, pageSize, instructions, frames, ~0u, results, error, sizeof(error));
+    long long elapsed = monotonicNanos() - start;
+    if (count < 0)
+    {
+        printf(RED "Cannot replay: %s\n" RESET, error);
+        waitForStudent();
+        return;
+    }
+
+    printHeader("PAGE TRACE RESULTS");
+    printf(CYAN "| %-9s | %-14s | %-9s | %-9s | %-13s |\n" RESET, "Policy", "Faults", "Hit Ratio", "ns/ref",
+           "Bytes/frame");
+    printLine(69);
+    for (int i = 0; i < count; i++)
+    {
+        const PageTraceResult *r = &results[i];
+        printf("| %-9s | %-14lld | %8.2f%% | %-9.1f | %-13.1f |\n", pagePolicyName(r->policy), r->faults,
+               r->refs ? 100.0 * (r->refs - r->faults) / r->refs : 0.0,
+               r->refs ? (double)r->elapsedNs / r->refs : 0.0, (double)r->metadataBytes / frames);
+    }
+    printLine(69);
+    printf(YELLOW "%lld references of %lld-byte pages, %d frames, %.2f s in total.\n" RESET,
+           count ? results[0].refs : 0, pageSize, frames, elapsed / 1e9);
+    printf("Optimal needs the whole future, so it is not replayed from a stream.\n");
+    waitForStudent();
+}
@@ -0,0 +1,86 @@
+#ifndef PAGE_TRACE_H
+#define PAGE_TRACE_H
+
+#include "page_replacement.h"
+
+// --- Constants ---
+#define PAGE_TRACE_CHUNK 65536      // page numbers decoded per read
+#define PAGE_TRACE_BUFFER (1 << 20) // bytes of text input held at a time
+#define DEFAULT_PAGE_SIZE 4096
+
+// --- Structures ---
+typedef enum
+{
+    PAGE_TRACE_TEXT,
+    PAGE_TRACE_BINARY
+} PageTraceFormat;
+
+/**
+ * Streaming reader for memory reference traces. Two formats:
+ *   text   - valgrind lackey output ("I  0400d7d4,8", " L 7ff0003a8,8",
+ *            " S ...", " M ...") or one bare address per line; addresses
+ *            are hexadecimal with or without 0x, and lines starting with
+ *            '#' or '=' (valgrind's banner) are skipped;
+ *   binary - "OSPT" header then one 64-bit address per reference (see
+ *            page_trace.c). A binary file is memory-mapped where the
+ *            platform allows; text and stdin go through one read buffer.
+ * Addresses come out as page numbers for the page size given at open.
+ */
+typedef struct
+{
+    FILE *fp;
+    PageTraceFormat format;
+    char *buf;
+    size_t len, pos;
+    bool eof;
+    const uint64_t *mapped; // binary file mapped in whole, or NULL when streaming
+    size_t mappedBytes;
+    long long next;         // mapped: index of the next address
+    long long expected;     // binary: address count from the header
+    int pageShift;
+    bool instructions; // lackey: keep instruction fetches
+    long long line;    // text: last line read, for error messages
+    long long refs;    // references decoded so far
+    char error[128];   // empty unless reading stopped on bad input
+} PageTrace;
+
+typedef struct
+{
+    PagePolicy policy;
+    long long refs, faults;
+    long long elapsedNs;
+    size_t metadataBytes;
+} PageTraceResult;
+
+// --- Function Prototypes ---
+/**
+ * Opens a trace (NULL or "-" reads stdin). `pageSize` must be a power of
+ * two; 1 passes addresses through as page numbers. Returns false only
+ * when the file cannot be opened; bad input shows up in t->error.
+ */
+bool openPageTrace(PageTrace *t, const char *path, long long pageSize, bool instructions);
+int readPageTrace(PageTrace *t, long long pages[], int max); // pages read, 0 at the end
+void closePageTrace(PageTrace *t);
+
+/**
+ * Rewrites a trace as a binary trace of addresses, streaming. Instruction
+ * fetches are kept only with `instructions`. Returns false and fills
+ * `error` on bad input or I/O failure.
+ */
+bool convertPageTrace(const char *inPath, const char *outPath, bool instructions, long long *refs, char *error,
+                      size_t errorSize);
+
+/**
+ * Streams the trace once, feeding each chunk to every policy in
+ * `policyMask` (bit p-1 for PagePolicy p) over `frames` frames. Memory use
+ * does not grow with the trace, so Optimal, which needs the whole future,
+ * is left out. Fills results in policy order; returns how many, or -1 with
+ * `error` filled.
+ */
+int replayPageTrace(const char *path, long long pageSize, bool instructions, int frames, unsigned policyMask,
+                    PageTraceResult results[], char *error, size_t errorSize);
+
+// Interactive front end: asks for a file, page size and frame count
+void runPageTraceReplay();
+
+#endif
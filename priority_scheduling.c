@@ -0,0 +1,280 @@
+#include "priority_scheduling.h"
+
+// ==========================================
+//      PRIORITY & MLFQ SCHEDULING
+// ==========================================
+
+// ==========================================
+//      BITMAP RUN QUEUE
+// ==========================================
+
+void initPriorityRunQueue(PriorityRunQueue *q, int capacity)
+{
+    q->bitmap = 0;
+    for (int l = 0; l < PRIO_LEVELS; l++)
+        q->head[l] = q->tail[l] = -1;
+    q->next = safeMalloc(capacity * sizeof(int));
+}
+
+void freePriorityRunQueue(PriorityRunQueue *q)
+{
+    free(q->next);
+    q->next = NULL;
+}
+
+void pushPriority(PriorityRunQueue *q, int level, int idx)
+{
+    q->next[idx] = -1;
+    if (q->head[level] == -1)
+        q->head[level] = idx;
+    else
+        q->next[q->tail[level]] = idx;
+    q->tail[level] = idx;
+    q->bitmap |= 1ULL << level;
+}
+
+int topPriorityLevel(const PriorityRunQueue *q)
+{
+    return q->bitmap ? lowestSetBit(q->bitmap) : -1;
+}
+
+int popPriority(PriorityRunQueue *q, int level)
+{
+    int idx = q->head[level];
+    q->head[level] = q->next[idx];
+    if (q->head[level] == -1)
+    {
+        q->tail[level] = -1;
+        q->bitmap &= ~(1ULL << level);
+    }
+    return idx;
+}
+
+// Appends the whole FIFO at `from` to the end of the FIFO at `to`: O(1)
+static void spliceLevel(PriorityRunQueue *q, int from, int to)
+{
+    if (q->head[from] == -1)
+        return;
+    if (q->head[to] == -1)
+        q->head[to] = q->head[from];
+    else
+        q->next[q->tail[to]] = q->head[from];
+    q->tail[to] = q->tail[from];
+    q->head[from] = q->tail[from] = -1;
+    q->bitmap = (q->bitmap & ~(1ULL << from)) | (1ULL << to);
+}
+
+static int clampLevel(int pr)
+{
+    if (pr < 0)
+        return 0;
+    return (pr >= PRIO_LEVELS) ? PRIO_LEVELS - 1 : pr;
+}
+
+// Next multiple of `interval` strictly after `time`
+static long long nextTick(long long time, int interval)
+{
+    return (time / interval + 1) * interval;
+}
+
+// ==========================================
+//      PREEMPTIVE PRIORITY WITH AGING
+// ==========================================
+
+void schedulePriority(Process p[], int n, int agingInterval, SchedTrace *trace)
+{
+    resetTrace(trace);
+    if (!isSortedByArrival(p, n))
+        sortByArrival(p, n);
+    for (int i = 0; i < n; i++)
+        p[i].rem_bt = p[i].bt;
+
+    PriorityRunQueue ready;
+    initPriorityRunQueue(&ready, n);
+    int next = 0, completed = 0, time = 0;
+    int running = -1, runLevel = 0, segStart = 0;
+    long long nextAging = LLONG_MAX;
+
+    while (completed != n)
+    {
+        // Waiting time only counts while someone is actually waiting
+        if (agingInterval > 0 && ready.bitmap == 0)
+            nextAging = nextTick(time, agingInterval);
+        if (agingInterval > 0 && nextAging <= time)
+        {
+            // Aging: every waiting process moves one level closer to the top
+            for (int l = 1; l < PRIO_LEVELS; l++)
+                spliceLevel(&ready, l, l - 1);
+            nextAging += agingInterval;
+        }
+        while (next < n && p[next].at <= time)
+        {
+            pushPriority(&ready, clampLevel(p[next].pr), next);
+            next++;
+        }
+
+        int top = topPriorityLevel(&ready);
+        if (running == -1)
+        {
+            if (top == -1)
+            {
+                time = p[next].at; // CPU idle: jump to the next arrival
+                continue;
+            }
+            runLevel = top;
+            running = popPriority(&ready, top);
+            segStart = time;
+        }
+        else if (top != -1 && top < runLevel)
+        {
+            // Preempted: it ran, so it returns at its own base priority
+            addToHistory(trace, p[running].id, segStart, time);
+            pushPriority(&ready, clampLevel(p[running].pr), running);
+            runLevel = top;
+            running = popPriority(&ready, top);
+            segStart = time;
+        }
+
+        // Run until completion, the next arrival or the next aging tick
+        long long event = (long long)time + p[running].rem_bt;
+        if (next < n && p[next].at < event)
+            event = p[next].at;
+        if (agingInterval > 0 && ready.bitmap != 0 && nextAging < event)
+            event = nextAging;
+
+        p[running].rem_bt -= (int)(event - time);
+        time = (int)event;
+        if (p[running].rem_bt == 0)
+        {
+            p[running].ct = time;
+            addToHistory(trace, p[running].id, segStart, time);
+            completed++;
+            running = -1;
+        }
+    }
+    freePriorityRunQueue(&ready);
+    calculateMetrics(p, n);
+}
+
+// ==========================================
+//      MULTILEVEL FEEDBACK QUEUE
+// ==========================================
+
+static int levelQuantum(const MLFQConfig *cfg, int level)
+{
+    long long q = (long long)cfg->baseQuantum << level;
+    return (q > INT_MAX / 2) ? INT_MAX / 2 : (int)q;
+}
+
+void scheduleMLFQ(Process p[], int n, const MLFQConfig *cfg, SchedTrace *trace)
+{
+    resetTrace(trace);
+    if (!isSortedByArrival(p, n))
+        sortByArrival(p, n);
+    for (int i = 0; i < n; i++)
+        p[i].rem_bt = p[i].bt;
+
+    int levels = cfg->levels;
+    if (levels < 1)
+        levels = 1;
+    if (levels > PRIO_LEVELS)
+        levels = PRIO_LEVELS;
+
+    PriorityRunQueue ready;
+    initPriorityRunQueue(&ready, n);
+    int next = 0, completed = 0, time = 0;
+    int running = -1, runLevel = 0, segStart = 0;
+    long long sliceEnd = 0, nextBoost = LLONG_MAX;
+
+    while (completed != n)
+    {
+        if (cfg->boostInterval > 0 && ready.bitmap == 0 && running == -1)
+            nextBoost = nextTick(time, cfg->boostInterval);
+        if (cfg->boostInterval > 0 && nextBoost <= time)
+        {
+            // Priority boost: every queue drains into the top one, in level order
+            for (int l = 1; l < levels; l++)
+                spliceLevel(&ready, l, 0);
+            if (running != -1 && runLevel > 0)
+            {
+                runLevel = 0;
+                if (sliceEnd > (long long)time + levelQuantum(cfg, 0))
+                    sliceEnd = (long long)time + levelQuantum(cfg, 0);
+            }
+            nextBoost += cfg->boostInterval;
+        }
+        while (next < n && p[next].at <= time)
+            pushPriority(&ready, 0, next++); // new work always starts at the top
+
+        int top = topPriorityLevel(&ready);
+        if (running == -1)
+        {
+            if (top == -1)
+            {
+                time = p[next].at;
+                continue;
+            }
+            runLevel = top;
+            running = popPriority(&ready, top);
+            segStart = time;
+            sliceEnd = (long long)time + levelQuantum(cfg, runLevel);
+        }
+        else if (top != -1 && top < runLevel)
+        {
+            // A higher queue has work: go back to the tail of our own level
+            addToHistory(trace, p[running].id, segStart, time);
+            pushPriority(&ready, runLevel, running);
+            runLevel = top;
+            running = popPriority(&ready, top);
+            segStart = time;
+            sliceEnd = (long long)time + levelQuantum(cfg, runLevel);
+        }
+
+        long long event = (long long)time + p[running].rem_bt;
+        if (sliceEnd < event)
+            event = sliceEnd;
+        if (next < n && p[next].at < event)
+            event = p[next].at;
+        if (cfg->boostInterval > 0 && nextBoost < event)
+            event = nextBoost;
+
+        p[running].rem_bt -= (int)(event - time);
+        time = (int)event;
+        if (p[running].rem_bt == 0)
+        {
+            p[running].ct = time;
+            addToHistory(trace, p[running].id, segStart, time);
+            completed++;
+            running = -1;
+        }
+        else if (time == sliceEnd)
+        {
+            // Used its whole quantum: demote one level (arrivals queue first)
+            addToHistory(trace, p[running].id, segStart, time);
+            while (next < n && p[next].at <= time)
+                pushPriority(&ready, 0, next++);
+            pushPriority(&ready, (runLevel + 1 < levels) ? runLevel + 1 : levels - 1, running);
+            running = -1;
+        }
+    }
+    freePriorityRunQueue(&ready);
+    calculateMetrics(p, n);
+}
+
+// ==========================================
+//      DISPLAY WRAPPERS
+// ==========================================
+
+void runPriority(Process p[], int n, int agingInterval, SchedTrace *trace)
+{
+    schedulePriority(p, n, agingInterval, trace);
+    printHeader("Priority Scheduling Results");
+    displaySchedulingTable(p, n, trace);
+}
+
+void runMLFQ(Process p[], int n, const MLFQConfig *cfg, SchedTrace *trace)
+{
+    scheduleMLFQ(p, n, cfg, trace);
+    printHeader("MLFQ Results");
+    displaySchedulingTable(p, n, trace);
+}
@@ -0,0 +1,56 @@
+#ifndef PRIORITY_SCHEDULING_H
+#define PRIORITY_SCHEDULING_H
+
+#include "cpu_scheduling.h"
+#include <stdint.h>
+
+// --- Constants ---
+#define PRIO_LEVELS 64 // one bit per level in the non-empty bitmap
+
+// --- Structures ---
+/**
+ * Linux O(1)-style run queue: one FIFO per priority level plus a bitmap of
+ * non-empty levels, so the next process is a single find-first-set away.
+ * The FIFOs are intrusive singly linked lists threaded through `next`.
+ */
+typedef struct
+{
+    uint64_t bitmap;
+    int head[PRIO_LEVELS];
+    int tail[PRIO_LEVELS];
+    int *next; // per-process link, indexed like p[]
+} PriorityRunQueue;
+
+typedef struct
+{
+    int levels;        // number of feedback queues (1..PRIO_LEVELS)
+    int baseQuantum;   // quantum of the top queue; doubles at each level down
+    int boostInterval; // every this many time units everyone returns to the top (0 = never)
+} MLFQConfig;
+
+// --- Run Queue ---
+void initPriorityRunQueue(PriorityRunQueue *q, int capacity);
+void freePriorityRunQueue(PriorityRunQueue *q);
+void pushPriority(PriorityRunQueue *q, int level, int idx);
+int topPriorityLevel(const PriorityRunQueue *q); // -1 when empty
+int popPriority(PriorityRunQueue *q, int level);
+
+// --- Function Prototypes ---
+/**
+ * Preemptive priority scheduling (0 = most important, clamped to 0..63).
+ * Every `agingInterval` time units all waiting processes move up one level
+ * so low-priority work cannot starve (0 disables aging).
+ */
+void schedulePriority(Process p[], int n, int agingInterval, SchedTrace *trace);
+
+/**
+ * Multilevel feedback queue: new work enters the top level, using a whole
+ * quantum demotes a process one level, and periodic boosts lift everyone
+ * back to the top.
+ */
+void scheduleMLFQ(Process p[], int n, const MLFQConfig *cfg, SchedTrace *trace);
+
+void runPriority(Process p[], int n, int agingInterval, SchedTrace *trace);
+void runMLFQ(Process p[], int n, const MLFQConfig *cfg, SchedTrace *trace);
+
+#endif
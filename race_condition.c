@@ -3,6 +3,16 @@
 //      MODULE 6: RACE CONDITION
 // ==========================================
 
+// Replays the lost-update interleaving: A reads, B reads/increments/writes, A writes
+int simulateLostUpdate(int shared)
+{
+    int seenByA = shared;
+    int seenByB = shared;
+    shared = seenByB + 1;
+    shared = seenByA + 1;
+    return shared;
+}
+
 void runRaceCondition()
 {
     printHeader("CONCURRENCY: RACE CONDITION SIMULATOR");
@@ -15,12 +25,12 @@ void runRaceCondition()
     printf(YELLOW "\n1. Thread A reads value (%d)\n" RESET, shared);
     printf(RED "--- CONTEXT SWITCH (Thread A Interrupted) ---\n" RESET);
     printf(CYAN "2. Thread B reads value (%d)\n" RESET, shared);
-    printf("3. Thread B increments value to 101 and writes it back.\n");
-    shared = 101;
-    printf(YELLOW "4. Thread A resumes. It still thinks the value is 100!\n" RESET);
-    printf("5. Thread A increments 100 to 101 and writes it back.\n");
-    shared = 101;
+    printf("3. Thread B increments value to %d and writes it back.\n", shared + 1);
+    printf(YELLOW "4. Thread A resumes. It still thinks the value is %d!\n" RESET, shared);
+    printf("5. Thread A increments %d to %d and writes it back.\n", shared, shared + 1);
+    int expected = shared + 2;
+    shared = simulateLostUpdate(shared);
 
-    printf("\n" RED "FINAL VALUE: %d" RESET " (Should have been 102)\n", shared);
+    printf("\n" RED "FINAL VALUE: %d" RESET " (Should have been %d)\n", shared, expected);
     printf("Explanation: The update from Thread B was overwritten by Thread A.\n");
 }
\ No newline at end of file
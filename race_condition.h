@@ -10,4 +10,10 @@
  */
 void runRaceCondition();
 
+/**
+ * Returns the shared value after two unsynchronized increments interleave
+ * badly (one update is lost).
+ */
+int simulateLostUpdate(int shared);
+
 #endif
\ No newline at end of file
@@ -6,47 +6,149 @@
 
 void displayRWState(int readers, int writer_active, int mutex, int wrt_sem)
 {
-    system(CLEAR_SCREEN);
+    beginFrame();
     printHeader("READER - WRITER PROBLEM");
-    printf(YELLOW "This simulation uses 'Reader Preference' logic.\n" RESET);
+    outPuts(YELLOW "This simulation uses 'Reader Preference' logic.\n" RESET);
 
-    printf("\n" WHITE "   [ SEMAPHORES STATUS ]\n" RESET);
-    printf("   Mutex (protects reader count) : %s\n", mutex == 1 ? GREEN "UNLOCKED (1)" RESET : RED "LOCKED (0)" RESET);
-    printf("   Wrt (protects shared file)    : %s\n", wrt_sem == 1 ? GREEN "UNLOCKED (1)" RESET : RED "LOCKED (0)" RESET);
+    outPuts("\n" WHITE "   [ SEMAPHORES STATUS ]\n" RESET);
+    outPrintf("   Mutex (protects reader count) : %s\n", mutex == 1 ? GREEN "UNLOCKED (1)" RESET : RED "LOCKED (0)" RESET);
+    outPrintf("   Wrt (protects shared file)    : %s\n", wrt_sem == 1 ? GREEN "UNLOCKED (1)" RESET : RED "LOCKED (0)" RESET);
 
-    printf("\n" WHITE "   [ CURRENT ACTIVITY ]\n" RESET);
-    printf("   Active Readers: " CYAN "%d" RESET "\n", readers);
-    printf("   Writer Status : %s\n", writer_active ? RED "WRITING INSIDE CRITICAL SECTION" RESET : GREEN "IDLE" RESET);
+    outPuts("\n" WHITE "   [ CURRENT ACTIVITY ]\n" RESET);
+    outPrintf("   Active Readers: " CYAN "%d" RESET "\n", readers);
+    outPrintf("   Writer Status : %s\n", writer_active ? RED "WRITING INSIDE CRITICAL SECTION" RESET : GREEN "IDLE" RESET);
 
-    printf("\n" WHITE "   [ VISUALIZATION ]\n" RESET);
-    printf("   File/Resource: [ ");
+    outPuts("\n" WHITE "   [ VISUALIZATION ]\n" RESET);
+    outPuts("   File/Resource: [ ");
     if (writer_active)
-        printf(RED "WRITER WRITING" RESET);
+        outPuts(RED "WRITER WRITING" RESET);
     else if (readers > 0)
     {
         for (int i = 0; i < readers; i++)
-            printf(CYAN "R " RESET);
+            outPuts(CYAN "R " RESET);
     }
     else
     {
-        printf(GREEN "EMPTY" RESET);
+        outPuts(GREEN "EMPTY" RESET);
     }
-    printf(" ]\n");
+    outPuts(" ]\n");
     printLine(60);
+    endFrame();
+}
+
+// Applies one menu action to the semaphore state. Returns false if the
+// action was blocked or invalid; msg receives the log line either way.
+bool applyRWAction(RWState *s, int choice, char *msg)
+{
+    bool accepted = true;
+    strcpy(msg, "");
+
+    switch (choice)
+    {
+    case 1:
+        if (s->wrt == 0 && s->read_count == 0)
+        {
+            sprintf(msg, RED "BLOCKED:" RESET " Reader cannot enter. Writer holds 'wrt' semaphore.");
+            accepted = false;
+        }
+        else
+        {
+            s->mutex = 0;
+            s->read_count++;
+            if (s->read_count == 1)
+            {
+                s->wrt = 0;
+                sprintf(msg, GREEN "SUCCESS:" RESET " First Reader entered. 'wrt' semaphore LOCKED.");
+            }
+            else
+            {
+                sprintf(msg, GREEN "SUCCESS:" RESET " Reader %d entered. Shared lock held.", s->read_count);
+            }
+            s->mutex = 1;
+        }
+        break;
+
+    case 2:
+        if (s->read_count == 0)
+        {
+            sprintf(msg, YELLOW "WARNING:" RESET " No readers are currently inside.");
+            accepted = false;
+        }
+        else
+        {
+            s->mutex = 0;
+            s->read_count--;
+            if (s->read_count == 0)
+            {
+                s->wrt = 1;
+                sprintf(msg, GREEN "LEFT:" RESET " Last Reader left. 'wrt' semaphore UNLOCKED.");
+            }
+            else
+            {
+                sprintf(msg, GREEN "LEFT:" RESET " Reader left. %d remain.", s->read_count);
+            }
+            s->mutex = 1;
+        }
+        break;
+
+    case 3:
+        if (s->wrt == 0)
+        {
+            if (s->read_count > 0)
+                sprintf(msg, RED "BLOCKED:" RESET " Writer cannot enter. Readers hold the lock.");
+            else
+                sprintf(msg, RED "BLOCKED:" RESET " Writer cannot enter. Another Writer is active.");
+            accepted = false;
+        }
+        else
+        {
+            s->wrt = 0;
+            sprintf(msg, GREEN "SUCCESS:" RESET " Writer Entered. 'wrt' LOCKED.");
+        }
+        break;
+
+    case 4:
+        if (s->wrt == 1)
+        {
+            sprintf(msg, YELLOW "WARNING:" RESET " No writer is currently writing.");
+            accepted = false;
+        }
+        else if (s->read_count > 0)
+        {
+            sprintf(msg, RED "ERROR:" RESET " Invalid State (Readers present while WRT held).");
+            accepted = false;
+        }
+        else
+        {
+            s->wrt = 1;
+            sprintf(msg, GREEN "LEFT:" RESET " Writer left. 'wrt' semaphore RELEASED.");
+        }
+        break;
+    default:
+        sprintf(msg, "Invalid Selection.");
+        accepted = false;
+    }
+    return accepted;
+}
+
+void initRWState(RWState *s)
+{
+    s->read_count = 0;
+    s->mutex = 1;
+    s->wrt = 1;
 }
 
 void runReaderWriter()
 {
-    int read_count = 0;
-    int mutex = 1;
-    int wrt = 1;
+    RWState state;
+    initRWState(&state);
 
     int choice;
     char msg[256] = "System Ready.";
 
     while (1)
     {
-        displayRWState(read_count, (wrt == 0 && read_count == 0), mutex, wrt);
+        displayRWState(state.read_count, (state.wrt == 0 && state.read_count == 0), state.mutex, state.wrt);
         printf(MAGENTA "LOG: " RESET "%s\n", msg);
         printf("\n" BLUE "Actions:" RESET "\n");
         printf("1. New Reader Tries to Enter\n");
@@ -59,86 +161,6 @@ void runReaderWriter()
 
         if (choice == 5)
             break;
-        strcpy(msg, "");
-
-        switch (choice)
-        {
-        case 1:
-            if (wrt == 0 && read_count == 0)
-            {
-                sprintf(msg, RED "BLOCKED:" RESET " Reader cannot enter. Writer holds 'wrt' semaphore.");
-            }
-            else
-            {
-                mutex = 0;
-                read_count++;
-                if (read_count == 1)
-                {
-                    wrt = 0;
-                    sprintf(msg, GREEN "SUCCESS:" RESET " First Reader entered. 'wrt' semaphore LOCKED.");
-                }
-                else
-                {
-                    sprintf(msg, GREEN "SUCCESS:" RESET " Reader %d entered. Shared lock held.", read_count);
-                }
-                mutex = 1;
-            }
-            break;
-
-        case 2:
-            if (read_count == 0)
-            {
-                sprintf(msg, YELLOW "WARNING:" RESET " No readers are currently inside.");
-            }
-            else
-            {
-                mutex = 0;
-                read_count--;
-                if (read_count == 0)
-                {
-                    wrt = 1;
-                    sprintf(msg, GREEN "LEFT:" RESET " Last Reader left. 'wrt' semaphore UNLOCKED.");
-                }
-                else
-                {
-                    sprintf(msg, GREEN "LEFT:" RESET " Reader left. %d remain.", read_count);
-                }
-                mutex = 1;
-            }
-            break;
-
-        case 3:
-            if (wrt == 0)
-            {
-                if (read_count > 0)
-                    sprintf(msg, RED "BLOCKED:" RESET " Writer cannot enter. Readers hold the lock.");
-                else
-                    sprintf(msg, RED "BLOCKED:" RESET " Writer cannot enter. Another Writer is active.");
-            }
-            else
-            {
-                wrt = 0;
-                sprintf(msg, GREEN "SUCCESS:" RESET " Writer Entered. 'wrt' LOCKED.");
-            }
-            break;
-
-        case 4:
-            if (wrt == 1)
-            {
-                sprintf(msg, YELLOW "WARNING:" RESET " No writer is currently writing.");
-            }
-            else if (read_count > 0)
-            {
-                sprintf(msg, RED "ERROR:" RESET " Invalid State (Readers present while WRT held).");
-            }
-            else
-            {
-                wrt = 1;
-                sprintf(msg, GREEN "LEFT:" RESET " Writer left. 'wrt' semaphore RELEASED.");
-            }
-            break;
-        default:
-            sprintf(msg, "Invalid Selection.");
-        }
+        applyRWAction(&state, choice, msg);
     }
 }
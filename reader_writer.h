@@ -3,12 +3,31 @@
 
 #include "utils.h"
 
+// --- Structures ---
+typedef struct
+{
+    int read_count;
+    int mutex;
+    int wrt;
+} RWState;
+
 // --- Function Prototypes ---
 /**
  * Displays the current state of semaphores, active readers, and writers.
  */
 void displayRWState(int readers, int writer_active, int mutex, int wrt_sem);
 
+/**
+ * Resets the semaphores to their initial (unlocked, no readers) state.
+ */
+void initRWState(RWState *s);
+
+/**
+ * Applies one action (1 = reader enters, 2 = reader leaves, 3 = writer enters,
+ * 4 = writer leaves). Returns false if it was blocked or invalid.
+ */
+bool applyRWAction(RWState *s, int choice, char *msg);
+
 /**
  * Runs the interactive Reader-Writer simulation (Reader Preference).
  */
@@ -0,0 +1,183 @@
+#include "scheduler_compare.h"
+#include <pthread.h>
+
+// ==========================================
+//      PARALLEL ALGORITHM COMPARISON
+// ==========================================
+
+#define FIXED_JOBS 3 // FCFS, SJF, SRTF; the rest are RR quanta
+
+typedef struct
+{
+    const Process *original;
+    int n;
+    int qMin;
+    int qStep;
+    int totalJobs;
+    int nextJob;
+    pthread_mutex_t lock;
+    ComparisonRow *rows;
+} ComparisonPool;
+
+static void summarizeRun(const Process p[], int n, const SchedTrace *trace, ComparisonRow *row)
+{
+    double sumWt = 0, sumTat = 0;
+    long long busy = 0;
+    int firstArrival = p[0].at, lastCompletion = p[0].ct;
+
+    for (int i = 0; i < n; i++)
+    {
+        sumWt += p[i].wt;
+        sumTat += p[i].tat;
+        if (p[i].at < firstArrival)
+            firstArrival = p[i].at;
+        if (p[i].ct > lastCompletion)
+            lastCompletion = p[i].ct;
+    }
+    for (int i = 0; i < trace->count; i++)
+        busy += trace->segments[i].endTime - trace->segments[i].startTime;
+
+    long long span = (long long)lastCompletion - firstArrival;
+    row->avgWaiting = sumWt / n;
+    row->avgTurnaround = sumTat / n;
+    row->contextSwitches = trace->contextSwitches;
+    row->cpuUtilization = (span > 0) ? 100.0 * busy / span : 100.0;
+}
+
+static int claimJob(ComparisonPool *pool)
+{
+    pthread_mutex_lock(&pool->lock);
+    int job = pool->nextJob++;
+    pthread_mutex_unlock(&pool->lock);
+    return (job < pool->totalJobs) ? job : -1;
+}
+
+// Worker: pulls jobs until none are left, reusing one working copy and trace
+static void *comparisonWorker(void *arg)
+{
+    ComparisonPool *pool = arg;
+    Process *working = safeMalloc(pool->n * sizeof(Process));
+    SchedTrace trace;
+    initTrace(&trace);
+    reserveTrace(&trace, pool->n);
+
+    for (int job = claimJob(pool); job != -1; job = claimJob(pool))
+    {
+        ComparisonRow *row = &pool->rows[job];
+        memcpy(working, pool->original, pool->n * sizeof(Process));
+        row->quantum = 0;
+
+        if (job == 0)
+        {
+            strcpy(row->label, "FCFS");
+            strcpy(row->algorithm, "FCFS");
+            scheduleFCFS(working, pool->n, &trace);
+        }
+        else if (job == 1)
+        {
+            strcpy(row->label, "SJF");
+            strcpy(row->algorithm, "SJF");
+            scheduleSJF(working, pool->n, &trace);
+        }
+        else if (job == 2)
+        {
+            strcpy(row->label, "SRTF");
+            strcpy(row->algorithm, "SRTF");
+            scheduleSRTF(working, pool->n, &trace);
+        }
+        else
+        {
+            row->quantum = pool->qMin + (job - FIXED_JOBS) * pool->qStep;
+            snprintf(row->label, sizeof(row->label), "RR (q=%d)", row->quantum);
+            strcpy(row->algorithm, "RR");
+            scheduleRoundRobin(working, pool->n, row->quantum, &trace);
+        }
+        summarizeRun(working, pool->n, &trace, row);
+    }
+
+    freeTrace(&trace);
+    free(working);
+    return NULL;
+}
+
+ComparisonRow *compareSchedulers(const Process original[], int n, int qMin, int qMax, int qStep,
+                                 int threads, int *rowCount)
+{
+    if (qStep < 1)
+        qStep = 1;
+    int quanta = (qMax >= qMin) ? (qMax - qMin) / qStep + 1 : 0;
+
+    ComparisonPool pool;
+    pool.original = original;
+    pool.n = n;
+    pool.qMin = qMin;
+    pool.qStep = qStep;
+    pool.totalJobs = FIXED_JOBS + quanta;
+    pool.nextJob = 0;
+    pool.rows = safeMalloc(pool.totalJobs * sizeof(ComparisonRow));
+    pthread_mutex_init(&pool.lock, NULL);
+
+    if (threads < 1)
+        threads = availableCores();
+    if (threads > pool.totalJobs)
+        threads = pool.totalJobs;
+
+    pthread_t *workers = safeMalloc(threads * sizeof(pthread_t));
+    int started = 0;
+    for (int i = 0; i < threads; i++)
+        if (pthread_create(&workers[started], NULL, comparisonWorker, &pool) == 0)
+            started++;
+    if (started == 0)
+        comparisonWorker(&pool); // no threads available: do the work inline
+    for (int i = 0; i < started; i++)
+        pthread_join(workers[i], NULL);
+
+    pthread_mutex_destroy(&pool.lock);
+    free(workers);
+    *rowCount = pool.totalJobs;
+    return pool.rows;
+}
+
+void printComparisonTable(const ComparisonRow rows[], int count)
+{
+    int best = 0;
+    for (int i = 1; i < count; i++)
+        if (rows[i].avgWaiting < rows[best].avgWaiting)
+            best = i;
+
+    holdOutput();
+    printHeader("ALGORITHM COMPARISON");
+    printLine(78);
+    outPrintf(CYAN "| %-14s | %-12s | %-14s | %-12s | %-12s |\n" RESET,
+              "Algorithm", "Avg Waiting", "Avg Turnaround", "Ctx Switches", "CPU Util %");
+    printLine(78);
+    for (int i = 0; i < count; i++)
+    {
+        outPrintf("| %s%-14s" RESET " | %-12.2f | %-14.2f | %-12d | %-12.2f |\n",
+                  (i == best) ? GREEN : "", rows[i].label, rows[i].avgWaiting, rows[i].avgTurnaround,
+                  rows[i].contextSwitches, rows[i].cpuUtilization);
+    }
+    printLine(78);
+    outPrintf(YELLOW "Lowest average waiting time: %s\n" RESET, rows[best].label);
+    releaseOutput();
+}
+
+void runSchedulerComparison(const Process original[], int n)
+{
+    printf("Round Robin quantum sweep - from: ");
+    int qMin = getSafeInt();
+    printf("to: ");
+    int qMax = getSafeInt();
+    printf("step: ");
+    int qStep = getSafeInt();
+    if (qMin < 1)
+        qMin = 1;
+
+    int threads = availableCores();
+    printf(GREEN "\nRunning on %d worker thread(s)...\n" RESET, threads);
+
+    int count;
+    ComparisonRow *rows = compareSchedulers(original, n, qMin, qMax, qStep, threads, &count);
+    printComparisonTable(rows, count);
+    free(rows);
+}
@@ -0,0 +1,33 @@
+#ifndef SCHEDULER_COMPARE_H
+#define SCHEDULER_COMPARE_H
+
+#include "cpu_scheduling.h"
+
+// --- Structures ---
+typedef struct
+{
+    char label[24];     // for display, e.g. "RR (q=4)"
+    char algorithm[8];  // bare name for CSV: FCFS, SJF, SRTF or RR
+    int quantum; // 0 for algorithms without a time slice
+    double avgWaiting;
+    double avgTurnaround;
+    int contextSwitches;
+    double cpuUtilization; // busy time / (last completion - first arrival)
+} ComparisonRow;
+
+// --- Function Prototypes ---
+/**
+ * Runs FCFS, SJF, SRTF and Round Robin for every quantum in
+ * [qMin, qMax] (step qStep) on a pool of `threads` workers. Each worker
+ * owns its working copy of the workload and its trace. Returns a new array
+ * of *rowCount rows in a fixed order (FCFS, SJF, SRTF, then RR by quantum).
+ */
+ComparisonRow *compareSchedulers(const Process original[], int n, int qMin, int qMax, int qStep,
+                                 int threads, int *rowCount);
+
+void printComparisonTable(const ComparisonRow rows[], int count);
+
+// Interactive front end: asks for the quantum range and prints the table
+void runSchedulerComparison(const Process original[], int n);
+
+#endif
@@ -0,0 +1,214 @@
+#include "slab_allocator.h"
+
+// ==========================================
+//      SLAB / OBJECT-CACHE ALLOCATOR
+// ==========================================
+
+static void pushPartial(SlabAllocator *s, int c, long long p)
+{
+    SlabPage *pg = &s->page[p];
+    pg->prev = -1;
+    pg->next = s->caches[c].partial;
+    if (pg->next != -1)
+        s->page[pg->next].prev = (int)p;
+    s->caches[c].partial = (int)p;
+}
+
+static void unlinkPartial(SlabAllocator *s, int c, long long p)
+{
+    SlabPage *pg = &s->page[p];
+    if (pg->prev == -1)
+        s->caches[c].partial = pg->next;
+    else
+        s->page[pg->prev].next = pg->next;
+    if (pg->next != -1)
+        s->page[pg->next].prev = pg->prev;
+}
+
+bool initSlab(SlabAllocator *s, long long arenaSize)
+{
+    if (!initBuddy(&s->pages, arenaSize))
+        return false;
+    s->pageCount = (s->pages.size + SLAB_PAGE - 1) / SLAB_PAGE;
+    s->page = safeMalloc((size_t)s->pageCount * sizeof(SlabPage));
+    for (long long p = 0; p < s->pageCount; p++)
+        s->page[p].cache = -1;
+    for (int c = 0; c < SLAB_CLASSES; c++)
+    {
+        s->caches[c].objectSize = SLAB_MIN_OBJECT << c;
+        s->caches[c].perSlab = SLAB_PAGE / s->caches[c].objectSize;
+        s->caches[c].partial = -1;
+        s->caches[c].slabs = 0;
+        s->caches[c].objects = 0;
+    }
+    s->largeBytes = 0;
+    memset(&s->stats, 0, sizeof(s->stats));
+    return true;
+}
+
+void freeSlab(SlabAllocator *s)
+{
+    freeBuddy(&s->pages);
+    free(s->page);
+    s->page = NULL;
+}
+
+static void trackPeak(SlabAllocator *s)
+{
+    if (s->stats.blockBytes > s->stats.peakBlockBytes)
+        s->stats.peakBlockBytes = s->stats.blockBytes;
+}
+
+long long slabAlloc(SlabAllocator *s, long long size)
+{
+    int c = 0;
+    while (c < SLAB_CLASSES && s->caches[c].objectSize < size)
+        c++;
+    if (size < 0 || c == SLAB_CLASSES)
+    {
+        // Too big for any cache: straight to the buddy system
+        long long offset = (size < 0) ? -1 : buddyAlloc(&s->pages, size);
+        if (offset == -1)
+        {
+            s->stats.failures++;
+            return -1;
+        }
+        long long block = buddyBlockSize(&s->pages, offset);
+        s->largeBytes += block;
+        s->stats.allocs++;
+        s->stats.blockBytes += block;
+        trackPeak(s);
+        return offset;
+    }
+
+    SlabCache *cache = &s->caches[c];
+    if (cache->partial == -1)
+    {
+        long long offset = buddyAlloc(&s->pages, SLAB_PAGE);
+        if (offset == -1)
+        {
+            s->stats.failures++;
+            return -1;
+        }
+        long long p = offset / SLAB_PAGE;
+        SlabPage *pg = &s->page[p];
+        pg->cache = (int16_t)c;
+        pg->inUse = 0;
+        memset(pg->freeMask, 0, sizeof(pg->freeMask));
+        for (int i = 0; i < cache->perSlab; i++)
+            pg->freeMask[i >> 6] |= 1ULL << (i & 63);
+        pushPartial(s, c, p);
+        cache->slabs++;
+    }
+
+    long long p = cache->partial;
+    SlabPage *pg = &s->page[p];
+    int word = 0;
+    while (pg->freeMask[word] == 0)
+        word++;
+    int slot = word * 64 + lowestSetBit(pg->freeMask[word]);
+    pg->freeMask[word] &= ~(1ULL << (slot & 63));
+    if (++pg->inUse == cache->perSlab)
+        unlinkPartial(s, c, p); // full slabs leave the partial list
+
+    cache->objects++;
+    s->stats.allocs++;
+    s->stats.blockBytes += cache->objectSize;
+    trackPeak(s);
+    return p * SLAB_PAGE + (long long)slot * cache->objectSize;
+}
+
+bool slabFree(SlabAllocator *s, long long offset)
+{
+    if (offset < 0 || offset >= s->pages.size)
+        return false;
+    long long p = offset / SLAB_PAGE;
+    SlabPage *pg = &s->page[p];
+    if (pg->cache == -1)
+    {
+        long long block = buddyBlockSize(&s->pages, offset);
+        if (block == 0 || !buddyFree(&s->pages, offset))
+            return false;
+        s->largeBytes -= block;
+        s->stats.frees++;
+        s->stats.blockBytes -= block;
+        return true;
+    }
+
+    int c = pg->cache;
+    SlabCache *cache = &s->caches[c];
+    long long within = offset - p * SLAB_PAGE;
+    int slot = (int)(within / cache->objectSize);
+    if (within % cache->objectSize != 0 || (pg->freeMask[slot >> 6] >> (slot & 63)) & 1)
+        return false; // not an object start, or already free
+
+    if (pg->inUse == cache->perSlab)
+        pushPartial(s, c, p); // was full: it has room again
+    pg->freeMask[slot >> 6] |= 1ULL << (slot & 63);
+    cache->objects--;
+    s->stats.frees++;
+    s->stats.blockBytes -= cache->objectSize;
+
+    if (--pg->inUse == 0)
+    {
+        // Empty slab: give the page back so other sizes can use it
+        unlinkPartial(s, c, p);
+        pg->cache = -1;
+        cache->slabs--;
+        buddyFree(&s->pages, p * SLAB_PAGE);
+    }
+    return true;
+}
+
+void slabStats(const SlabAllocator *s, AllocatorStats *out)
+{
+    AllocatorStats pages;
+    buddyStats(&s->pages, &pages);
+    *out = s->stats;
+    // Free slots in partial slabs count as free, but only for their own size class
+    out->freeBytes = pages.freeBytes;
+    out->freeRegions = pages.freeRegions;
+    out->largestFree = pages.largestFree;
+    for (int c = 0; c < SLAB_CLASSES; c++)
+    {
+        long long slots = s->caches[c].slabs * s->caches[c].perSlab - s->caches[c].objects;
+        out->freeBytes += slots * s->caches[c].objectSize;
+        out->freeRegions += slots;
+        if (slots > 0 && s->caches[c].objectSize > out->largestFree)
+            out->largestFree = s->caches[c].objectSize;
+    }
+    out->metadataBytes = pages.metadataBytes + s->pageCount * (long long)sizeof(SlabPage);
+}
+
+// ==========================================
+//      ALLOCATOR INTERFACE
+// ==========================================
+
+static long long opsAlloc(void *self, long long size)
+{
+    return slabAlloc(self, size);
+}
+
+static bool opsRelease(void *self, long long offset)
+{
+    return slabFree(self, offset);
+}
+
+static void opsStats(const void *self, AllocatorStats *out)
+{
+    slabStats(self, out);
+}
+
+// Slab pages are buddy blocks, so the buddy map shows what is in use
+static void opsMemoryMap(const void *self, char *out, int width)
+{
+    buddyMemoryMap(&((const SlabAllocator *)self)->pages, out, width);
+}
+
+static void opsDestroy(void *self)
+{
+    freeSlab(self);
+    free(self);
+}
+
+const AllocatorOps slabOps = {"Slab", opsAlloc, opsRelease, opsStats, opsMemoryMap, opsDestroy, NULL};
@@ -0,0 +1,57 @@
+#ifndef SLAB_ALLOCATOR_H
+#define SLAB_ALLOCATOR_H
+
+#include "buddy_allocator.h"
+
+// --- Constants ---
+#define SLAB_PAGE 4096
+#define SLAB_MIN_OBJECT 16
+#define SLAB_CLASSES 8 // object caches of 16, 32, ... 2048 bytes
+#define SLAB_MASK_WORDS (SLAB_PAGE / SLAB_MIN_OBJECT / 64)
+
+// --- Structures ---
+typedef struct
+{
+    int objectSize;
+    int perSlab;
+    int partial; // first page with free slots, -1 if none
+    long long slabs;
+    long long objects;
+} SlabCache;
+
+// Descriptor of one arena page; cache == -1 when the page is not a slab
+typedef struct
+{
+    int16_t cache;
+    int16_t inUse;
+    int prev, next; // partial-list links (page numbers)
+    uint64_t freeMask[SLAB_MASK_WORDS]; // one bit per free object slot
+} SlabPage;
+
+/**
+ * Object-cache allocator: small requests are rounded up to a power-of-two
+ * size class and carved out of one-page slabs taken from a buddy system;
+ * larger requests go to the buddy system directly. An empty slab is handed
+ * back to the buddy system at once.
+ */
+typedef struct
+{
+    BuddyAllocator pages;
+    SlabCache caches[SLAB_CLASSES];
+    SlabPage *page;
+    long long pageCount;
+    long long largeBytes; // live bytes in direct buddy allocations
+    AllocatorStats stats;
+} SlabAllocator;
+
+// Allocator interface for a SlabAllocator (self = SlabAllocator *)
+extern const AllocatorOps slabOps;
+
+// --- Function Prototypes ---
+bool initSlab(SlabAllocator *s, long long arenaSize);
+void freeSlab(SlabAllocator *s);
+long long slabAlloc(SlabAllocator *s, long long size); // offset, or -1
+bool slabFree(SlabAllocator *s, long long offset);
+void slabStats(const SlabAllocator *s, AllocatorStats *out);
+
+#endif
@@ -0,0 +1,367 @@
+#include "smp_scheduling.h"
+
+// ==========================================
+//      MULTI-CORE (SMP) SCHEDULING
+// ==========================================
+
+/**
+ * Per-core run queue: a deque threaded through the shared prev/next arrays
+ * (a process waits on at most one core). The owner takes from the head,
+ * thieves and the balancer take from the tail.
+ */
+typedef struct
+{
+    int head, tail, length;
+    int running; // index into p[], -1 when idle
+    int segStart;
+    long long sliceEnd;
+} SMPCore;
+
+typedef struct
+{
+    SMPCore *cores;
+    int count;
+    int *prev, *next;
+    int waiting; // total processes sitting in run queues
+} SMPQueues;
+
+static void pushTail(SMPQueues *q, int c, int idx)
+{
+    SMPCore *core = &q->cores[c];
+    q->prev[idx] = core->tail;
+    q->next[idx] = -1;
+    if (core->tail == -1)
+        core->head = idx;
+    else
+        q->next[core->tail] = idx;
+    core->tail = idx;
+    core->length++;
+    q->waiting++;
+}
+
+static void unlinkWaiter(SMPQueues *q, int c, int idx)
+{
+    SMPCore *core = &q->cores[c];
+    if (q->prev[idx] == -1)
+        core->head = q->next[idx];
+    else
+        q->next[q->prev[idx]] = q->next[idx];
+    if (q->next[idx] == -1)
+        core->tail = q->prev[idx];
+    else
+        q->prev[q->next[idx]] = q->prev[idx];
+    core->length--;
+    q->waiting--;
+}
+
+static int popHead(SMPQueues *q, int c)
+{
+    int idx = q->cores[c].head;
+    if (idx != -1)
+        unlinkWaiter(q, c, idx);
+    return idx;
+}
+
+static int popTail(SMPQueues *q, int c)
+{
+    int idx = q->cores[c].tail;
+    if (idx != -1)
+        unlinkWaiter(q, c, idx);
+    return idx;
+}
+
+// Load = waiting processes plus the one on the CPU
+static int coreLoad(const SMPCore *core)
+{
+    return core->length + (core->running != -1);
+}
+
+// Moves waiters from the most to the least loaded core until loads differ by at most one
+static long long rebalance(SMPQueues *q)
+{
+    long long moved = 0;
+    while (1)
+    {
+        int busiest = 0, idlest = 0;
+        for (int c = 1; c < q->count; c++)
+        {
+            if (coreLoad(&q->cores[c]) > coreLoad(&q->cores[busiest]))
+                busiest = c;
+            if (coreLoad(&q->cores[c]) < coreLoad(&q->cores[idlest]))
+                idlest = c;
+        }
+        if (coreLoad(&q->cores[busiest]) - coreLoad(&q->cores[idlest]) <= 1 || q->cores[busiest].length == 0)
+            return moved;
+        pushTail(q, idlest, popTail(q, busiest));
+        moved++;
+    }
+}
+
+static int stealWork(SMPQueues *q, int thief)
+{
+    int victim = -1;
+    for (int c = 0; c < q->count; c++)
+        if (c != thief && q->cores[c].length > 0 && (victim == -1 || q->cores[c].length > q->cores[victim].length))
+            victim = c;
+    return (victim == -1) ? -1 : popTail(q, victim);
+}
+
+void initSMPResult(SMPResult *res, int cores)
+{
+    res->cores = cores;
+    res->traces = safeMalloc(cores * sizeof(SchedTrace));
+    res->busyTime = safeMalloc(cores * sizeof(long long));
+    for (int c = 0; c < cores; c++)
+        initTrace(&res->traces[c]);
+    res->migrations = 0;
+    res->startTime = res->endTime = 0;
+}
+
+void freeSMPResult(SMPResult *res)
+{
+    for (int c = 0; c < res->cores; c++)
+        freeTrace(&res->traces[c]);
+    free(res->traces);
+    free(res->busyTime);
+    res->traces = NULL;
+    res->busyTime = NULL;
+}
+
+void scheduleSMP(Process p[], int n, const SMPConfig *cfg, SMPResult *res)
+{
+    int cores = res->cores;
+    for (int c = 0; c < cores; c++)
+    {
+        resetTrace(&res->traces[c]);
+        res->busyTime[c] = 0;
+    }
+    res->migrations = 0;
+    res->startTime = res->endTime = 0;
+    if (n <= 0)
+        return;
+    if (!isSortedByArrival(p, n))
+        sortByArrival(p, n);
+    for (int i = 0; i < n; i++)
+        p[i].rem_bt = p[i].bt;
+
+    SMPQueues q;
+    q.count = cores;
+    q.cores = safeMalloc(cores * sizeof(SMPCore));
+    q.prev = safeMalloc(n * sizeof(int));
+    q.next = safeMalloc(n * sizeof(int));
+    q.waiting = 0;
+    for (int c = 0; c < cores; c++)
+    {
+        q.cores[c].head = q.cores[c].tail = q.cores[c].running = -1;
+        q.cores[c].length = 0;
+    }
+
+    bool periodic = (cfg->balance == SMP_BALANCE_PERIODIC && cfg->balanceInterval > 0);
+    int next = 0, completed = 0, time = p[0].at;
+    long long nextBalance = LLONG_MAX;
+    res->startTime = time;
+
+    while (completed != n)
+    {
+        while (next < n && p[next].at <= time)
+        {
+            pushTail(&q, next % cores, next);
+            next++;
+        }
+        // The balancing clock runs only while something waits: it starts when the queues fill
+        if (periodic && q.waiting == 0)
+            nextBalance = LLONG_MAX;
+        else if (periodic && nextBalance == LLONG_MAX)
+            nextBalance = ((long long)time / cfg->balanceInterval + 1) * cfg->balanceInterval;
+        if (periodic && nextBalance <= time)
+        {
+            res->migrations += rebalance(&q);
+            nextBalance += cfg->balanceInterval;
+        }
+
+        // Dispatch: every idle core takes its own next waiter, or steals one
+        for (int c = 0; c < cores; c++)
+        {
+            SMPCore *core = &q.cores[c];
+            if (core->running != -1)
+                continue;
+            int idx = popHead(&q, c);
+            if (idx == -1 && cfg->balance == SMP_WORK_STEALING)
+            {
+                idx = stealWork(&q, c);
+                if (idx != -1)
+                    res->migrations++;
+            }
+            if (idx == -1)
+                continue;
+            core->running = idx;
+            core->segStart = time;
+            core->sliceEnd = (cfg->quantum > 0) ? (long long)time + cfg->quantum : LLONG_MAX;
+        }
+
+        // Next event: an arrival, a completion, a slice end or a balancing tick
+        long long event = (next < n) ? p[next].at : LLONG_MAX;
+        bool anyRunning = false;
+        for (int c = 0; c < cores; c++)
+        {
+            SMPCore *core = &q.cores[c];
+            if (core->running == -1)
+                continue;
+            anyRunning = true;
+            long long done = (long long)time + p[core->running].rem_bt;
+            if (done < event)
+                event = done;
+            if (core->sliceEnd < event)
+                event = core->sliceEnd;
+        }
+        if (!anyRunning)
+        {
+            time = p[next].at; // every core idle: jump to the next arrival
+            continue;
+        }
+        if (periodic && q.waiting > 0 && nextBalance < event)
+            event = nextBalance;
+
+        int elapsed = (int)(event - time);
+        for (int c = 0; c < cores; c++)
+            if (q.cores[c].running != -1)
+            {
+                p[q.cores[c].running].rem_bt -= elapsed;
+                res->busyTime[c] += elapsed;
+            }
+        time = (int)event;
+
+        // Arrivals at this instant queue ahead of processes whose slice just ended
+        while (next < n && p[next].at <= time)
+        {
+            pushTail(&q, next % cores, next);
+            next++;
+        }
+        for (int c = 0; c < cores; c++)
+        {
+            SMPCore *core = &q.cores[c];
+            int idx = core->running;
+            if (idx == -1)
+                continue;
+            if (p[idx].rem_bt == 0)
+            {
+                p[idx].ct = time;
+                addToHistory(&res->traces[c], p[idx].id, core->segStart, time);
+                core->running = -1;
+                completed++;
+            }
+            else if (time == core->sliceEnd)
+            {
+                if (core->length == 0)
+                    core->sliceEnd += cfg->quantum; // nobody waiting here: keep running
+                else
+                {
+                    addToHistory(&res->traces[c], p[idx].id, core->segStart, time);
+                    pushTail(&q, c, idx);
+                    core->running = -1;
+                }
+            }
+        }
+    }
+    res->endTime = time;
+
+    free(q.cores);
+    free(q.prev);
+    free(q.next);
+    calculateMetrics(p, n);
+}
+
+double smpUtilization(const SMPResult *res, int core)
+{
+    long long span = (long long)res->endTime - res->startTime;
+    return (span > 0) ? 100.0 * res->busyTime[core] / span : 0.0;
+}
+
+const char *smpBalanceName(SMPBalance balance)
+{
+    if (balance == SMP_BALANCE_PERIODIC)
+        return "periodic";
+    return (balance == SMP_WORK_STEALING) ? "steal" : "none";
+}
+
+// ==========================================
+//      REPORTING
+// ==========================================
+
+void printSMPReport(Process p[], int n, const SMPConfig *cfg, const SMPResult *res)
+{
+    holdOutput();
+    printHeader("SMP Scheduling Results");
+    outPrintf(YELLOW "%d cores, %s per core, balancing: %s\n" RESET, cfg->cores,
+              (cfg->quantum > 0) ? "Round Robin" : "FCFS", smpBalanceName(cfg->balance));
+
+    printLine(66);
+    outPrintf(CYAN "| %-6s | %-12s | %-10s | %-10s | %-14s |\n" RESET,
+              "Core", "Busy Time", "Util %", "Segments", "Ctx Switches");
+    printLine(66);
+    int totalSwitches = 0;
+    for (int c = 0; c < res->cores; c++)
+    {
+        outPrintf("| %-6d | %-12lld | %-10.2f | %-10d | %-14d |\n", c, res->busyTime[c],
+                  smpUtilization(res, c), res->traces[c].count, res->traces[c].contextSwitches);
+        totalSwitches += res->traces[c].contextSwitches;
+    }
+    printLine(66);
+
+    double sumWt = 0, sumTat = 0;
+    for (int i = 0; i < n; i++)
+    {
+        sumWt += p[i].wt;
+        sumTat += p[i].tat;
+    }
+    outPrintf(YELLOW "\nAverage Waiting Time: %.2f\n", (n > 0) ? sumWt / n : 0.0);
+    outPrintf("Average Turnaround Time: %.2f\n", (n > 0) ? sumTat / n : 0.0);
+    outPrintf("Makespan: %d\n", res->endTime - res->startTime);
+    outPrintf("Migrations: %lld\n", res->migrations);
+    outPrintf("Context Switches: %d\n" RESET, totalSwitches);
+
+    for (int c = 0; c < res->cores; c++)
+    {
+        outPrintf("\n" BLUE "Core %d" RESET, c);
+        printGanttChart(&res->traces[c]);
+    }
+    releaseOutput();
+}
+
+void runSMPSimulation(Process p[], int n)
+{
+    SMPConfig cfg;
+    printf("Number of cores (1-%d): ", SMP_MAX_CORES);
+    cfg.cores = getSafeInt();
+    if (cfg.cores < 1 || cfg.cores > SMP_MAX_CORES)
+    {
+        printf(RED "Invalid core count.\n" RESET);
+        return;
+    }
+    printf("Per-core policy: 1. FCFS  2. Round Robin\nSelection: ");
+    cfg.quantum = 0;
+    if (getSafeInt() == 2)
+    {
+        printf("Enter Time Quantum: ");
+        cfg.quantum = getSafeInt();
+        if (cfg.quantum < 1)
+            cfg.quantum = 1;
+    }
+    printf("Balancing: 1. None  2. Periodic push  3. Work stealing\nSelection: ");
+    int balance = getSafeInt();
+    cfg.balance = (balance == 2) ? SMP_BALANCE_PERIODIC : (balance == 3) ? SMP_WORK_STEALING : SMP_BALANCE_NONE;
+    cfg.balanceInterval = 0;
+    if (cfg.balance == SMP_BALANCE_PERIODIC)
+    {
+        printf("Balance every how many time units: ");
+        cfg.balanceInterval = getSafeInt();
+        if (cfg.balanceInterval < 1)
+            cfg.balanceInterval = 1;
+    }
+
+    SMPResult res;
+    initSMPResult(&res, cfg.cores);
+    scheduleSMP(p, n, &cfg, &res);
+    printSMPReport(p, n, &cfg, &res);
+    freeSMPResult(&res);
+}
@@ -0,0 +1,59 @@
+#ifndef SMP_SCHEDULING_H
+#define SMP_SCHEDULING_H
+
+#include "cpu_scheduling.h"
+
+// --- Constants ---
+#define SMP_MAX_CORES 1024
+
+// --- Structures ---
+typedef enum
+{
+    SMP_BALANCE_NONE,     // processes stay on the core they were placed on
+    SMP_BALANCE_PERIODIC, // every interval, push work from the longest to the shortest queue
+    SMP_WORK_STEALING     // an idle core takes the newest waiter of the busiest core
+} SMPBalance;
+
+typedef struct
+{
+    int cores;
+    int quantum;         // per-core Round Robin slice; 0 = run to completion (FCFS)
+    SMPBalance balance;
+    int balanceInterval; // for SMP_BALANCE_PERIODIC
+} SMPConfig;
+
+/**
+ * Everything an SMP run produces besides the per-process metrics in p[]:
+ * one Gantt trace and busy time per core, plus how often work moved.
+ */
+typedef struct
+{
+    int cores;
+    SchedTrace *traces;
+    long long *busyTime;
+    long long migrations; // processes moved from one core's run queue to another's
+    int startTime;        // first arrival
+    int endTime;          // last completion
+} SMPResult;
+
+// --- Function Prototypes ---
+void initSMPResult(SMPResult *res, int cores);
+void freeSMPResult(SMPResult *res);
+
+/**
+ * Simulates cfg->cores CPUs, each with its own FIFO run queue. Arrivals are
+ * placed round-robin across cores (the naive placement balancing must fix);
+ * cfg->balance decides how waiting work moves between queues afterwards.
+ * Fills in p[] (completion, turnaround, waiting) and res; prints nothing.
+ */
+void scheduleSMP(Process p[], int n, const SMPConfig *cfg, SMPResult *res);
+
+double smpUtilization(const SMPResult *res, int core); // percent of the makespan
+const char *smpBalanceName(SMPBalance balance);
+
+void printSMPReport(Process p[], int n, const SMPConfig *cfg, const SMPResult *res);
+
+// Interactive front end: asks for cores, local policy and balancing
+void runSMPSimulation(Process p[], int n);
+
+#endif
@@ -0,0 +1,399 @@
+#include "stack_distance.h"
+#include <pthread.h>
+
+// ==========================================
+//      SHARED HELPERS
+// ==========================================
+
+// Replaces each page by a dense id (0, 1, ... in order of first touch); returns how many pages are distinct
+static int numberPages(const long long refs[], long long count, int ids[])
+{
+    PageMap seen;
+    initPageMap(&seen, 1024);
+    int distinct = 0;
+    for (long long t = 0; t < count; t++)
+    {
+        int id = pageMapGet(&seen, refs[t]);
+        if (id == -1)
+        {
+            id = distinct++;
+            pageMapPut(&seen, refs[t], id);
+        }
+        ids[t] = id;
+    }
+    freePageMap(&seen);
+    return distinct;
+}
+
+static void initCurve(FaultCurve *c, PagePolicy policy, long long count, int maxFrames, int distinct)
+{
+    c->policy = policy;
+    c->maxFrames = (maxFrames > 0) ? maxFrames : (distinct > 0 ? distinct : 1);
+    c->refs = count;
+    c->cold = distinct;
+    c->faults = safeMalloc(((size_t)c->maxFrames + 1) * sizeof(long long));
+}
+
+// hits[d] holds the references at stack distance d; turns it into faults per frame count
+static void accumulateHits(FaultCurve *c, const long long hits[])
+{
+    long long faults = c->refs;
+    c->faults[0] = faults;
+    for (int f = 1; f <= c->maxFrames; f++)
+    {
+        faults -= hits[f];
+        c->faults[f] = faults;
+    }
+}
+
+void freeFaultCurve(FaultCurve *c)
+{
+    free(c->faults);
+    c->faults = NULL;
+}
+
+// ==========================================
+//      LRU: FENWICK TREE OVER TIME
+// ==========================================
+
+// Every page is marked at the time of its latest reference, so the marks
+// between two references of the same page are the distinct pages in between
+static void lruDistances(const int ids[], long long count, int distinct, int cap, long long hits[])
+{
+    int *tree = calloc((size_t)count + 1, sizeof(int));
+    long long *last = safeMalloc(((size_t)distinct + 1) * sizeof(long long));
+    if (tree == NULL)
+    {
+        printf(RED "\nFatal: out of memory for the distance tree\n" RESET);
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < distinct; i++)
+        last[i] = -1;
+
+    long long marked = 0; // marks at positions before t: one per page seen so far
+    for (long long t = 0; t < count; t++)
+    {
+        long long s = last[ids[t]];
+        if (s != -1)
+        {
+            long long upTo = 0; // marks at positions 0..s
+            for (long long i = s + 1; i > 0; i -= i & -i)
+                upTo += tree[i];
+            long long distance = marked - upTo + 1;
+            if (distance <= cap)
+                hits[distance]++;
+            for (long long i = s + 1; i <= count; i += i & -i)
+                tree[i]--;
+            marked--;
+        }
+        for (long long i = t + 1; i <= count; i += i & -i)
+            tree[i]++;
+        marked++;
+        last[ids[t]] = t;
+    }
+    free(last);
+    free(tree);
+}
+
+// ==========================================
+//      OPT: PRIORITY STACK
+// ==========================================
+
+// Mattson's priority stack for OPT: the referenced page goes on top and the
+// old top is carried down. At each depth the carried page swaps with the
+// resident one if the resident is needed later, so only the running maxima
+// of next use move. A max segment tree over stack depth finds each of them.
+typedef struct
+{
+    long long *tree; // max next use per subtree; leaves are stack depths
+    int leaves;
+    int *itemAt;     // page id at each depth (1-based)
+    int *depthOf;    // depth of each page id, 0 if never referenced
+} PriorityStack;
+
+static void setDepth(PriorityStack *s, int depth, int id, long long nextUse)
+{
+    s->itemAt[depth] = id;
+    s->depthOf[id] = depth;
+    int node = s->leaves + depth;
+    s->tree[node] = nextUse;
+    for (node /= 2; node >= 1; node /= 2)
+    {
+        long long l = s->tree[2 * node], r = s->tree[2 * node + 1];
+        s->tree[node] = (l > r) ? l : r;
+    }
+}
+
+// First depth in [from, to] whose page is next used after `v`, or -1. It
+// climbs from `from` instead of descending from the root, so consecutive
+// records a few depths apart cost a few steps rather than a full descent.
+static int firstLater(const PriorityStack *s, int from, int to, long long v)
+{
+    if (from > to)
+        return -1;
+    int node = s->leaves + from;
+    while (s->tree[node] <= v)
+    {
+        while (node & 1) // a right child: the next subtree to the right starts higher up
+        {
+            node >>= 1;
+            if (node <= 1)
+                return -1;
+        }
+        node++;
+    }
+    while (node < s->leaves)
+        node = (s->tree[2 * node] > v) ? 2 * node : 2 * node + 1;
+    int depth = node - s->leaves;
+    return (depth <= to) ? depth : -1;
+}
+
+static void optDistances(const int ids[], long long count, int distinct, int cap, long long hits[])
+{
+    // Backward pass: when each reference's page is used next
+    long long *nextUse = safeMalloc(((size_t)count + 1) * sizeof(long long));
+    long long *upcoming = safeMalloc(((size_t)distinct + 1) * sizeof(long long));
+    for (int i = 0; i < distinct; i++)
+        upcoming[i] = LLONG_MAX;
+    for (long long t = count - 1; t >= 0; t--)
+    {
+        nextUse[t] = upcoming[ids[t]];
+        upcoming[ids[t]] = t;
+    }
+    free(upcoming);
+
+    // The top `cap` depths are exactly OPT's frames for `cap` frames and never
+    // depend on what lies below, so the stack stops there
+    if (cap > distinct)
+        cap = distinct;
+    PriorityStack s;
+    s.leaves = 1;
+    while (s.leaves < cap + 2)
+        s.leaves *= 2;
+    s.tree = safeMalloc(2 * (size_t)s.leaves * sizeof(long long));
+    for (int i = 0; i < 2 * s.leaves; i++)
+        s.tree[i] = -1;
+    s.itemAt = safeMalloc(((size_t)cap + 2) * sizeof(int));
+    s.depthOf = calloc((size_t)distinct + 1, sizeof(int));
+    if (s.depthOf == NULL)
+    {
+        printf(RED "\nFatal: out of memory for the priority stack\n" RESET);
+        exit(EXIT_FAILURE);
+    }
+
+    int height = 0;
+    for (long long t = 0; t < count; t++)
+    {
+        int id = ids[t];
+        int depth = s.depthOf[id];
+        if (depth != 0)
+            hits[depth]++;
+        else if (height < cap)
+            depth = ++height; // a new page leaves its hole below the current bottom
+        else
+            depth = cap + 1; // off the kept stack: the last carried page falls off
+        if (depth > 1)
+        {
+            int carried = s.itemAt[1];
+            long long carriedNext = s.tree[s.leaves + 1];
+            for (int at = firstLater(&s, 2, depth - 1, carriedNext); at != -1;
+                 at = firstLater(&s, at + 1, depth - 1, carriedNext))
+            {
+                int resident = s.itemAt[at];
+                long long residentNext = s.tree[s.leaves + at];
+                setDepth(&s, at, carried, carriedNext);
+                carried = resident;
+                carriedNext = residentNext;
+            }
+            if (depth <= cap)
+                setDepth(&s, depth, carried, carriedNext);
+            else
+                s.depthOf[carried] = 0;
+        }
+        setDepth(&s, 1, id, nextUse[t]);
+    }
+    free(s.depthOf);
+    free(s.itemAt);
+    free(s.tree);
+    free(nextUse);
+}
+
+bool stackFaultCurve(PagePolicy policy, const long long refs[], long long count, int maxFrames, FaultCurve *out)
+{
+    if (policy != PAGE_LRU && policy != PAGE_OPT)
+        return false;
+    int *ids = safeMalloc(((size_t)count + 1) * sizeof(int));
+    int distinct = numberPages(refs, count, ids);
+    initCurve(out, policy, count, maxFrames, distinct);
+
+    long long *hits = calloc((size_t)out->maxFrames + 1, sizeof(long long));
+    if (hits == NULL)
+    {
+        printf(RED "\nFatal: out of memory for the distance histogram\n" RESET);
+        exit(EXIT_FAILURE);
+    }
+    if (policy == PAGE_LRU)
+        lruDistances(ids, count, distinct, out->maxFrames, hits);
+    else
+        optDistances(ids, count, distinct, out->maxFrames, hits);
+    accumulateHits(out, hits);
+    free(hits);
+    free(ids);
+    return true;
+}
+
+// ==========================================
+//      FIFO SWEEP (PARALLEL)
+// ==========================================
+
+typedef struct
+{
+    const int *ids;
+    long long count;
+    int distinct;
+    int totalJobs;
+    int nextJob;
+    pthread_mutex_t lock;
+    long long *faults;
+} SweepPool;
+
+static int claimFrameCount(SweepPool *pool)
+{
+    pthread_mutex_lock(&pool->lock);
+    int job = pool->nextJob++;
+    pthread_mutex_unlock(&pool->lock);
+    return (job < pool->totalJobs) ? pool->totalJobs - job : -1; // largest (slowest) first
+}
+
+// Same victims as the FIFO replacer, but over dense ids: a residency byte
+// per page instead of a hash lookup, since every replay walks the whole string
+static long long fifoReplay(const int ids[], long long count, int frames, int *ring, unsigned char *resident)
+{
+    long long faults = 0;
+    int hand = 0, filled = 0;
+    for (long long t = 0; t < count; t++)
+    {
+        int id = ids[t];
+        if (resident[id])
+            continue;
+        faults++;
+        if (filled == frames)
+            resident[ring[hand]] = 0;
+        else
+            filled++;
+        ring[hand] = id;
+        resident[id] = 1;
+        if (++hand == frames)
+            hand = 0;
+    }
+    return faults;
+}
+
+static void *sweepWorker(void *arg)
+{
+    SweepPool *pool = arg;
+    int *ring = safeMalloc(((size_t)pool->totalJobs + 1) * sizeof(int));
+    unsigned char *resident = safeMalloc((size_t)pool->distinct + 1);
+    for (int frames = claimFrameCount(pool); frames != -1; frames = claimFrameCount(pool))
+    {
+        memset(resident, 0, (size_t)pool->distinct + 1);
+        pool->faults[frames] = fifoReplay(pool->ids, pool->count, frames, ring, resident);
+    }
+    free(resident);
+    free(ring);
+    return NULL;
+}
+
+void fifoFaultSweep(const long long refs[], long long count, int maxFrames, int threads, FaultCurve *out)
+{
+    int *ids = safeMalloc(((size_t)count + 1) * sizeof(int));
+    int distinct = numberPages(refs, count, ids);
+    initCurve(out, PAGE_FIFO, count, maxFrames, distinct);
+    out->faults[0] = count;
+
+    SweepPool pool;
+    pool.ids = ids;
+    pool.count = count;
+    pool.distinct = distinct;
+    pool.totalJobs = out->maxFrames;
+    pool.nextJob = 0;
+    pool.faults = out->faults;
+    pthread_mutex_init(&pool.lock, NULL);
+
+    if (threads < 1)
+        threads = availableCores();
+    if (threads > pool.totalJobs)
+        threads = pool.totalJobs;
+
+    pthread_t *workers = safeMalloc(threads * sizeof(pthread_t));
+    int started = 0;
+    for (int i = 0; i < threads; i++)
+        if (pthread_create(&workers[started], NULL, sweepWorker, &pool) == 0)
+            started++;
+    if (started == 0)
+        sweepWorker(&pool); // no threads available: do the work inline
+    for (int i = 0; i < started; i++)
+        pthread_join(workers[i], NULL);
+
+    pthread_mutex_destroy(&pool.lock);
+    free(workers);
+    free(ids);
+}
+
+int beladyAnomalies(const FaultCurve *c, int frames[], int max)
+{
+    int found = 0;
+    for (int f = 1; f < c->maxFrames; f++)
+        if (c->faults[f + 1] > c->faults[f])
+        {
+            if (found < max)
+                frames[found] = f;
+            found++;
+        }
+    return found;
+}
+
+// ==========================================
+//      INTERACTIVE MODULE
+// ==========================================
+
+#define CURVE_ROWS 32 // larger sweeps print a sample of frame counts
+
+void showFaultCurves(const long long refs[], int count, int maxFrames)
+{
+    FaultCurve fifo, lru, opt;
+    long long start = monotonicNanos();
+    stackFaultCurve(PAGE_LRU, refs, count, maxFrames, &lru);
+    stackFaultCurve(PAGE_OPT, refs, count, maxFrames, &opt);
+    long long stackNs = monotonicNanos() - start;
+    start = monotonicNanos();
+    fifoFaultSweep(refs, count, maxFrames, 0, &fifo);
+    long long sweepNs = monotonicNanos() - start;
+
+    printHeader("PAGE FAULTS BY FRAME COUNT");
+    printf(CYAN "| %-6s | %-10s | %-10s | %-10s | %-16s |\n" RESET, "Frames", "FIFO", "LRU", "OPT", "Note");
+    printLine(68);
+    int step = (maxFrames + CURVE_ROWS - 1) / CURVE_ROWS;
+    for (int f = 1; f <= maxFrames; f++)
+    {
+        bool anomaly = (f > 1 && fifo.faults[f] > fifo.faults[f - 1]);
+        if (!anomaly && f % step != 0 && f != 1 && f != maxFrames)
+            continue;
+        printf("| %-6d | %s%-10lld" RESET " | %-10lld | %-10lld | %s |\n", f, anomaly ? RED : "", fifo.faults[f],
+               lru.faults[f], opt.faults[f], anomaly ? RED "Belady's anomaly" RESET : "                ");
+    }
+    printLine(68);
+
+    int anomalies = beladyAnomalies(&fifo, NULL, 0);
+    printf("Distinct pages (faults no frame count avoids): %lld\n", lru.cold);
+    if (anomalies > 0)
+        printf(RED "FIFO faults rose with an extra frame %d time(s).\n" RESET, anomalies);
+    else
+        printf(GREEN "No Belady's anomaly for FIFO up to %d frames.\n" RESET, maxFrames);
+    printf(YELLOW "LRU + OPT: one pass each, %.2f ms. FIFO: %d replays on %d core(s), %.2f ms.\n" RESET,
+           stackNs / 1e6, maxFrames, availableCores(), sweepNs / 1e6);
+
+    freeFaultCurve(&fifo);
+    freeFaultCurve(&lru);
+    freeFaultCurve(&opt);
+}
@@ -0,0 +1,57 @@
+#ifndef STACK_DISTANCE_H
+#define STACK_DISTANCE_H
+
+#include "page_replacement.h"
+
+// --- Structures ---
+/**
+ * Page faults as a function of frame count, for one policy and one
+ * reference string. faults[f] is the count with f frames, 1 <= f <= maxFrames
+ * (faults[0] is every reference). No frame count gets below `cold`, the
+ * number of distinct pages.
+ */
+typedef struct
+{
+    PagePolicy policy;
+    int maxFrames;
+    long long refs;
+    long long cold;
+    long long *faults;
+} FaultCurve;
+
+// --- Stack Algorithms ---
+/**
+ * One pass over the string builds the whole curve from Mattson stack
+ * distances: a reference at distance d hits with d or more frames.
+ *
+ * LRU counts the distinct pages touched since the previous reference with
+ * a Fenwick tree over time, O(log n) per reference. OPT keeps the priority
+ * stack ordered by next use in a max segment tree; a reference moves only
+ * the items whose next use is a running maximum down the stack, each found
+ * in O(log n).
+ *
+ * maxFrames <= 0 means up to the number of distinct pages, past which the
+ * curve is flat. Returns false for policies that are not stack algorithms.
+ */
+bool stackFaultCurve(PagePolicy policy, const long long refs[], long long count, int maxFrames, FaultCurve *out);
+
+// --- FIFO Sweep ---
+/**
+ * FIFO has no stack property, so every frame count 1..maxFrames is its own
+ * replay; the replays are spread over `threads` workers (<= 0: one per core).
+ */
+void fifoFaultSweep(const long long refs[], long long count, int maxFrames, int threads, FaultCurve *out);
+
+/**
+ * Writes each frame count f whose faults rise when a frame is added
+ * (Belady's anomaly: faults[f + 1] > faults[f]) into frames[], up to max
+ * entries. Returns how many there are in total.
+ */
+int beladyAnomalies(const FaultCurve *c, int frames[], int max);
+
+void freeFaultCurve(FaultCurve *c);
+
+// Interactive front end: FIFO, LRU and OPT side by side for 1..maxFrames
+void showFaultCurves(const long long refs[], int count, int maxFrames);
+
+#endif
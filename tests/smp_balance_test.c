@@ -0,0 +1,30 @@
+#include "../smp_scheduling.h"
+
+// Long and short jobs alternate, so round-robin placement stacks the long ones on core 0
+int main(void)
+{
+    int bursts[] = {10, 1, 10, 1, 10, 1};
+    int n = (int)(sizeof(bursts) / sizeof(bursts[0]));
+    Process p[6];
+    for (int i = 0; i < n; i++)
+    {
+        memset(&p[i], 0, sizeof(Process));
+        p[i].id = i + 1;
+        p[i].bt = bursts[i];
+    }
+
+    SMPConfig cfg = {2, 0, SMP_BALANCE_PERIODIC, 1};
+    SMPResult res;
+    initSMPResult(&res, cfg.cores);
+    scheduleSMP(p, n, &cfg, &res);
+    long long migrations = res.migrations;
+    freeSMPResult(&res);
+
+    if (migrations == 0)
+    {
+        fprintf(stderr, "FAIL: periodic balancing moved no work while queues were full\n");
+        return 1;
+    }
+    printf("PASS: periodic balancing made %lld migration(s)\n", migrations);
+    return 0;
+}
@@ -3,6 +3,18 @@
 int requests[MAX_REQ];
 int pages[MAX_REQ];
 int frames[MAX_FRAMES];
+bool headlessMode = false;
+
+// --- Output buffer state ---
+static char *outBuf = NULL;
+static size_t outLen = 0, outCap = 0;
+static int holdDepth = 0; // >0 while output is held (frames, tables)
+static size_t frameStart = 0;
+static bool incrementalRedraw = false;
+static char *prevFrame = NULL; // last frame drawn, for line diffing
+static size_t prevFrameLen = 0;
+
+static void forgetFrame();
 
 // ==========================================
 //      VISUALIZATION DELAY
@@ -11,10 +23,17 @@ int frames[MAX_FRAMES];
 // Slows down the output so the student can process the information
 void slowPrint(const char *text, int delay_ms)
 {
+    if (headlessMode || delay_ms <= 0)
+    {
+        outPuts(text);
+        outFlush();
+        return;
+    }
+    outFlush();
     for (int i = 0; text[i] != '\0'; i++)
     {
-        printf("%c", text[i]);
-        fflush(stdout); // Force print character immediately
+        outRepeat(text[i], 1);
+        outFlush(); // one raw write per character, no stdio round trip
         SLEEP_MS(delay_ms);
     }
 }
@@ -22,8 +41,11 @@ void slowPrint(const char *text, int delay_ms)
 // Simple pause before returning to menu
 void waitForStudent()
 {
+    if (headlessMode)
+        return;
     printf(YELLOW "\n\n[Analysis Complete. Press ENTER to return to Menu...]" RESET);
     getchar();
+    forgetFrame(); // results printed through stdio have scrolled the last frame away
 }
 
 // ==========================================
@@ -75,6 +97,8 @@ int getSafeInt()
 
 void waitForInput()
 {
+    if (headlessMode)
+        return;
     printf(YELLOW "\n[Press ENTER to continue...]" RESET);
     int c;
     while ((c = getchar()) != '\n' && c != EOF)
@@ -85,19 +109,231 @@ void waitForInput()
 //      VISUALIZATION HELPERS
 // ==========================================
 
+// ANSI clear + home instead of forking a shell for `clear`/`cls`
+void clearScreen()
+{
+    if (headlessMode)
+        return;
+    outPuts(ANSI_CLEAR);
+    outFlush();
+    forgetFrame();
+}
+
+// ==========================================
+//      BUFFERED OUTPUT
+// ==========================================
+
+static void reserveOut(size_t extra)
+{
+    if (outLen + extra + 1 <= outCap)
+        return;
+    size_t cap = outCap ? outCap : 4096;
+    while (outLen + extra + 1 > cap)
+        cap *= 2;
+    char *grown = realloc(outBuf, cap);
+    if (grown == NULL)
+    {
+        fprintf(stderr, "Fatal: out of memory in output buffer\n");
+        exit(EXIT_FAILURE);
+    }
+    outBuf = grown;
+    outCap = cap;
+}
+
+static void writeAll(const char *data, size_t len)
+{
+    fflush(stdout); // keep ordering with anything still printed through stdio
+    while (len > 0)
+    {
+#ifdef _WIN32
+        int written = _write(1, data, (unsigned int)len);
+#else
+        ssize_t written = write(STDOUT_FILENO, data, len);
+#endif
+        if (written <= 0)
+            return;
+        data += written;
+        len -= (size_t)written;
+    }
+}
+
+void outPrintf(const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    va_list copy;
+    va_copy(copy, args);
+    reserveOut(256);
+    int needed = vsnprintf(outBuf + outLen, outCap - outLen, fmt, args);
+    if (needed > 0 && (size_t)needed >= outCap - outLen)
+    {
+        reserveOut((size_t)needed);
+        vsnprintf(outBuf + outLen, outCap - outLen, fmt, copy);
+    }
+    if (needed > 0)
+        outLen += (size_t)needed;
+    va_end(copy);
+    va_end(args);
+}
+
+void outPuts(const char *text)
+{
+    size_t len = strlen(text);
+    reserveOut(len);
+    memcpy(outBuf + outLen, text, len);
+    outLen += len;
+}
+
+void outRepeat(char c, int count)
+{
+    if (count <= 0)
+        return;
+    reserveOut((size_t)count);
+    memset(outBuf + outLen, c, (size_t)count);
+    outLen += (size_t)count;
+}
+
+// Writes everything buffered so far; deferred while output is held
+void outFlush()
+{
+    reserveOut(1);
+    if (holdDepth > 0 || outLen == 0)
+        return;
+    writeAll(outBuf, outLen);
+    outLen = 0;
+    forgetFrame(); // output outside a frame moves what is on screen: the next frame redraws in full
+}
+
+// The screen no longer shows the last frame, so the next one cannot be a diff against it
+static void forgetFrame()
+{
+    free(prevFrame);
+    prevFrame = NULL;
+    prevFrameLen = 0;
+}
+
+void setIncrementalRedraw(bool enabled)
+{
+    incrementalRedraw = enabled;
+    forgetFrame();
+}
+
+// Hold/release bracket a block of output (e.g. a whole table) into one write
+void holdOutput()
+{
+    holdDepth++;
+}
+
+void releaseOutput()
+{
+    if (holdDepth > 0)
+        holdDepth--;
+    outFlush();
+}
+
+void beginFrame()
+{
+    outFlush();
+    frameStart = outLen;
+    holdDepth++;
+}
+
+// Length of the line starting at text[pos] (without the newline)
+static size_t lineLength(const char *text, size_t pos, size_t len)
+{
+    size_t end = pos;
+    while (end < len && text[end] != '\n')
+        end++;
+    return end - pos;
+}
+
+/**
+ * Rewrites only the lines that differ from the previous frame, using cursor
+ * addressing, then clears anything the old frame had below the new one.
+ */
+static void appendFrameDiff(const char *frame, size_t len, char *out, size_t *outPos)
+{
+    size_t newPos = 0, oldPos = 0;
+    int row = 1;
+    while (newPos < len)
+    {
+        size_t newLine = lineLength(frame, newPos, len);
+        size_t oldLine = (oldPos < prevFrameLen) ? lineLength(prevFrame, oldPos, prevFrameLen) : (size_t)-1;
+        if (oldLine != newLine || memcmp(frame + newPos, prevFrame + oldPos, newLine) != 0)
+        {
+            *outPos += (size_t)sprintf(out + *outPos, "\033[%d;1H", row);
+            memcpy(out + *outPos, frame + newPos, newLine);
+            *outPos += newLine;
+            *outPos += (size_t)sprintf(out + *outPos, "\033[K");
+        }
+        newPos += newLine + 1;
+        if (oldPos < prevFrameLen)
+            oldPos += oldLine + 1;
+        row++;
+    }
+    *outPos += (size_t)sprintf(out + *outPos, "\033[%d;1H\033[J", row);
+}
+
+void endFrame()
+{
+    if (holdDepth == 0)
+        return;
+    holdDepth--;
+
+    size_t len = outLen - frameStart;
+    char *frame = safeMalloc(len + 1);
+    memcpy(frame, outBuf + frameStart, len);
+    outLen = frameStart;
+
+    if (!headlessMode && incrementalRedraw && prevFrame != NULL)
+    {
+        // Worst case: every line rewritten plus ~16 bytes of escapes per line
+        size_t lines = 1;
+        for (size_t i = 0; i < len; i++)
+            lines += (frame[i] == '\n');
+        reserveOut(len + lines * 16 + 32);
+        appendFrameDiff(frame, len, outBuf, &outLen);
+    }
+    else
+    {
+        if (!headlessMode)
+            outPuts(ANSI_CLEAR);
+        reserveOut(len);
+        memcpy(outBuf + outLen, frame, len);
+        outLen += len;
+    }
+
+    if (incrementalRedraw)
+    {
+        free(prevFrame);
+        prevFrame = frame;
+        prevFrameLen = len;
+    }
+    else
+        free(frame);
+    if (holdDepth == 0)
+    {
+        // Written directly: outFlush would take this for output outside a frame
+        writeAll(outBuf, outLen);
+        outLen = 0;
+    }
+}
+
 void printLine(int width)
 {
-    printf(CYAN "+");
-    for (int i = 0; i < width; i++)
-        printf("-");
-    printf("+\n" RESET);
+    outPuts(CYAN "+");
+    outRepeat('-', width);
+    outPuts("+\n" RESET);
+    outFlush();
 }
 
 void printHeader(const char *title)
 {
-    printf("\n" MAGENTA "==================================================\n");
-    printf("   %s\n", title);
-    printf("==================================================\n" RESET);
+    outPrintf("\n" MAGENTA "==================================================\n"
+              "   %s\n"
+              "==================================================\n" RESET,
+              title);
+    outFlush();
 }
 
 int countDigits(int n)
@@ -112,3 +348,80 @@ int countDigits(int n)
     }
     return count;
 }
+
+// Allocation that aborts the simulator instead of handing back NULL
+void *safeMalloc(size_t size)
+{
+    void *ptr = malloc(size ? size : 1);
+    if (ptr == NULL)
+    {
+        printf(RED "\nFatal: out of memory (%zu bytes requested)\n" RESET, size);
+        exit(EXIT_FAILURE);
+    }
+    return ptr;
+}
+
+// Number of online CPUs, used to size worker thread pools
+int availableCores()
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    int cores = (int)info.dwNumberOfProcessors;
+#else
+    int cores = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    return (cores > 0) ? cores : 1;
+}
+
+// Reads one line of text (e.g. a file name) without the trailing newline
+void readPath(const char *prompt, char *path, size_t size)
+{
+    printf("%s", prompt);
+    if (fgets(path, (int)size, stdin) == NULL)
+        path[0] = '\0';
+    path[strcspn(path, "\r\n")] = '\0';
+}
+
+// Monotonic clock in nanoseconds, used to time individual operations
+long long monotonicNanos()
+{
+#ifdef _WIN32
+    LARGE_INTEGER freq, now;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (long long)(now.QuadPart * (1e9 / (double)freq.QuadPart));
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+#endif
+}
+
+// Find-first-set: a single instruction on GCC/Clang, a short loop elsewhere
+int lowestSetBit(uint64_t bits)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(bits);
+#else
+    int index = 0;
+    while (!(bits & 1))
+    {
+        bits >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+
+int highestSetBit(uint64_t bits)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(bits);
+#else
+    int index = 0;
+    while (bits >>= 1)
+        index++;
+    return index;
+#endif
+}
@@ -8,19 +8,33 @@
 #include <limits.h>
 #include <time.h>
 #include <math.h>
+#include <stdarg.h>
+#include <stdint.h>
 
 // --- OS Compatibility ---
+// Sleeps are skipped entirely in headless (batch) mode
 #ifdef _WIN32
 #define CLEAR_SCREEN "cls"
-#define SLEEP_MS(ms) Sleep(ms)
+#define SLEEP_MS(ms)          \
+    do                        \
+    {                         \
+        if (!headlessMode)    \
+            Sleep(ms);        \
+    } while (0)
 #else
 #define CLEAR_SCREEN "clear"
-#define SLEEP_MS(ms) usleep((ms) * 1000)
+#define SLEEP_MS(ms)                  \
+    do                                \
+    {                                 \
+        if (!headlessMode)            \
+            usleep((ms) * 1000);      \
+    } while (0)
 #endif
 
 // For the wait function
 #ifdef _WIN32
 #include <windows.h>
+#include <io.h>
 #else
 #include <unistd.h>
 #endif
@@ -36,6 +50,10 @@
 #define MAGENTA "\033[1;35m"
 #define CYAN "\033[1;36m"
 #define WHITE "\033[1;37m"
+#define ANSI_CLEAR "\033[H\033[2J"
+
+// Set by batch mode: no sleeps, no screen clears, no "press ENTER" pauses
+extern bool headlessMode;
 
 // Global Arrays for Simulations, using extern to declare them here
 extern int requests[MAX_REQ];
@@ -47,9 +65,30 @@ void slowPrint(const char *text, int delay_ms);
 void waitForStudent();
 void clearBuffer();
 int getSafeInt();
+void readPath(const char *prompt, char *path, size_t size);
 void waitForInput();
+void clearScreen();
 void printLine(int width);
 void printHeader(const char *title);
 int countDigits(int n);
 
+// --- Buffered Output ---
+// Text is composed in memory and written with a single write() per flush.
+// Between holdOutput()/releaseOutput() or beginFrame()/endFrame() flushes
+// are deferred, so a whole table or dashboard costs one syscall.
+void outPrintf(const char *fmt, ...);
+void outPuts(const char *text);
+void outRepeat(char c, int count);
+void outFlush();
+void holdOutput();
+void releaseOutput();
+void beginFrame();
+void endFrame();
+void setIncrementalRedraw(bool enabled);
+void *safeMalloc(size_t size);
+int availableCores();
+long long monotonicNanos(); // for measuring, not for display
+int lowestSetBit(uint64_t bits); // index of the least significant 1 bit; bits must be non-zero
+int highestSetBit(uint64_t bits); // index of the most significant 1 bit; bits must be non-zero
+
 #endif
\ No newline at end of file
@@ -0,0 +1,429 @@
+#include "virtual_memory.h"
+
+// ==========================================
+//      CONFIGURATION
+// ==========================================
+
+#define PTE_BYTES 8 // modelled size of one table entry, as on x86-64
+
+void defaultVmConfig(VmConfig *cfg)
+{
+    cfg->levels = 4;
+    cfg->bitsPerLevel = 9;
+    cfg->pageShift = 12;
+    cfg->tlbSets = 16;
+    cfg->tlbWays = 4; // 64 entries, the size of a typical L1 data TLB
+    cfg->memoryBytes = 64LL << 20;
+    cfg->policy = PAGE_LRU;
+    cfg->hugePages = false;
+}
+
+bool validateVmConfig(const VmConfig *cfg, char *error, size_t errorSize)
+{
+    if (cfg->levels < VM_MIN_LEVELS || cfg->levels > VM_MAX_LEVELS)
+        snprintf(error, errorSize, "page table levels must be %d to %d", VM_MIN_LEVELS, VM_MAX_LEVELS);
+    else if (cfg->bitsPerLevel < 1 || cfg->bitsPerLevel > 16)
+        snprintf(error, errorSize, "index bits per level must be 1 to 16");
+    else if (cfg->pageShift < 0 || cfg->pageShift + cfg->levels * cfg->bitsPerLevel > 63)
+        snprintf(error, errorSize, "virtual addresses would be wider than 63 bits");
+    else if (cfg->tlbSets < 1 || cfg->tlbWays < 1 || cfg->tlbWays > VM_MAX_TLB_WAYS)
+        snprintf(error, errorSize, "the TLB needs at least one set and 1 to %d ways", VM_MAX_TLB_WAYS);
+    else if (cfg->policy < PAGE_FIFO || cfg->policy > PAGE_POLICY_COUNT || cfg->policy == PAGE_OPT)
+        snprintf(error, errorSize, "choose a replacement policy other than Optimal");
+    else
+    {
+        int shift = cfg->pageShift + (cfg->hugePages ? cfg->bitsPerLevel : 0);
+        long long frames = cfg->memoryBytes >> shift;
+        if (cfg->memoryBytes < 1 || frames < 1 || frames > INT_MAX)
+            snprintf(error, errorSize, "physical memory must hold 1 to %d pages of %lld bytes", INT_MAX, 1LL << shift);
+        else
+            return true;
+    }
+    return false;
+}
+
+// ==========================================
+//      PAGE TABLE
+// ==========================================
+
+static int newTableNode(VirtualMemory *vm)
+{
+    int bits = vm->cfg.bitsPerLevel;
+    if (vm->nodes == vm->nodeCapacity)
+    {
+        int cap = vm->nodeCapacity * 2;
+        int *grown = realloc(vm->entries, ((size_t)cap << bits) * sizeof(int));
+        if (grown == NULL)
+        {
+            printf(RED "\nFatal: out of memory in page table\n" RESET);
+            exit(EXIT_FAILURE);
+        }
+        vm->entries = grown;
+        vm->nodeCapacity = cap;
+    }
+    memset(vm->entries + ((size_t)vm->nodes << bits), 0xff, ((size_t)1 << bits) * sizeof(int));
+    return vm->nodes++;
+}
+
+// Index of the page's leaf entry; -1 if an upper table is missing and `create` is off
+static long long walkPageTable(VirtualMemory *vm, long long page, bool create, int index[])
+{
+    int bits = vm->cfg.bitsPerLevel;
+    long long mask = (1LL << bits) - 1, node = 0;
+    for (int level = 0; level < vm->depth; level++)
+    {
+        long long i = (page >> ((vm->depth - 1 - level) * bits)) & mask;
+        if (index != NULL)
+            index[level] = (int)i;
+        long long slot = (node << bits) + i;
+        if (level == vm->depth - 1)
+            return slot;
+        if (vm->entries[slot] < 0)
+        {
+            if (!create)
+                return -1;
+            int child = newTableNode(vm); // may move `entries`; slot indices stay valid
+            vm->entries[slot] = child;
+        }
+        node = vm->entries[slot];
+    }
+    return -1;
+}
+
+size_t pageTableBytes(const VirtualMemory *vm)
+{
+    return ((size_t)vm->nodes << vm->cfg.bitsPerLevel) * PTE_BYTES;
+}
+
+// ==========================================
+//      TLB
+// ==========================================
+
+static int tlbLookup(VirtualMemory *vm, long long page)
+{
+    size_t base = (size_t)((unsigned long long)page % (unsigned)vm->cfg.tlbSets) * vm->cfg.tlbWays;
+    for (int w = 0; w < vm->cfg.tlbWays; w++)
+        if (vm->tlbStamp[base + w] != 0 && vm->tlbPage[base + w] == page)
+        {
+            vm->tlbStamp[base + w] = ++vm->clock;
+            return vm->tlbFrame[base + w];
+        }
+    return -1;
+}
+
+static void tlbInsert(VirtualMemory *vm, long long page, int frame)
+{
+    size_t base = (size_t)((unsigned long long)page % (unsigned)vm->cfg.tlbSets) * vm->cfg.tlbWays;
+    size_t victim = base;
+    for (int w = 0; w < vm->cfg.tlbWays; w++)
+        if (vm->tlbStamp[base + w] < vm->tlbStamp[victim]) // an invalid way (stamp 0) always wins
+            victim = base + w;
+    vm->tlbPage[victim] = page;
+    vm->tlbFrame[victim] = frame;
+    vm->tlbStamp[victim] = ++vm->clock;
+}
+
+static void tlbInvalidate(VirtualMemory *vm, long long page)
+{
+    size_t base = (size_t)((unsigned long long)page % (unsigned)vm->cfg.tlbSets) * vm->cfg.tlbWays;
+    for (int w = 0; w < vm->cfg.tlbWays; w++)
+        if (vm->tlbStamp[base + w] != 0 && vm->tlbPage[base + w] == page)
+        {
+            vm->tlbStamp[base + w] = 0;
+            vm->stats.shootdowns++;
+        }
+}
+
+// ==========================================
+//      TRANSLATION
+// ==========================================
+
+bool createVirtualMemory(VirtualMemory *vm, const VmConfig *cfg, char *error, size_t errorSize)
+{
+    if (!validateVmConfig(cfg, error, errorSize))
+        return false;
+    memset(vm, 0, sizeof(*vm));
+    vm->cfg = *cfg;
+    vm->shift = cfg->pageShift + (cfg->hugePages ? cfg->bitsPerLevel : 0);
+    vm->depth = cfg->levels - (cfg->hugePages ? 1 : 0);
+    vm->frames = cfg->memoryBytes >> vm->shift;
+    createPageReplacer(cfg->policy, (int)vm->frames, NULL, 0, &vm->replacer);
+
+    vm->nodeCapacity = 16;
+    vm->entries = safeMalloc(((size_t)vm->nodeCapacity << cfg->bitsPerLevel) * sizeof(int));
+    newTableNode(vm); // the root
+
+    size_t slots = (size_t)cfg->tlbSets * cfg->tlbWays;
+    vm->tlbPage = safeMalloc(slots * sizeof(long long));
+    vm->tlbFrame = safeMalloc(slots * sizeof(int));
+    vm->tlbStamp = calloc(slots, sizeof(long long));
+    if (vm->tlbStamp == NULL)
+    {
+        printf(RED "\nFatal: out of memory for the TLB\n" RESET);
+        exit(EXIT_FAILURE);
+    }
+    return true;
+}
+
+void freeVirtualMemory(VirtualMemory *vm)
+{
+    destroyPageReplacer(&vm->replacer);
+    free(vm->entries);
+    free(vm->tlbPage);
+    free(vm->tlbFrame);
+    free(vm->tlbStamp);
+    vm->entries = NULL;
+    vm->tlbPage = vm->tlbStamp = NULL;
+    vm->tlbFrame = NULL;
+}
+
+uint64_t translateAddress(VirtualMemory *vm, uint64_t va, VmTrace *step)
+{
+    int vaBits = vm->cfg.pageShift + vm->cfg.levels * vm->cfg.bitsPerLevel;
+    va &= (1ULL << vaBits) - 1;
+    long long page = (long long)(va >> vm->shift), evicted = -1;
+    uint64_t offset = va & ((1ULL << vm->shift) - 1);
+    vm->stats.translations++;
+
+    // Every reference goes to the policy, TLB hit or not, so its recency and frequency stay true
+    bool resident = pageAccess(&vm->replacer, page, &evicted);
+    int frame = tlbLookup(vm, page);
+    bool tlbHit = (frame >= 0), fault = false;
+    if (tlbHit)
+        vm->stats.tlbHits++;
+    else
+    {
+        if (!resident && evicted >= 0)
+        {
+            // The victim's frame is reused; its mapping and any cached translation go
+            long long victim = walkPageTable(vm, evicted, false, NULL);
+            frame = vm->entries[victim];
+            vm->entries[victim] = -1;
+            tlbInvalidate(vm, evicted);
+            vm->stats.evictions++;
+        }
+        long long pte = walkPageTable(vm, page, true, step ? step->index : NULL);
+        vm->stats.walks++;
+        vm->stats.walkSteps += vm->depth;
+        if (vm->entries[pte] < 0)
+        {
+            fault = true;
+            vm->stats.faults++;
+            if (frame < 0)
+                frame = (int)vm->usedFrames++;
+            vm->entries[pte] = frame;
+        }
+        frame = vm->entries[pte];
+        tlbInsert(vm, page, frame);
+    }
+
+    if (step != NULL)
+    {
+        step->page = page;
+        step->tlbHit = tlbHit;
+        step->fault = fault;
+        step->evicted = fault ? evicted : -1;
+        step->frame = frame;
+        if (tlbHit)
+            walkPageTable(vm, page, false, step->index);
+    }
+    return ((uint64_t)frame << vm->shift) | offset;
+}
+
+bool replayVmTrace(const char *path, bool instructions, const VmConfig cfgs[], int count, VmStats stats[],
+                   size_t tableBytes[], char *error, size_t errorSize)
+{
+    for (int i = 0; i < count; i++)
+        if (!validateVmConfig(&cfgs[i], error, errorSize))
+            return false;
+    PageTrace t;
+    if (!openPageTrace(&t, path, 1, instructions)) // page size 1: whole addresses
+    {
+        snprintf(error, errorSize, "cannot open %s", path ? path : "stdin");
+        return false;
+    }
+
+    VirtualMemory *vms = safeMalloc((count > 0 ? count : 1) * sizeof(VirtualMemory));
+    for (int i = 0; i < count; i++)
+        createVirtualMemory(&vms[i], &cfgs[i], error, errorSize);
+
+    long long *chunk = safeMalloc(PAGE_TRACE_CHUNK * sizeof(long long));
+    int n;
+    while ((n = readPageTrace(&t, chunk, PAGE_TRACE_CHUNK)) > 0)
+        for (int i = 0; i < count; i++)
+        {
+            long long start = monotonicNanos();
+            for (int k = 0; k < n; k++)
+                translateAddress(&vms[i], (uint64_t)chunk[k], NULL);
+            vms[i].stats.elapsedNs += monotonicNanos() - start;
+        }
+    free(chunk);
+
+    for (int i = 0; i < count; i++)
+    {
+        stats[i] = vms[i].stats;
+        tableBytes[i] = pageTableBytes(&vms[i]);
+        freeVirtualMemory(&vms[i]);
+    }
+    free(vms);
+    bool ok = (t.error[0] == '\0');
+    if (!ok)
+        snprintf(error, errorSize, "%s", t.error);
+    closePageTrace(&t);
+    return ok;
+}
+
+// ==========================================
+//      INTERACTIVE FRONT END
+// ==========================================
+
+static void formatSize(long long bytes, char *out, size_t size)
+{
+    if (bytes >= (1LL << 30) && bytes % (1LL << 30) == 0)
+        snprintf(out, size, "%lld GiB", bytes >> 30);
+    else if (bytes >= (1LL << 20) && bytes % (1LL << 20) == 0)
+        snprintf(out, size, "%lld MiB", bytes >> 20);
+    else if (bytes >= 1024 && bytes % 1024 == 0)
+        snprintf(out, size, "%lld KiB", bytes >> 10);
+    else
+        snprintf(out, size, "%lld B", bytes);
+}
+
+static void printVmStats(const VmConfig cfgs[], const VmStats stats[], const size_t tableBytes[], int count)
+{
+    printHeader("ADDRESS TRANSLATION RESULTS");
+    printf(CYAN "| %-8s | %-9s | %-8s | %-9s | %-12s | %-10s | %-10s |\n" RESET, "Pages", "Policy", "TLB Hit",
+           "Avg Walk", "Faults", "Mtrans/s", "PT Memory");
+    printLine(87);
+    for (int i = 0; i < count; i++)
+    {
+        const VmStats *s = &stats[i];
+        char page[24], table[24];
+        formatSize(1LL << (cfgs[i].pageShift + (cfgs[i].hugePages ? cfgs[i].bitsPerLevel : 0)), page,
+                   sizeof(page));
+        formatSize((long long)tableBytes[i], table, sizeof(table));
+        printf("| %-8s | %-9s | %7.2f%% | %-9.2f | %-12lld | %-10.1f | %-10s |\n", page, pagePolicyName(cfgs[i].policy),
+               s->translations ? 100.0 * s->tlbHits / s->translations : 0.0,
+               s->walks ? (double)s->walkSteps / s->walks : 0.0, s->faults,
+               s->elapsedNs ? 1e3 * s->translations / s->elapsedNs : 0.0, table);
+    }
+    printLine(87);
+}
+
+static void runTypedAddresses(const VmConfig *cfg)
+{
+    printf("Address count: ");
+    int n = getSafeInt();
+    if (n < 1)
+        return;
+    int *va = safeMalloc((size_t)n * sizeof(int));
+    printf("Addresses (decimal): ");
+    for (int i = 0; i < n; i++)
+        va[i] = getSafeInt();
+
+    VirtualMemory vm;
+    char error[160];
+    createVirtualMemory(&vm, cfg, error, sizeof(error));
+    printHeader("TRANSLATION STEPS");
+    printf(CYAN "| %-12s | %-10s | %-15s | %-4s | %-22s | %-12s |\n" RESET, "Virtual", "Page", "Indices", "TLB",
+           "Page Table", "Physical");
+    printLine(95);
+    for (int i = 0; i < n; i++)
+    {
+        VmTrace step;
+        long long start = monotonicNanos();
+        uint64_t pa = translateAddress(&vm, (uint64_t)(unsigned)va[i], &step);
+        vm.stats.elapsedNs += monotonicNanos() - start;
+        char indices[32] = "", walk[40];
+        for (int level = 0, used = 0; level < vm.depth; level++)
+            used += snprintf(indices + used, sizeof(indices) - used, level ? ".%d" : "%d", step.index[level]);
+        if (step.tlbHit)
+            snprintf(walk, sizeof(walk), "-");
+        else if (!step.fault)
+            snprintf(walk, sizeof(walk), "%d-level walk", vm.depth);
+        else if (step.evicted >= 0)
+            snprintf(walk, sizeof(walk), "FAULT, evict page %lld", step.evicted);
+        else
+            snprintf(walk, sizeof(walk), "FAULT, free frame");
+        printf("| %-12d | %-10lld | %-15s | %s%-4s" RESET " | %s%-22s" RESET " | %-12llu |\n", va[i], step.page,
+               indices, step.tlbHit ? GREEN : RED, step.tlbHit ? "HIT" : "MISS", step.fault ? YELLOW : "", walk,
+               (unsigned long long)pa);
+        if (n <= MAX_REQ)
+            SLEEP_MS(400);
+    }
+    printLine(95);
+
+    size_t table = pageTableBytes(&vm);
+    printVmStats(cfg, &vm.stats, &table, 1);
+    printf(YELLOW "%lld evictions, %lld TLB entries shot down with their pages.\n" RESET, vm.stats.evictions,
+           vm.stats.shootdowns);
+    freeVirtualMemory(&vm);
+    free(va);
+}
+
+static void runTraceAddresses(const VmConfig *cfg)
+{
+    char path[256];
+    readPath("Trace file (lackey/addresses text, or binary): ", path, sizeof(path));
+    printf("Include instruction fetches? (1=Yes, 0=No): ");
+    bool instructions = getSafeInt() != 0;
+
+    // The same memory mapped with base and with huge pages, to show TLB reach
+    VmConfig cfgs[2] = {*cfg, *cfg};
+    cfgs[0].hugePages = false;
+    cfgs[1].hugePages = true;
+    char error[160];
+    int count = validateVmConfig(&cfgs[1], error, sizeof(error)) ? 2 : 1;
+    VmStats stats[2];
+    size_t tables[2];
+    if (!replayVmTrace(path, instructions, cfgs, count, stats, tables, error, sizeof(error)))
+    {
+        printf(RED "Cannot replay: %s\n" RESET, error);
+        return;
+    }
+    printVmStats(cfgs, stats, tables, count);
+    printf(YELLOW "%lld translations; each TLB entry of a huge page covers %d base pages.\n" RESET,
+           stats[0].translations, 1 << cfg->bitsPerLevel);
+}
+
+void runVirtualMemory()
+{
+    VmConfig cfg;
+    defaultVmConfig(&cfg);
+    printHeader("VIRTUAL MEMORY: ADDRESS TRANSLATION");
+    printf("Page table levels (%d-%d): ", VM_MIN_LEVELS, VM_MAX_LEVELS);
+    cfg.levels = getSafeInt();
+    printf("Index bits per level (e.g. 9): ");
+    cfg.bitsPerLevel = getSafeInt();
+    printf("Page size in bytes (power of two, e.g. 4096): ");
+    int pageSize = getSafeInt();
+    cfg.pageShift = (pageSize > 0 && (pageSize & (pageSize - 1)) == 0) ? lowestSetBit((uint64_t)pageSize) : -1;
+    printf("TLB sets: ");
+    cfg.tlbSets = getSafeInt();
+    printf("TLB ways: ");
+    cfg.tlbWays = getSafeInt();
+    printf("Physical frames (base pages): ");
+    int frames = getSafeInt();
+    cfg.memoryBytes = (frames > 0 && cfg.pageShift >= 0) ? (long long)frames << cfg.pageShift : 0;
+    printf("Replacement policy (1.FIFO 2.LRU 3.LFU 4.Clock 6.ARC 7.2Q 8.CLOCK-Pro): ");
+    cfg.policy = (PagePolicy)getSafeInt();
+    printf("Map with huge pages (2^bits base pages each)? (1=Yes, 0=No): ");
+    cfg.hugePages = getSafeInt() == 1;
+
+    char error[160];
+    if (cfg.pageShift < 0)
+        snprintf(error, sizeof(error), "page size must be a power of two");
+    if (cfg.pageShift < 0 || !validateVmConfig(&cfg, error, sizeof(error)))
+    {
+        printf(RED "Invalid configuration: %s.\n" RESET, error);
+        waitForStudent();
+        return;
+    }
+
+    printf("Input (1. Type addresses  2. Replay a trace file): ");
+    if (getSafeInt() == 2)
+        runTraceAddresses(&cfg);
+    else
+        runTypedAddresses(&cfg);
+    waitForStudent();
+}
@@ -0,0 +1,97 @@
+#ifndef VIRTUAL_MEMORY_H
+#define VIRTUAL_MEMORY_H
+
+#include "page_trace.h"
+
+// --- Constants ---
+#define VM_MIN_LEVELS 2
+#define VM_MAX_LEVELS 4
+#define VM_MAX_TLB_WAYS 64
+
+// --- Structures ---
+/**
+ * A virtual address is `levels` table indices of `bitsPerLevel` bits over
+ * a page offset of `pageShift` bits (4 x 9 + 12 = x86-64's 48 bits). Huge
+ * pages map one whole last-level table at once, so they end the walk a
+ * level early and each TLB entry covers 2^bitsPerLevel times more memory.
+ */
+typedef struct
+{
+    int levels;
+    int bitsPerLevel;
+    int pageShift;
+    int tlbSets, tlbWays;
+    long long memoryBytes; // physical memory; frames = memoryBytes / page size
+    PagePolicy policy;     // who picks the victim on a page fault (not OPT: the future is unknown)
+    bool hugePages;
+} VmConfig;
+
+typedef struct
+{
+    long long translations;
+    long long tlbHits;
+    long long walks, walkSteps; // table levels read on TLB misses
+    long long faults, evictions;
+    long long shootdowns; // TLB entries dropped because their page was evicted
+    long long elapsedNs;
+} VmStats;
+
+typedef struct
+{
+    VmConfig cfg;
+    int shift;   // offset bits of the pages actually mapped (base or huge)
+    int depth;   // levels walked to reach a mapping
+    long long frames, usedFrames;
+
+    // Radix page table: node n owns entries [n << bits, (n + 1) << bits)
+    int *entries; // -1 empty; child node index above the leaf level; frame at it
+    int nodes, nodeCapacity;
+
+    // Set-associative TLB, LRU by last-use stamp within a set
+    long long *tlbPage;
+    int *tlbFrame;
+    long long *tlbStamp; // 0 = invalid
+    long long clock;
+
+    PageReplacer replacer; // tracks residency in page numbers of the mapped size
+    VmStats stats;
+} VirtualMemory;
+
+// Step-by-step account of one translation, for display
+typedef struct
+{
+    long long page;
+    int index[VM_MAX_LEVELS];
+    bool tlbHit, fault;
+    long long evicted; // page that lost its frame, -1 if none
+    int frame;
+} VmTrace;
+
+// --- Function Prototypes ---
+void defaultVmConfig(VmConfig *cfg);
+bool validateVmConfig(const VmConfig *cfg, char *error, size_t errorSize);
+
+bool createVirtualMemory(VirtualMemory *vm, const VmConfig *cfg, char *error, size_t errorSize);
+void freeVirtualMemory(VirtualMemory *vm);
+
+/**
+ * Translates one virtual address (bits above the address width are
+ * ignored) and returns the physical address. A missing mapping is a page
+ * fault: the replacement policy picks a victim whose frame is reused, and
+ * the victim's PTE and TLB entry are cleared. `step` may be NULL.
+ */
+uint64_t translateAddress(VirtualMemory *vm, uint64_t va, VmTrace *step);
+
+size_t pageTableBytes(const VirtualMemory *vm);
+
+/**
+ * Streams an address trace (the formats of page_trace.h) once through
+ * `count` configurations side by side. Returns false with `error` filled.
+ */
+bool replayVmTrace(const char *path, bool instructions, const VmConfig cfgs[], int count, VmStats stats[],
+                   size_t tableBytes[], char *error, size_t errorSize);
+
+// Interactive front end: typed addresses step by step, or a trace file
+void runVirtualMemory();
+
+#endif
@@ -0,0 +1,374 @@
+#include "workload_gen.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+// ==========================================
+//      SYNTHETIC WORKLOAD GENERATOR
+// ==========================================
+
+#define WORKLOAD_MAGIC "OSWL"
+#define WORKLOAD_VERSION 1u
+#define WORKLOAD_CHUNK 65536
+#define TIME_AXIS_HALF (INT_MAX / 2) // arrivals and the sum of all bursts each stay below this
+
+// On-disk layout: header followed by `count` packed records
+typedef struct
+{
+    char magic[4];
+    uint32_t version;
+    uint64_t count;
+} WorkloadHeader;
+
+typedef struct
+{
+    int32_t at, bt, pr;
+} WorkloadRecord;
+
+// ==========================================
+//      RANDOM NUMBERS
+// ==========================================
+
+void rngSeed(Rng *rng, uint64_t seed)
+{
+    rng->state = seed;
+}
+
+uint64_t rngNext(Rng *rng)
+{
+    uint64_t z = (rng->state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+double rngUniform(Rng *rng)
+{
+    // 53 random bits, shifted into (0, 1] so log() never sees zero
+    return ((rngNext(rng) >> 11) + 1) * (1.0 / 9007199254740992.0);
+}
+
+double rngExponential(Rng *rng, double mean)
+{
+    return -mean * log(rngUniform(rng));
+}
+
+// Pareto with the given mean: scale x_m = mean * (alpha - 1) / alpha
+double rngPareto(Rng *rng, double mean, double alpha)
+{
+    double scale = mean * (alpha - 1.0) / alpha;
+    return scale / pow(rngUniform(rng), 1.0 / alpha);
+}
+
+void initZipf(ZipfSampler *z, int levels, double exponent)
+{
+    z->levels = levels;
+    z->cdf = safeMalloc(levels * sizeof(double));
+    double total = 0;
+    for (int k = 0; k < levels; k++)
+    {
+        total += 1.0 / pow(k + 1, exponent);
+        z->cdf[k] = total;
+    }
+    for (int k = 0; k < levels; k++)
+        z->cdf[k] /= total;
+}
+
+int sampleZipf(ZipfSampler *z, Rng *rng)
+{
+    double u = rngUniform(rng);
+    int lo = 0, hi = z->levels - 1;
+    while (lo < hi)
+    {
+        int mid = (lo + hi) / 2;
+        if (z->cdf[mid] < u)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+void freeZipf(ZipfSampler *z)
+{
+    free(z->cdf);
+    z->cdf = NULL;
+}
+
+// ==========================================
+//      GENERATION
+// ==========================================
+
+void defaultWorkloadConfig(WorkloadConfig *cfg)
+{
+    cfg->count = 1000;
+    cfg->seed = 42;
+    cfg->meanInterarrival = 5.0;
+    cfg->burstDist = BURST_EXPONENTIAL;
+    cfg->meanBurst = 4.0;
+    cfg->paretoAlpha = 1.5;
+    cfg->priorityDist = PRIORITY_UNIFORM;
+    cfg->priorityLevels = 8;
+    cfg->zipfExponent = 1.0;
+}
+
+bool validateWorkloadConfig(const WorkloadConfig *cfg, char *error, size_t errorSize)
+{
+    const char *problem = NULL;
+    if (cfg->count <= 0 || cfg->count > INT_MAX)
+        problem = "process count must be between 1 and INT_MAX";
+    else if (cfg->meanInterarrival < 0 || cfg->meanBurst <= 0)
+        problem = "mean inter-arrival must be >= 0 and mean burst > 0";
+    else if (cfg->meanInterarrival * cfg->count > TIME_AXIS_HALF / 2)
+        problem = "count x mean inter-arrival would overflow the int time axis";
+    else if (cfg->meanBurst * cfg->count > TIME_AXIS_HALF / 32)
+        problem = "count x mean burst would overflow the int time axis";
+    else if (cfg->burstDist == BURST_PARETO && cfg->paretoAlpha <= 1.0)
+        problem = "Pareto alpha must be > 1 for a finite mean";
+    else if (cfg->priorityLevels < 1)
+        problem = "need at least one priority level";
+
+    if (problem != NULL)
+        snprintf(error, errorSize, "%s", problem);
+    return problem == NULL;
+}
+
+// Generation state shared by the in-memory and streaming paths
+typedef struct
+{
+    const WorkloadConfig *cfg;
+    Rng rng;
+    ZipfSampler zipf;
+    double clock;
+    double burstCap; // TIME_AXIS_HALF / count: even all-capped bursts cannot overflow a schedule
+} WorkloadStream;
+
+static void openStream(WorkloadStream *ws, const WorkloadConfig *cfg)
+{
+    ws->cfg = cfg;
+    rngSeed(&ws->rng, cfg->seed);
+    ws->clock = 0;
+    ws->burstCap = (double)(TIME_AXIS_HALF / cfg->count);
+    ws->zipf.cdf = NULL;
+    if (cfg->priorityDist == PRIORITY_ZIPF)
+        initZipf(&ws->zipf, cfg->priorityLevels, cfg->zipfExponent);
+}
+
+static WorkloadRecord nextRecord(WorkloadStream *ws)
+{
+    const WorkloadConfig *cfg = ws->cfg;
+    WorkloadRecord r;
+
+    r.at = (int32_t)ws->clock;
+    ws->clock += rngExponential(&ws->rng, cfg->meanInterarrival);
+    if (ws->clock > TIME_AXIS_HALF)
+        ws->clock = TIME_AXIS_HALF; // a freak run of long gaps: later arrivals bunch at the end
+
+    double burst = (cfg->burstDist == BURST_PARETO)
+                       ? rngPareto(&ws->rng, cfg->meanBurst, cfg->paretoAlpha)
+                       : rngExponential(&ws->rng, cfg->meanBurst);
+    if (burst > ws->burstCap)
+        burst = ws->burstCap; // heavy tails must still fit in an int schedule
+    r.bt = (burst < 1.0) ? 1 : (int32_t)(burst + 0.5);
+
+    if (cfg->priorityDist == PRIORITY_ZIPF)
+        r.pr = sampleZipf(&ws->zipf, &ws->rng);
+    else
+        r.pr = (int32_t)(rngNext(&ws->rng) % (uint64_t)cfg->priorityLevels);
+    return r;
+}
+
+static void closeStream(WorkloadStream *ws)
+{
+    if (ws->zipf.cdf != NULL)
+        freeZipf(&ws->zipf);
+}
+
+Process *generateWorkload(const WorkloadConfig *cfg)
+{
+    Process *p = safeMalloc(cfg->count * sizeof(Process));
+    WorkloadStream ws;
+    openStream(&ws, cfg);
+    for (long i = 0; i < cfg->count; i++)
+    {
+        WorkloadRecord r = nextRecord(&ws);
+        p[i].id = (int)i + 1;
+        p[i].at = r.at;
+        p[i].bt = r.bt;
+        p[i].pr = r.pr;
+        p[i].rem_bt = r.bt;
+        p[i].ct = p[i].tat = p[i].wt = 0;
+    }
+    closeStream(&ws);
+    return p;
+}
+
+bool saveWorkload(const char *path, const WorkloadConfig *cfg)
+{
+    FILE *fp = fopen(path, "wb");
+    if (fp == NULL)
+        return false;
+
+    WorkloadHeader header;
+    memcpy(header.magic, WORKLOAD_MAGIC, 4);
+    header.version = WORKLOAD_VERSION;
+    header.count = (uint64_t)cfg->count;
+    bool ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+
+    WorkloadRecord *chunk = safeMalloc(WORKLOAD_CHUNK * sizeof(WorkloadRecord));
+    WorkloadStream ws;
+    openStream(&ws, cfg);
+    for (long done = 0; ok && done < cfg->count;)
+    {
+        long batch = cfg->count - done;
+        if (batch > WORKLOAD_CHUNK)
+            batch = WORKLOAD_CHUNK;
+        for (long i = 0; i < batch; i++)
+            chunk[i] = nextRecord(&ws);
+        ok = fwrite(chunk, sizeof(WorkloadRecord), batch, fp) == (size_t)batch;
+        done += batch;
+    }
+    closeStream(&ws);
+    free(chunk);
+
+    if (fclose(fp) != 0)
+        ok = false;
+    return ok;
+}
+
+// ==========================================
+//      LOADING (MEMORY-MAPPED)
+// ==========================================
+
+static Process *expandRecords(const WorkloadHeader *header, const WorkloadRecord *records, int *count)
+{
+    Process *p = safeMalloc(header->count * sizeof(Process));
+    for (uint64_t i = 0; i < header->count; i++)
+    {
+        p[i].id = (int)i + 1;
+        p[i].at = records[i].at;
+        p[i].bt = records[i].bt;
+        p[i].pr = records[i].pr;
+        p[i].rem_bt = records[i].bt;
+        p[i].ct = p[i].tat = p[i].wt = 0;
+    }
+    *count = (int)header->count;
+    return p;
+}
+
+static bool headerValid(const WorkloadHeader *header, uint64_t fileSize)
+{
+    return memcmp(header->magic, WORKLOAD_MAGIC, 4) == 0 && header->version == WORKLOAD_VERSION &&
+           header->count > 0 && header->count <= INT_MAX &&
+           fileSize == sizeof(WorkloadHeader) + header->count * sizeof(WorkloadRecord);
+}
+
+Process *loadWorkload(const char *path, int *count)
+{
+#ifdef _WIN32
+    // No mmap here: read the header and records with stdio instead
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL)
+        return NULL;
+    WorkloadHeader header;
+    fseek(fp, 0, SEEK_END);
+    uint64_t size = (uint64_t)ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    Process *p = NULL;
+    if (fread(&header, sizeof(header), 1, fp) == 1 && headerValid(&header, size))
+    {
+        WorkloadRecord *records = safeMalloc(header.count * sizeof(WorkloadRecord));
+        if (fread(records, sizeof(WorkloadRecord), header.count, fp) == header.count)
+            p = expandRecords(&header, records, count);
+        free(records);
+    }
+    fclose(fp);
+    return p;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return NULL;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(WorkloadHeader))
+    {
+        close(fd);
+        return NULL;
+    }
+
+    void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+        return NULL;
+    madvise(map, st.st_size, MADV_SEQUENTIAL);
+
+    const WorkloadHeader *header = map;
+    Process *p = NULL;
+    if (headerValid(header, (uint64_t)st.st_size))
+        p = expandRecords(header, (const WorkloadRecord *)(header + 1), count);
+    munmap(map, st.st_size);
+    return p;
+#endif
+}
+
+// ==========================================
+//      INTERACTIVE FRONT ENDS
+// ==========================================
+
+Process *promptGeneratedWorkload(int *count)
+{
+    WorkloadConfig cfg;
+    defaultWorkloadConfig(&cfg);
+
+    printHeader("SYNTHETIC WORKLOAD GENERATOR");
+    printf("Number of processes: ");
+    cfg.count = getSafeInt();
+    printf("Random seed: ");
+    cfg.seed = (uint64_t)getSafeInt();
+    printf("Mean inter-arrival time (Poisson arrivals): ");
+    cfg.meanInterarrival = getSafeInt();
+    printf("Burst distribution (1. Exponential  2. Pareto heavy-tail): ");
+    cfg.burstDist = (getSafeInt() == 2) ? BURST_PARETO : BURST_EXPONENTIAL;
+    printf("Mean burst time: ");
+    cfg.meanBurst = getSafeInt();
+    printf("Priority levels: ");
+    cfg.priorityLevels = getSafeInt();
+    printf("Priority distribution (1. Uniform  2. Zipf): ");
+    cfg.priorityDist = (getSafeInt() == 2) ? PRIORITY_ZIPF : PRIORITY_UNIFORM;
+
+    char error[128];
+    if (!validateWorkloadConfig(&cfg, error, sizeof(error)))
+    {
+        printf(RED "Cannot generate: %s\n" RESET, error);
+        return NULL;
+    }
+
+    printf("Save to a binary file as well? (1=Yes, 0=No): ");
+    if (getSafeInt())
+    {
+        char path[256];
+        readPath("File name: ", path, sizeof(path));
+        if (saveWorkload(path, &cfg))
+            printf(GREEN "Saved %ld processes to %s\n" RESET, cfg.count, path);
+        else
+            printf(RED "Could not write %s\n" RESET, path);
+    }
+
+    *count = (int)cfg.count;
+    printf(GREEN "Generated %d processes.\n" RESET, *count);
+    return generateWorkload(&cfg);
+}
+
+Process *promptLoadWorkload(int *count)
+{
+    char path[256];
+    readPath("Workload file: ", path, sizeof(path));
+    Process *p = loadWorkload(path, count);
+    if (p == NULL)
+        printf(RED "Could not load a workload from '%s'\n" RESET, path);
+    else
+        printf(GREEN "Loaded %d processes.\n" RESET, *count);
+    return p;
+}
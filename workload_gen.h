@@ -0,0 +1,83 @@
+#ifndef WORKLOAD_GEN_H
+#define WORKLOAD_GEN_H
+
+#include "cpu_scheduling.h"
+#include <stdint.h>
+
+// --- Random Numbers ---
+// splitmix64: tiny, fast and fully reproducible from a 64-bit seed
+typedef struct
+{
+    uint64_t state;
+} Rng;
+
+void rngSeed(Rng *rng, uint64_t seed);
+uint64_t rngNext(Rng *rng);
+double rngUniform(Rng *rng); // (0, 1]
+double rngExponential(Rng *rng, double mean);
+double rngPareto(Rng *rng, double mean, double alpha);
+
+// Zipf(s) over ranks 1..levels, sampled by binary search on a precomputed CDF
+typedef struct
+{
+    double *cdf;
+    int levels;
+} ZipfSampler;
+
+void initZipf(ZipfSampler *z, int levels, double exponent);
+int sampleZipf(ZipfSampler *z, Rng *rng); // returns 0..levels-1, 0 most likely
+void freeZipf(ZipfSampler *z);
+
+// --- Workload Description ---
+typedef enum
+{
+    BURST_EXPONENTIAL,
+    BURST_PARETO
+} BurstDistribution;
+
+typedef enum
+{
+    PRIORITY_UNIFORM,
+    PRIORITY_ZIPF
+} PriorityDistribution;
+
+typedef struct
+{
+    long count;
+    uint64_t seed;
+    double meanInterarrival; // Poisson arrivals: exponential gaps with this mean
+    BurstDistribution burstDist;
+    double meanBurst;
+    double paretoAlpha; // tail index for Pareto bursts (> 1)
+    PriorityDistribution priorityDist;
+    int priorityLevels; // priorities are 0..levels-1, lower is more important
+    double zipfExponent;
+} WorkloadConfig;
+
+// --- Function Prototypes ---
+void defaultWorkloadConfig(WorkloadConfig *cfg);
+bool validateWorkloadConfig(const WorkloadConfig *cfg, char *error, size_t errorSize);
+
+/**
+ * Generates cfg->count processes into a new heap array, already in arrival
+ * order (ids 1..count). Same config and seed always give the same workload.
+ */
+Process *generateWorkload(const WorkloadConfig *cfg);
+
+/**
+ * Streams a generated workload to a compact binary file (12 bytes per
+ * process) without holding it in memory. Returns false on I/O errors.
+ */
+bool saveWorkload(const char *path, const WorkloadConfig *cfg);
+
+/**
+ * Memory-maps a binary workload file and expands it into a new Process
+ * array. Returns NULL if the file is missing or malformed.
+ */
+Process *loadWorkload(const char *path, int *count);
+
+// Interactive front ends for the CPU scheduling setup screen
+Process *promptGeneratedWorkload(int *count);
+Process *promptLoadWorkload(int *count);
+
+#endif